@@ -14,6 +14,7 @@
 #include "ft2_wav_renderer.h"
 #include "ft2_tables.h"
 #include "ft2_structs.h"
+#include "ft2_sample_ed.h"
 #include "mixer/ft2_mix.h"
 #include "mixer/ft2_silence_mix.h"
 
@@ -27,6 +28,7 @@ static uint32_t oldAudioFreq, tickTimeLenInt;
 static uint64_t tickTimeLenFrac;
 static float fAudioNormalizeMul, fSqrtPanningTable[256+1];
 static voice_t voice[MAX_CHANNELS * 2];
+static const mixFunc *mixFuncs = mixFuncTab; // or mixFuncTabCompactSinc (if compact sinc LUTs are used)
 
 // globalized
 audio_t audio;
@@ -197,6 +199,9 @@ void audioSetInterpolationType(uint8_t interpolationType)
 
 	audio.sincInterpolation = false;
 
+	// the LUT layout is decided at startup (calcWindowedSincTables()), the mixing routines must match it
+	mixFuncs = sincTablesCompact ? mixFuncTabCompactSinc : mixFuncTab;
+
 	// set sinc LUT pointers
 	if (config.interpolation == INTERPOLATION_SINC8)
 	{
@@ -318,7 +323,16 @@ static void voiceTrigger(int32_t ch, sample_t *s, int32_t position)
 	if (loopLength < 1) // disable loop if loopLength is below 1
 		loopType = 0;
 
-	if (sample16Bit)
+	// use the float sample cache if available (only built if enabled, see fixSample())
+	const float *fData = getFloatSampleData(s);
+	const bool sampleFloat = (fData != NULL);
+	if (sampleFloat)
+	{
+		v->fBase = fData;
+		v->fRevBase = &v->fBase[loopStart + loopEnd]; // for pingpong loops
+		v->fLeftEdgeTaps = FLOAT_SMP_LEFT_EDGE_TAPS(fData) + MAX_LEFT_TAPS;
+	}
+	else if (sample16Bit)
 	{
 		v->base16 = (const int16_t *)s->dataPtr;
 		v->revBase16 = &v->base16[loopStart + loopEnd]; // for pingpong loops
@@ -347,7 +361,8 @@ static void voiceTrigger(int32_t ch, sample_t *s, int32_t position)
 		return;
 	}
 
-	v->mixFuncOffset = ((int32_t)sample16Bit * 15) + (audio.interpolationType * 3) + loopType;
+	const int32_t sampleType = sampleFloat ? 2 : (int32_t)sample16Bit; // 8-bit, 16-bit or float
+	v->mixFuncOffset = (sampleType * 15) + (audio.interpolationType * 3) + loopType;
 	v->active = true;
 }
 
@@ -479,11 +494,11 @@ static void doChannelMixing(int32_t bufferPosition, int32_t samplesToMix)
 			if (!volRampFlag && v->fCurrVolumeL == 0.0f && v->fCurrVolumeR == 0.0f)
 				silenceMixRoutine(v, samplesToMix);
 			else
-				mixFuncTab[((int32_t)volRampFlag * (3*5*2)) + v->mixFuncOffset](v, bufferPosition, samplesToMix);
+				mixFuncs[((int32_t)volRampFlag * (3*5*3)) + v->mixFuncOffset](v, bufferPosition, samplesToMix);
 		}
 
 		if (r->active) // volume ramp fadeout-voice
-			mixFuncTab[(3*5*2) + r->mixFuncOffset](r, bufferPosition, samplesToMix);
+			mixFuncs[(3*5*3) + r->mixFuncOffset](r, bufferPosition, samplesToMix);
 	}
 }
 
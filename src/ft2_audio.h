@@ -36,7 +36,7 @@ typedef struct audio_t
 	char *currInputDevice, *currOutputDevice, *lastWorkingAudioDeviceName;
 	char *inputDeviceNames[MAX_AUDIO_DEVICES], *outputDeviceNames[MAX_AUDIO_DEVICES];
 	volatile bool locked, resetSyncTickTimeFlag, volumeRampingFlag;
-	bool linearPeriodsFlag, rescanAudioDevicesSupported, sincInterpolation;
+	bool linearPeriodsFlag, rescanAudioDevicesSupported, sincInterpolation, floatSampleCache;
 	volatile uint8_t interpolationType;
 	int32_t inputDeviceNum, outputDeviceNum, lastWorkingAudioFreq, lastWorkingAudioBits;
 	uint32_t quickVolRampSamples, freq;
@@ -61,6 +61,7 @@ typedef struct
 {
 	const int8_t *base8, *revBase8;
 	const int16_t *base16, *revBase16;
+	const float *fBase, *fRevBase; // float sample cache (if enabled and available)
 	bool active, samplingBackwards, isFadeOutVoice, hasLooped;
 	uint8_t mixFuncOffset, panning, loopType, scopeVolume;
 	int32_t position, sampleEnd, loopStart, loopLength, oldPeriod;
@@ -70,6 +71,7 @@ typedef struct
 	// if (loopEnabled && hasLooped && samplingPos <= loopStart+MAX_LEFT_TAPS) readFixedTapsFromThisPointer();
 	const int8_t *leftEdgeTaps8;
 	const int16_t *leftEdgeTaps16;
+	const float *fLeftEdgeTaps;
 
 	const float *fSincLUT;
 	float fVolume, fCurrVolumeL, fCurrVolumeR, fVolumeLDelta, fVolumeRDelta, fTargetVolumeL, fTargetVolumeR;
@@ -0,0 +1,1354 @@
+// for finding memory leaks in debug mode with Visual Studio
+#if defined _DEBUG && defined _MSC_VER
+#include <crtdbg.h>
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h> // offsetof()
+#include <sys/types.h> // fseeko()
+#include <sys/stat.h>
+#include "ft2_header.h"
+#include "ft2_audio.h"
+#include "ft2_gui.h"
+#include "ft2_pattern_ed.h"
+#include "ft2_inst_ed.h"
+#include "ft2_sample_ed.h"
+#include "ft2_sysreqs.h"
+#include "ft2_module_loader.h"
+#include "ft2_module_saver.h"
+#include "ft2_autosave.h"
+#include "ft2_structs.h"
+
+#define JOURNAL_ID "FT2JRNL2"
+#define JOURNAL_BUFFER_SIZE (1024*1024)
+#define JOURNAL_COMPACT_MIN_SIZE (32*1024*1024) // and at least twice the size of the live records
+#define JOURNAL_COPY_CHUNK_SIZE 65536
+
+#ifdef _WIN32
+#define JOURNAL_FILENAME L"autosave.ftj"
+#define CONFIG_FILENAME L"FT2.CFG"
+#define TMP_FILE_EXT L".tmp"
+#define FSEEK64(a, b, c) _fseeki64(a, b, c)
+#define FTELL64(a) _ftelli64(a)
+#else
+#define JOURNAL_FILENAME "autosave.ftj"
+#define CONFIG_FILENAME "FT2.CFG"
+#define TMP_FILE_EXT ".tmp"
+#define FSEEK64(a, b, c) fseeko(a, (off_t)(b), c)
+#define FTELL64(a) (int64_t)ftello(a)
+#endif
+
+// index of the latest record of every song part
+#define KEY_SONG 0
+#define KEY_PATTERN(a) (1 + (a))
+#define KEY_INSTR(a) (1 + MAX_PATTERNS + ((a) - 1))
+#define KEY_SAMPLE(a, b) (1 + MAX_PATTERNS + MAX_INST + (((a) - 1) * MAX_SMP_PER_INST) + (b))
+#define NUM_KEYS (1 + MAX_PATTERNS + MAX_INST + (MAX_INST * MAX_SMP_PER_INST))
+
+enum
+{
+	REC_SONG = 1,
+	REC_PATTERN = 2,
+	REC_INSTR = 3, // instrument and sample headers
+	REC_SAMPLE = 4, // sample data (delta encoded)
+	REC_COMMIT = 5 // end of a checkpoint, records after the last one are ignored
+};
+
+#ifdef _MSC_VER
+#pragma pack(push)
+#pragma pack(1)
+#endif
+typedef struct journalHdr_t
+{
+	char ID[8];
+	uint32_t instrSize; // sizeof (instr_t), the instrument records are only valid for this build
+	int64_t baseFileSize, baseFileTime; // the journal is only valid if the base module wasn't changed since (-1 = no base module)
+	uint32_t baseNameBytes; // followed by the base module filename (UNICHAR, no terminator)
+}
+#ifdef __GNUC__
+__attribute__ ((packed))
+#endif
+journalHdr_t;
+
+typedef struct recordHdr_t
+{
+	uint8_t type, smpNum;
+	uint16_t num;
+	uint32_t length; // payload bytes
+}
+#ifdef __GNUC__
+__attribute__ ((packed))
+#endif
+recordHdr_t;
+
+typedef struct journalSong_t
+{
+	char name[20+1], instrName[1+MAX_INST][22+1];
+	uint8_t orders[MAX_ORDERS], linearPeriodsFlag;
+	uint16_t songLength, songLoopStart, BPM, speed;
+	int32_t numChannels;
+}
+#ifdef __GNUC__
+__attribute__ ((packed))
+#endif
+journalSong_t;
+
+typedef struct journalPattHdr_t
+{
+	uint16_t numRows;
+	uint8_t allocated; // followed by numRows*TRACK_WIDTH bytes of pattern data
+}
+#ifdef __GNUC__
+__attribute__ ((packed))
+#endif
+journalPattHdr_t;
+
+typedef struct journalSmpHdr_t
+{
+	int32_t length;
+	uint8_t sample16Bit; // followed by the delta encoded sample data
+}
+#ifdef __GNUC__
+__attribute__ ((packed))
+#endif
+journalSmpHdr_t;
+#ifdef _MSC_VER
+#pragma pack(pop)
+#endif
+
+typedef struct journalEntry_t
+{
+	int64_t offset;
+	uint32_t size; // record header + payload, 0 = no record
+} journalEntry_t;
+
+typedef struct autosaveJob_t
+{
+	saveSnapshot_t *snap;
+	bool songDirty, pattDirty[MAX_PATTERNS], instrDirty[1+MAX_INST], smpDirty[1+MAX_INST][MAX_SMP_PER_INST];
+} autosaveJob_t;
+
+typedef struct lazyInstall_t // the sample header fields set by the lazy loader
+{
+	int16_t insNum, smpNum;
+	uint8_t flags;
+	int32_t length, loopStart, loopLength;
+	uint32_t dataGeneration;
+} lazyInstall_t;
+
+// main thread
+static bool autosaveActive, journalContinues, jobRunning;
+static uint32_t lastCheckpointTicks;
+static saveSnapshot_t *checkpoint; // the song as of the last journaled checkpoint, without sample data (NULL = journal everything)
+static lazyInstall_t *lazyInstalls;
+static int32_t numLazyInstalls, maxLazyInstalls;
+static SDL_Thread *thread;
+static volatile bool saveFailed;
+
+// owned by the thread while a job is running
+static bool needsCompaction;
+static UNICHAR *journalFilenameU, *baseFilenameU;
+static int64_t baseFileSize = -1, baseFileTime = -1; // as of when the journal was written
+static FILE *fJournal;
+static int64_t journalSize, liveBytes;
+static journalEntry_t journalIndex[NUM_KEYS], tmpIndex[NUM_KEYS];
+static autosaveJob_t job;
+static volatile bool jobDone, jobResult, cancelJob;
+
+static UNICHAR *getJournalPathU(void) // kinda hackish (see getFullAudDevConfigPathU())
+{
+	if (editor.configFileLocationU == NULL)
+		return NULL;
+
+	const int32_t ft2ConfPathLen = (int32_t)UNICHAR_STRLEN(editor.configFileLocationU);
+	const int32_t ft2DotCfgStrLen = (int32_t)UNICHAR_STRLEN(CONFIG_FILENAME);
+
+	UNICHAR *filePathU = (UNICHAR *)malloc((ft2ConfPathLen + UNICHAR_STRLEN(JOURNAL_FILENAME) + 1) * sizeof (UNICHAR));
+	if (filePathU == NULL)
+		return NULL;
+
+	UNICHAR_STRCPY(filePathU, editor.configFileLocationU);
+	filePathU[ft2ConfPathLen-ft2DotCfgStrLen] = 0;
+	UNICHAR_STRCAT(filePathU, JOURNAL_FILENAME);
+
+	return filePathU;
+}
+
+static UNICHAR *getTmpJournalPathU(void)
+{
+	UNICHAR *filePathU = (UNICHAR *)malloc((UNICHAR_STRLEN(journalFilenameU) + 4 + 1) * sizeof (UNICHAR));
+	if (filePathU == NULL)
+		return NULL;
+
+	UNICHAR_STRCPY(filePathU, journalFilenameU);
+	UNICHAR_STRCAT(filePathU, TMP_FILE_EXT);
+
+	return filePathU;
+}
+
+static void setBaseFilename(UNICHAR *filenameU)
+{
+	if (baseFilenameU != NULL)
+	{
+		free(baseFilenameU);
+		baseFilenameU = NULL;
+	}
+
+	if (filenameU != NULL)
+		baseFilenameU = UNICHAR_STRDUP(filenameU); // NULL if out of memory (journal relative to an empty song)
+}
+
+static bool getFileStamp(const UNICHAR *pathU, int64_t *size, int64_t *mtime)
+{
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_wstat64(pathU, &st) != 0)
+		return false;
+#else
+	struct stat st;
+	if (stat(pathU, &st) != 0)
+		return false;
+#endif
+
+	*size = (int64_t)st.st_size;
+	*mtime = (int64_t)st.st_mtime;
+	return true;
+}
+
+static void getJournalSong(const saveSnapshot_t *snap, journalSong_t *js)
+{
+	memset(js, 0, sizeof (journalSong_t));
+
+	memcpy(js->name, snap->song.name, sizeof (js->name));
+	memcpy(js->instrName, snap->song.instrName, sizeof (js->instrName));
+	memcpy(js->orders, snap->song.orders, sizeof (js->orders));
+	js->linearPeriodsFlag = snap->linearPeriodsFlag;
+	js->songLength = snap->song.songLength;
+	js->songLoopStart = snap->song.songLoopStart;
+	js->BPM = snap->song.BPM;
+	js->speed = snap->song.speed;
+	js->numChannels = snap->song.numChannels;
+}
+
+// instrument with the sample headers only (no pointers, caches or interpolation tap fixes)
+static void getJournalInstr(const instr_t *ins, instr_t *dst)
+{
+	memcpy(dst, ins, sizeof (instr_t));
+
+	sample_t *s = dst->smp;
+	for (int32_t i = 0; i < MAX_SMP_PER_INST; i++, s++)
+	{
+		s->dataPtr = s->origDataPtr = NULL;
+		s->peakData = NULL;
+		s->peakDataLength = 0;
+		s->peakDataValid = false;
+		s->isFixed = false;
+		s->fixedPos = 0;
+		s->dataGeneration = 0;
+		memset(s->leftEdgeTapSamples8, 0, sizeof (s->leftEdgeTapSamples8));
+		memset(s->leftEdgeTapSamples16, 0, sizeof (s->leftEdgeTapSamples16));
+		memset(s->fixedSmp, 0, sizeof (s->fixedSmp));
+	}
+}
+
+static int32_t getRecordKey(const recordHdr_t *hdr) // -1 = illegal record
+{
+	switch (hdr->type)
+	{
+		case REC_SONG: return KEY_SONG;
+		case REC_PATTERN: return (hdr->num < MAX_PATTERNS) ? KEY_PATTERN(hdr->num) : -1;
+		case REC_INSTR: return (hdr->num >= 1 && hdr->num <= MAX_INST) ? KEY_INSTR(hdr->num) : -1;
+
+		case REC_SAMPLE:
+		{
+			if (hdr->num < 1 || hdr->num > MAX_INST || hdr->smpNum >= MAX_SMP_PER_INST)
+				return -1;
+
+			return KEY_SAMPLE(hdr->num, hdr->smpNum);
+		}
+
+		default: return -1;
+	}
+}
+
+/* ------------------------------------------------------------------------------------ */
+/*                           JOURNAL WRITING (AUTOSAVE THREAD)                          */
+/* ------------------------------------------------------------------------------------ */
+
+static bool writeJournalHeader(FILE *f)
+{
+	journalHdr_t hdr;
+
+	memcpy(hdr.ID, JOURNAL_ID, 8);
+	hdr.instrSize = sizeof (instr_t);
+	hdr.baseFileSize = hdr.baseFileTime = -1;
+	hdr.baseNameBytes = (baseFilenameU != NULL) ? (uint32_t)(UNICHAR_STRLEN(baseFilenameU) * sizeof (UNICHAR)) : 0;
+
+	int64_t fileSize, fileTime;
+	if (hdr.baseNameBytes > 0 && getFileStamp(baseFilenameU, &fileSize, &fileTime))
+	{
+		hdr.baseFileSize = fileSize;
+		hdr.baseFileTime = fileTime;
+	}
+
+	if (fwrite(&hdr, sizeof (hdr), 1, f) != 1)
+		return false;
+
+	if (hdr.baseNameBytes > 0 && fwrite(baseFilenameU, 1, hdr.baseNameBytes, f) != hdr.baseNameBytes)
+		return false;
+
+	journalSize = sizeof (hdr) + hdr.baseNameBytes;
+	return true;
+}
+
+static bool createJournal(void)
+{
+	fJournal = UNICHAR_FOPEN(journalFilenameU, "wb");
+	if (fJournal == NULL)
+		return false;
+
+	setvbuf(fJournal, NULL, _IOFBF, JOURNAL_BUFFER_SIZE);
+
+	memset(journalIndex, 0, sizeof (journalIndex));
+	liveBytes = 0;
+
+	return writeJournalHeader(fJournal);
+}
+
+static bool writeRecordHeader(uint8_t type, uint16_t num, uint8_t smpNum, uint32_t length)
+{
+	recordHdr_t hdr;
+
+	hdr.type = type;
+	hdr.smpNum = smpNum;
+	hdr.num = num;
+	hdr.length = length;
+
+	if (fwrite(&hdr, sizeof (hdr), 1, fJournal) != 1)
+		return false;
+
+	const int32_t key = getRecordKey(&hdr);
+	if (key >= 0)
+	{
+		tmpIndex[key].offset = journalSize;
+		tmpIndex[key].size = sizeof (hdr) + length;
+	}
+
+	journalSize += sizeof (hdr) + length;
+	return true;
+}
+
+static bool writeSongRecord(const saveSnapshot_t *snap)
+{
+	journalSong_t js;
+
+	getJournalSong(snap, &js);
+
+	if (!writeRecordHeader(REC_SONG, 0, 0, sizeof (js)))
+		return false;
+
+	return fwrite(&js, sizeof (js), 1, fJournal) == 1;
+}
+
+static bool writePatternRecord(const saveSnapshot_t *snap, int16_t pattNum)
+{
+	journalPattHdr_t ph;
+
+	const note_t *p = snap->pattern[pattNum];
+
+	ph.numRows = snap->patternNumRows[pattNum];
+	ph.allocated = (p != NULL);
+
+	const uint32_t dataLength = (p != NULL) ? (ph.numRows * TRACK_WIDTH) : 0;
+	if (!writeRecordHeader(REC_PATTERN, pattNum, 0, sizeof (ph) + dataLength))
+		return false;
+
+	if (fwrite(&ph, sizeof (ph), 1, fJournal) != 1)
+		return false;
+
+	return dataLength == 0 || fwrite(p, 1, dataLength, fJournal) == dataLength;
+}
+
+static bool writeInstrRecord(const saveSnapshot_t *snap, int16_t insNum)
+{
+	instr_t ins;
+
+	const uint8_t allocated = (snap->instr[insNum] != NULL);
+
+	if (!writeRecordHeader(REC_INSTR, insNum, 0, 1 + (allocated ? sizeof (instr_t) : 0)))
+		return false;
+
+	if (fwrite(&allocated, 1, 1, fJournal) != 1)
+		return false;
+
+	if (!allocated)
+		return true;
+
+	getJournalInstr(snap->instr[insNum], &ins);
+	return fwrite(&ins, sizeof (instr_t), 1, fJournal) == 1;
+}
+
+static bool writeSampleRecord(const saveSnapshot_t *snap, int16_t insNum, int16_t smpNum)
+{
+	journalSmpHdr_t sh;
+
+	const sample_t *s = &snap->instr[insNum]->smp[smpNum];
+
+	sh.length = (s->dataPtr != NULL) ? s->length : 0;
+	sh.sample16Bit = !!(s->flags & SAMPLE_16BIT);
+
+	if (!writeRecordHeader(REC_SAMPLE, insNum, (uint8_t)smpNum, sizeof (sh) + ((uint32_t)sh.length << sh.sample16Bit)))
+		return false;
+
+	if (fwrite(&sh, sizeof (sh), 1, fJournal) != 1)
+		return false;
+
+	return writeDeltaSampleData(fJournal, s);
+}
+
+// copies the live records to a new journal (drops the superseded ones, and anything after the last commit)
+static bool compactJournal(void)
+{
+	if (fJournal != NULL)
+	{
+		fclose(fJournal);
+		fJournal = NULL;
+	}
+
+	UNICHAR *tmpFilenameU = getTmpJournalPathU();
+	if (tmpFilenameU == NULL)
+		return false;
+
+	FILE *in = UNICHAR_FOPEN(journalFilenameU, "rb");
+	FILE *out = UNICHAR_FOPEN(tmpFilenameU, "wb");
+	uint8_t *copyBuffer = (uint8_t *)malloc(JOURNAL_COPY_CHUNK_SIZE);
+
+	bool result = (in != NULL && out != NULL && copyBuffer != NULL);
+	if (result)
+	{
+		setvbuf(out, NULL, _IOFBF, JOURNAL_BUFFER_SIZE);
+		result = writeJournalHeader(out);
+	}
+
+	for (int32_t i = 0; result && i < NUM_KEYS; i++)
+	{
+		tmpIndex[i] = journalIndex[i];
+		if (journalIndex[i].size == 0)
+			continue;
+
+		if (cancelJob || FSEEK64(in, journalIndex[i].offset, SEEK_SET) != 0)
+		{
+			result = false;
+			break;
+		}
+
+		tmpIndex[i].offset = journalSize;
+
+		uint32_t bytesLeft = journalIndex[i].size;
+		while (bytesLeft > 0)
+		{
+			const uint32_t bytesToCopy = (bytesLeft > JOURNAL_COPY_CHUNK_SIZE) ? JOURNAL_COPY_CHUNK_SIZE : bytesLeft;
+			if (fread(copyBuffer, 1, bytesToCopy, in) != bytesToCopy || fwrite(copyBuffer, 1, bytesToCopy, out) != bytesToCopy)
+			{
+				result = false;
+				break;
+			}
+
+			bytesLeft -= bytesToCopy;
+		}
+
+		journalSize += journalIndex[i].size;
+	}
+
+	if (result)
+	{
+		recordHdr_t hdr;
+		memset(&hdr, 0, sizeof (hdr));
+		hdr.type = REC_COMMIT;
+
+		result = fwrite(&hdr, sizeof (hdr), 1, out) == 1;
+		journalSize += sizeof (hdr);
+	}
+
+	if (copyBuffer != NULL)
+		free(copyBuffer);
+
+	if (in != NULL)
+		fclose(in);
+
+	if (out != NULL && fclose(out) != 0)
+		result = false;
+
+	if (result)
+		result = replaceFile(tmpFilenameU, journalFilenameU);
+
+	if (!result)
+	{
+		UNICHAR_REMOVE(tmpFilenameU);
+		free(tmpFilenameU);
+
+		needsCompaction = true;
+		return false;
+	}
+
+	free(tmpFilenameU);
+	memcpy(journalIndex, tmpIndex, sizeof (journalIndex));
+
+	fJournal = UNICHAR_FOPEN(journalFilenameU, "ab");
+	if (fJournal == NULL)
+	{
+		needsCompaction = true; // try again on the next checkpoint
+		return false;
+	}
+
+	setvbuf(fJournal, NULL, _IOFBF, JOURNAL_BUFFER_SIZE);
+
+	needsCompaction = false;
+	return true;
+}
+
+static bool writeCheckpoint(autosaveJob_t *j)
+{
+	const saveSnapshot_t *snap = j->snap;
+
+	if (fJournal == NULL && !createJournal())
+	{
+		if (fJournal != NULL)
+		{
+			fclose(fJournal);
+			fJournal = NULL;
+		}
+
+		UNICHAR_REMOVE(journalFilenameU);
+		return false;
+	}
+
+	memset(tmpIndex, 0, sizeof (tmpIndex));
+
+	bool result = true;
+	if (j->songDirty)
+		result = writeSongRecord(snap);
+
+	for (int16_t i = 0; result && i < MAX_PATTERNS; i++)
+	{
+		if (j->pattDirty[i])
+			result = writePatternRecord(snap, i);
+	}
+
+	for (int16_t i = 1; result && i <= MAX_INST; i++)
+	{
+		if (j->instrDirty[i])
+			result = writeInstrRecord(snap, i);
+
+		for (int16_t k = 0; result && k < MAX_SMP_PER_INST; k++)
+		{
+			if (cancelJob)
+				result = false;
+			else if (j->smpDirty[i][k])
+				result = writeSampleRecord(snap, i, k);
+		}
+	}
+
+	if (result)
+	{
+		recordHdr_t hdr;
+		memset(&hdr, 0, sizeof (hdr));
+		hdr.type = REC_COMMIT;
+
+		result = fwrite(&hdr, sizeof (hdr), 1, fJournal) == 1;
+		journalSize += sizeof (hdr);
+	}
+
+	if (!result || fflush(fJournal) != 0)
+	{
+		needsCompaction = true; // the journal may end with a partial record
+		return false;
+	}
+
+	// the checkpoint is committed, update the index
+	for (int32_t i = 0; i < NUM_KEYS; i++)
+	{
+		if (tmpIndex[i].size == 0)
+			continue;
+
+		liveBytes += (int64_t)tmpIndex[i].size - journalIndex[i].size;
+		journalIndex[i] = tmpIndex[i];
+	}
+
+	return true;
+}
+
+static int32_t SDLCALL autosaveThread(void *ptr)
+{
+	autosaveJob_t *j = (autosaveJob_t *)ptr;
+
+	bool result = true;
+	if (needsCompaction)
+		result = compactJournal();
+
+	if (result)
+		result = writeCheckpoint(j);
+
+	if (result && journalSize >= JOURNAL_COMPACT_MIN_SIZE && journalSize > liveBytes*2)
+		compactJournal(); // the checkpoint is already committed, so a failure here is retried next time
+
+	jobResult = result;
+	jobDone = true;
+
+	return true;
+}
+
+/* ------------------------------------------------------------------------------------ */
+/*                               CHECKPOINTS (MAIN THREAD)                              */
+/* ------------------------------------------------------------------------------------ */
+
+// returns false if nothing has changed since the last checkpoint
+static bool findChanges(const saveSnapshot_t *old, const saveSnapshot_t *snap, autosaveJob_t *j)
+{
+	journalSong_t song1, song2;
+	instr_t ins1, ins2;
+
+	bool changed = false;
+
+	memset(j->pattDirty, 0, sizeof (j->pattDirty));
+	memset(j->instrDirty, 0, sizeof (j->instrDirty));
+	memset(j->smpDirty, 0, sizeof (j->smpDirty));
+
+	if (old != NULL)
+	{
+		getJournalSong(old, &song1);
+		getJournalSong(snap, &song2);
+	}
+
+	j->songDirty = (old == NULL) || memcmp(&song1, &song2, sizeof (journalSong_t)) != 0;
+	changed |= j->songDirty;
+
+	for (int32_t i = 0; i < MAX_PATTERNS; i++)
+	{
+		const note_t *p1 = (old != NULL) ? old->pattern[i] : NULL;
+		const note_t *p2 = snap->pattern[i];
+
+		if (old == NULL || old->patternNumRows[i] != snap->patternNumRows[i] || (p1 == NULL) != (p2 == NULL) ||
+			(p2 != NULL && memcmp(p1, p2, snap->patternNumRows[i] * TRACK_WIDTH) != 0))
+		{
+			j->pattDirty[i] = true;
+			changed = true;
+		}
+	}
+
+	for (int32_t i = 1; i <= MAX_INST; i++)
+	{
+		const instr_t *oldIns = (old != NULL) ? old->instr[i] : NULL;
+		const instr_t *newIns = snap->instr[i];
+
+		if (newIns == NULL)
+		{
+			j->instrDirty[i] = (old == NULL) || (oldIns != NULL);
+			changed |= j->instrDirty[i];
+			continue;
+		}
+
+		if (oldIns == NULL) // new instrument, don't let older sample records apply to it
+		{
+			j->instrDirty[i] = true;
+			for (int32_t k = 0; k < MAX_SMP_PER_INST; k++)
+				j->smpDirty[i][k] = true;
+
+			changed = true;
+			continue;
+		}
+
+		getJournalInstr(oldIns, &ins1);
+		getJournalInstr(newIns, &ins2);
+
+		if (memcmp(&ins1, &ins2, sizeof (instr_t)) != 0)
+		{
+			j->instrDirty[i] = true;
+			changed = true;
+		}
+
+		for (int32_t k = 0; k < MAX_SMP_PER_INST; k++)
+		{
+			if (oldIns->smp[k].dataGeneration != newIns->smp[k].dataGeneration)
+			{
+				j->smpDirty[i][k] = true;
+				changed = true;
+			}
+		}
+	}
+
+	return changed;
+}
+
+/* Drops the snapshot's references to the sample data (all of them, or the ones the job doesn't
+** write). The samples keep their data generation, so the snapshot can still be compared against,
+** and the song's samples can be edited without copying the data first.
+*/
+static void releaseSampleData(saveSnapshot_t *snap, const autosaveJob_t *j)
+{
+	for (int32_t i = 1; i <= MAX_INST; i++)
+	{
+		if (snap->instr[i] == NULL)
+			continue;
+
+		for (int32_t k = 0; k < MAX_SMP_PER_INST; k++)
+		{
+			if (j != NULL && j->smpDirty[i][k])
+				continue;
+
+			sample_t *s = &snap->instr[i]->smp[k];
+
+			const uint32_t dataGeneration = s->dataGeneration;
+			freeSmpData(s);
+			s->dataGeneration = dataGeneration;
+		}
+	}
+}
+
+static void setLazySampleData(saveSnapshot_t *snap, const lazyInstall_t *l)
+{
+	if (snap == NULL || snap->instr[l->insNum] == NULL)
+		return;
+
+	// only the fields set by the lazy loader (the rest may have been edited)
+	sample_t *s = &snap->instr[l->insNum]->smp[l->smpNum];
+	s->flags = l->flags;
+	s->length = l->length;
+	s->loopStart = l->loopStart;
+	s->loopLength = l->loopLength;
+	s->dataGeneration = l->dataGeneration;
+}
+
+static void finishJob(void)
+{
+	SDL_WaitThread(thread, NULL);
+	thread = NULL;
+	jobRunning = false;
+
+	if (jobResult)
+	{
+		if (checkpoint != NULL)
+			freeSnapshot(checkpoint);
+
+		checkpoint = job.snap;
+		releaseSampleData(checkpoint, NULL);
+
+		// samples loaded by the lazy loader while the thread was running
+		for (int32_t i = 0; i < numLazyInstalls; i++)
+			setLazySampleData(checkpoint, &lazyInstalls[i]);
+	}
+	else
+	{
+		freeSnapshot(job.snap);
+	}
+
+	numLazyInstalls = 0;
+	job.snap = NULL;
+}
+
+static void stopJob(void)
+{
+	if (!jobRunning)
+		return;
+
+	cancelJob = true;
+	finishJob(); // a checkpoint that was committed before the cancel is still valid
+	cancelJob = false;
+}
+
+static void startJob(void)
+{
+	saveSnapshot_t *snap = takeSnapshot(NULL, 0, true);
+	if (snap == NULL)
+		return; // out of memory, try again next time
+
+	if (!findChanges(checkpoint, snap, &job))
+	{
+		freeSnapshot(snap);
+		return;
+	}
+
+	releaseSampleData(snap, &job); // only the changed samples are referenced while the thread runs
+
+	job.snap = snap;
+	jobDone = false;
+	jobRunning = true;
+
+	thread = SDL_CreateThread(autosaveThread, NULL, &job);
+	if (thread == NULL)
+	{
+		jobRunning = false;
+		freeSnapshot(snap);
+		job.snap = NULL;
+	}
+}
+
+static saveSnapshot_t *takeCheckpoint(void) // of the song as it is now
+{
+	saveSnapshot_t *snap = takeSnapshot(NULL, 0, true);
+	if (snap != NULL)
+		releaseSampleData(snap, NULL);
+
+	return snap;
+}
+
+static void clearJournal(void) // main thread, no job running
+{
+	if (fJournal != NULL)
+	{
+		fclose(fJournal);
+		fJournal = NULL;
+	}
+
+	if (journalFilenameU != NULL)
+		UNICHAR_REMOVE(journalFilenameU);
+
+	memset(journalIndex, 0, sizeof (journalIndex));
+	journalSize = liveBytes = 0;
+	needsCompaction = false;
+}
+
+void resetAutosave(UNICHAR *baseFilenameU_)
+{
+	if (autosaveActive)
+	{
+		stopJob();
+		clearJournal();
+	}
+
+	setBaseFilename(baseFilenameU_);
+
+	if (!autosaveActive)
+		return;
+
+	if (checkpoint != NULL)
+		freeSnapshot(checkpoint);
+
+	checkpoint = takeCheckpoint(); // NULL if out of memory (everything is journaled next time)
+	saveFailed = false;
+
+	lastCheckpointTicks = SDL_GetTicks();
+}
+
+void autosaveSaveFailed(void)
+{
+	saveFailed = true;
+}
+
+void autosaveLazySampleLoaded(int16_t insNum, int16_t smpNum)
+{
+	if (!autosaveActive || instr[insNum] == NULL)
+		return;
+
+	const sample_t *s = &instr[insNum]->smp[smpNum];
+
+	lazyInstall_t install;
+	install.insNum = insNum;
+	install.smpNum = smpNum;
+	install.flags = s->flags;
+	install.length = s->length;
+	install.loopStart = s->loopStart;
+	install.loopLength = s->loopLength;
+	install.dataGeneration = s->dataGeneration;
+
+	setLazySampleData(checkpoint, &install);
+
+	if (!jobRunning)
+		return;
+
+	// the snapshot being written becomes the checkpoint, so remember this for it
+	if (numLazyInstalls == maxLazyInstalls)
+	{
+		const int32_t newMaxInstalls = (maxLazyInstalls == 0) ? 64 : (maxLazyInstalls * 2);
+
+		lazyInstall_t *newPtr = (lazyInstall_t *)realloc(lazyInstalls, newMaxInstalls * sizeof (lazyInstall_t));
+		if (newPtr == NULL)
+			return; // the sample gets journaled as a change instead
+
+		lazyInstalls = newPtr;
+		maxLazyInstalls = newMaxInstalls;
+	}
+
+	lazyInstalls[numLazyInstalls++] = install;
+}
+
+void handleAutosave(void)
+{
+	if (!autosaveActive)
+		return;
+
+	if (jobRunning && jobDone)
+		finishJob();
+
+	if (jobRunning)
+		return;
+
+	if (saveFailed) // the journal's base module wasn't written, journal the whole song
+	{
+		saveFailed = false;
+
+		clearJournal();
+		setBaseFilename(NULL);
+
+		if (checkpoint != NULL)
+		{
+			freeSnapshot(checkpoint);
+			checkpoint = NULL;
+		}
+	}
+
+	if (!song.isModified || editor.busy || editor.samplingAudioFlag || editor.editSampleFlag)
+		return; // nothing to do, or the song is being changed (by a thread, or a sample is being drawn)
+
+	if (isMusicSaving())
+		return; // the journal header has to get the stamp of the saved base module
+
+
+	if (SDL_GetTicks() - lastCheckpointTicks < AUTOSAVE_INTERVAL_MS)
+		return;
+
+	lastCheckpointTicks = SDL_GetTicks();
+	startJob();
+}
+
+void startAutosave(void)
+{
+	if (journalFilenameU == NULL)
+		journalFilenameU = getJournalPathU();
+
+	if (journalFilenameU == NULL)
+		return; // no config directory
+
+	if (journalContinues) // recovered, keep appending to the journal
+	{
+		if (!needsCompaction)
+		{
+			fJournal = UNICHAR_FOPEN(journalFilenameU, "ab");
+			if (fJournal != NULL)
+				setvbuf(fJournal, NULL, _IOFBF, JOURNAL_BUFFER_SIZE);
+			else
+				needsCompaction = true;
+		}
+	}
+	else
+	{
+		clearJournal();
+	}
+
+	checkpoint = takeCheckpoint();
+
+	lastCheckpointTicks = SDL_GetTicks();
+	autosaveActive = true;
+}
+
+void closeAutosave(void)
+{
+	if (!autosaveActive)
+		return;
+
+	stopJob();
+	clearJournal(); // the program was closed properly, nothing to recover
+
+	if (checkpoint != NULL)
+	{
+		freeSnapshot(checkpoint);
+		checkpoint = NULL;
+	}
+
+	if (lazyInstalls != NULL)
+	{
+		free(lazyInstalls);
+		lazyInstalls = NULL;
+		maxLazyInstalls = 0;
+	}
+
+	setBaseFilename(NULL);
+
+	free(journalFilenameU);
+	journalFilenameU = NULL;
+
+	autosaveActive = false;
+}
+
+/* ------------------------------------------------------------------------------------ */
+/*                                    CRASH RECOVERY                                    */
+/* ------------------------------------------------------------------------------------ */
+
+// reads the header and builds the index of the last committed checkpoint
+static bool scanJournal(FILE *f)
+{
+	journalHdr_t hdr;
+	recordHdr_t rec;
+
+	FSEEK64(f, 0, SEEK_END);
+	const int64_t fileSize = FTELL64(f);
+	rewind(f);
+
+	if (fread(&hdr, sizeof (hdr), 1, f) != 1 || memcmp(hdr.ID, JOURNAL_ID, 8) != 0 || hdr.instrSize != sizeof (instr_t))
+		return false;
+
+	if (hdr.baseNameBytes > 0)
+	{
+		if ((hdr.baseNameBytes % sizeof (UNICHAR)) != 0 || (int64_t)sizeof (hdr) + hdr.baseNameBytes > fileSize)
+			return false;
+
+		UNICHAR *filenameU = (UNICHAR *)calloc(hdr.baseNameBytes + sizeof (UNICHAR), 1);
+		if (filenameU == NULL || fread(filenameU, 1, hdr.baseNameBytes, f) != hdr.baseNameBytes)
+		{
+			if (filenameU != NULL)
+				free(filenameU);
+
+			return false;
+		}
+
+		setBaseFilename(filenameU);
+		free(filenameU);
+	}
+
+	baseFileSize = hdr.baseFileSize;
+	baseFileTime = hdr.baseFileTime;
+
+	memset(journalIndex, 0, sizeof (journalIndex));
+	memset(tmpIndex, 0, sizeof (tmpIndex));
+	liveBytes = 0;
+
+	int64_t offset = sizeof (hdr) + hdr.baseNameBytes;
+	int64_t lastCommitEnd = offset;
+
+	while (fread(&rec, sizeof (rec), 1, f) == 1)
+	{
+		const int64_t recordSize = sizeof (rec) + (int64_t)rec.length;
+		if (offset+recordSize > fileSize)
+			break; // partial record
+
+		if (rec.type == REC_COMMIT)
+		{
+			for (int32_t i = 0; i < NUM_KEYS; i++)
+			{
+				if (tmpIndex[i].size == 0)
+					continue;
+
+				liveBytes += (int64_t)tmpIndex[i].size - journalIndex[i].size;
+				journalIndex[i] = tmpIndex[i];
+				tmpIndex[i].size = 0;
+			}
+
+			lastCommitEnd = offset + recordSize;
+		}
+		else
+		{
+			const int32_t key = getRecordKey(&rec);
+			if (key < 0)
+				break; // garbage
+
+			tmpIndex[key].offset = offset;
+			tmpIndex[key].size = (uint32_t)recordSize;
+		}
+
+		offset += recordSize;
+		if (FSEEK64(f, offset, SEEK_SET) != 0)
+			break;
+	}
+
+	journalSize = lastCommitEnd;
+	needsCompaction = (lastCommitEnd != fileSize); // drop the partial checkpoint before appending
+	return true;
+}
+
+static bool readRecord(FILE *f, int32_t key, void *dst, uint32_t length) // reads the start of the record's payload
+{
+	if (journalIndex[key].size < sizeof (recordHdr_t) + length)
+		return false;
+
+	if (FSEEK64(f, journalIndex[key].offset + sizeof (recordHdr_t), SEEK_SET) != 0)
+		return false;
+
+	return fread(dst, 1, length, f) == length;
+}
+
+static bool applyInstrRecord(FILE *f, int16_t insNum)
+{
+	instr_t ins;
+	uint8_t allocated;
+
+	if (!readRecord(f, KEY_INSTR(insNum), &allocated, 1))
+		return false;
+
+	if (!allocated)
+	{
+		freeInstr(insNum); // the instrument name is in the song record
+		return true;
+	}
+
+	if (fread(&ins, sizeof (instr_t), 1, f) != 1)
+		return false;
+
+	if (instr[insNum] == NULL && !allocateInstr(insNum))
+		return false;
+
+	instr_t *dst = instr[insNum];
+	memcpy(dst, &ins, offsetof(instr_t, smp)); // the sample headers are copied without the data fields
+
+	for (int32_t i = 0; i < MAX_SMP_PER_INST; i++)
+	{
+		sample_t *s = &dst->smp[i];
+		const sample_t *src = &ins.smp[i];
+
+		unfixSample(s);
+
+		memcpy(s->name, src->name, sizeof (s->name));
+		s->finetune = src->finetune;
+		s->relativeNote = src->relativeNote;
+		s->volume = src->volume;
+		s->panning = src->panning;
+		s->loopStart = src->loopStart;
+		s->loopLength = src->loopLength;
+
+		// the length and bit depth always follow the sample data (changed by sample records)
+		s->flags = (src->flags & ~SAMPLE_16BIT) | (s->flags & SAMPLE_16BIT);
+		if (s->dataPtr == NULL)
+			s->length = 0;
+	}
+
+	return true;
+}
+
+static bool applySampleRecord(FILE *f, int16_t insNum, int16_t smpNum)
+{
+	journalSmpHdr_t sh;
+
+	sample_t *s = &instr[insNum]->smp[smpNum];
+	if (!readRecord(f, KEY_SAMPLE(insNum, smpNum), &sh, sizeof (sh)))
+		return false;
+
+	const int32_t key = KEY_SAMPLE(insNum, smpNum);
+	if (sh.length < 0 || sh.length > MAX_SAMPLE_LEN ||
+		journalIndex[key].size != sizeof (recordHdr_t) + sizeof (sh) + ((uint32_t)sh.length << (sh.sample16Bit ? 1 : 0)))
+	{
+		return false;
+	}
+
+	freeSmpData(s);
+	s->isFixed = false;
+
+	if (sh.sample16Bit)
+		s->flags |= SAMPLE_16BIT;
+	else
+		s->flags &= ~SAMPLE_16BIT;
+
+	s->length = sh.length;
+	if (sh.length == 0)
+		return true;
+
+	if (!allocateSmpData(s, sh.length, !!sh.sample16Bit))
+	{
+		s->length = 0;
+		return false;
+	}
+
+	const size_t sampleBytes = (size_t)sh.length << (sh.sample16Bit ? 1 : 0);
+	if (fread(s->dataPtr, 1, sampleBytes, f) != sampleBytes)
+	{
+		freeSmpData(s);
+		s->length = 0;
+		return false;
+	}
+
+	delta2Samp(s->dataPtr, s->length, s->flags);
+	return true;
+}
+
+static bool applyJournal(FILE *f)
+{
+	bool result = true;
+
+	lockMixerCallback();
+
+	if (journalIndex[KEY_SONG].size > 0)
+	{
+		journalSong_t js;
+		if (readRecord(f, KEY_SONG, &js, sizeof (js)))
+		{
+			memcpy(song.name, js.name, sizeof (song.name));
+			memcpy(song.instrName, js.instrName, sizeof (song.instrName));
+			memcpy(song.orders, js.orders, sizeof (song.orders));
+			song.songLength = CLAMP(js.songLength, 1, MAX_ORDERS);
+			song.songLoopStart = (js.songLoopStart < song.songLength) ? js.songLoopStart : 0;
+			song.BPM = CLAMP(js.BPM, MIN_BPM, MAX_BPM);
+			song.initialSpeed = song.speed = CLAMP(js.speed, 1, MAX_SPEED);
+			song.numChannels = CLAMP(js.numChannels, 2, MAX_CHANNELS);
+			song.name[20] = '\0';
+
+			for (int32_t i = 0; i <= MAX_INST; i++)
+				song.instrName[i][22] = '\0';
+
+			setLinearPeriods(!!js.linearPeriodsFlag);
+		}
+		else
+		{
+			result = false;
+		}
+	}
+
+	for (int16_t i = 0; i < MAX_PATTERNS; i++)
+	{
+		journalPattHdr_t ph;
+
+		const int32_t key = KEY_PATTERN(i);
+		if (journalIndex[key].size == 0)
+			continue;
+
+		if (!readRecord(f, key, &ph, sizeof (ph)) || ph.numRows < 1 || ph.numRows > MAX_PATT_LEN ||
+			journalIndex[key].size != sizeof (recordHdr_t) + sizeof (ph) + (ph.allocated ? (ph.numRows * TRACK_WIDTH) : 0))
+		{
+			result = false;
+			continue;
+		}
+
+		patternNumRows[i] = ph.numRows;
+
+		if (!ph.allocated)
+		{
+			if (pattern[i] != NULL)
+			{
+				free(pattern[i]);
+				pattern[i] = NULL;
+			}
+
+			continue;
+		}
+
+		if (!allocatePattern(i) || fread(pattern[i], 1, ph.numRows * TRACK_WIDTH, f) != (size_t)(ph.numRows * TRACK_WIDTH))
+			result = false;
+	}
+
+	for (int16_t i = 1; i <= MAX_INST; i++)
+	{
+		if (journalIndex[KEY_INSTR(i)].size > 0 && !applyInstrRecord(f, i))
+			result = false;
+
+		if (instr[i] == NULL)
+			continue; // sample records of deleted instruments are stale
+
+		bool instrChanged = journalIndex[KEY_INSTR(i)].size > 0;
+		for (int16_t k = 0; k < MAX_SMP_PER_INST; k++)
+		{
+			if (journalIndex[KEY_SAMPLE(i, k)].size == 0)
+				continue;
+
+			unfixSample(&instr[i]->smp[k]);
+			if (!applySampleRecord(f, i, k))
+				result = false;
+
+			instrChanged = true;
+		}
+
+		if (instrChanged)
+		{
+			sanitizeInstrument(instr[i]);
+			for (int32_t k = 0; k < MAX_SMP_PER_INST; k++)
+			{
+				sample_t *s = &instr[i]->smp[k];
+
+				sanitizeSample(s);
+				fixSample(s);
+			}
+		}
+	}
+
+	setScrollBarEnd(SB_POS_ED, (song.songLength - 1) + 5);
+	setScrollBarPos(SB_POS_ED, 0, false);
+
+	resetChannels();
+	setPos(0, 0, true);
+	setMixerBPM(song.BPM);
+
+	editor.BPM = song.BPM;
+	editor.speed = song.speed;
+
+	unlockMixerCallback();
+
+	return result;
+}
+
+bool recoverAutosave(void)
+{
+	journalFilenameU = getJournalPathU();
+	if (journalFilenameU == NULL)
+		return false;
+
+	FILE *f = UNICHAR_FOPEN(journalFilenameU, "rb");
+	if (f == NULL)
+		return false; // no journal, the program was closed properly
+
+	if (!scanJournal(f) || liveBytes == 0)
+	{
+		fclose(f);
+		clearJournal();
+		setBaseFilename(NULL);
+		return false;
+	}
+
+	// the changes are relative to the base module as it was when they were journaled
+	int64_t fileSize, fileTime;
+	if (baseFilenameU != NULL && getFileStamp(baseFilenameU, &fileSize, &fileTime) && (fileSize != baseFileSize || fileTime != baseFileTime))
+	{
+		okBox(0, "System message", "The unsaved changes can't be recovered, their module was changed since!", NULL);
+
+		fclose(f);
+		clearJournal();
+		setBaseFilename(NULL);
+		return false;
+	}
+
+	if (okBox(2, "System request", "The program wasn't closed properly. Recover the unsaved changes of the song?", NULL) != 1)
+	{
+		fclose(f);
+		clearJournal();
+		setBaseFilename(NULL);
+		return false;
+	}
+
+	if (baseFilenameU != NULL)
+	{
+		UNICHAR *filenameU = UNICHAR_STRDUP(baseFilenameU); // loading the module resets the base filename
+		if (filenameU == NULL || !loadMusicUnthreaded(filenameU, false))
+		{
+			if (filenameU != NULL)
+				free(filenameU);
+
+			okBox(0, "System message", "Couldn't load the module that the unsaved changes are based on!", NULL);
+
+			fclose(f);
+			clearJournal();
+			setBaseFilename(NULL);
+			return false;
+		}
+
+		free(filenameU);
+		lazyLoadAllSamples(); // the journal changes the loaded samples
+	}
+
+	const bool result = applyJournal(f);
+	fclose(f);
+
+	// redraw everything
+	updateTextBoxPointers();
+	updateChanNums();
+	hideTopScreen();
+	showTopScreen(true);
+	updateSampleEditorSample();
+	showBottomScreen();
+
+	setSongModifiedFlag();
+
+	if (!result)
+		okBox(0, "System message", "Some of the changes couldn't be recovered!", NULL);
+
+	journalContinues = true;
+	return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_unicode.h"
+
+/* Incremental autosave. The changes since the last full save (or load) are journaled to
+** "autosave.ftj" in the config directory. Every AUTOSAVE_INTERVAL_MS (if the song is modified),
+** a snapshot of the song is compared against the last checkpoint on the main thread, and only
+** the changed song header, patterns, instruments and sample data are appended to the journal
+** by a thread. The journal is compacted when it gets much bigger than its live records.
+** After a crash, the song is rebuilt from the base module plus the journal.
+*/
+#define AUTOSAVE_INTERVAL_MS (30*1000)
+
+bool recoverAutosave(void); // call once on startup, before any module is loaded. True if the song was recovered
+void startAutosave(void); // call after recoverAutosave()
+void closeAutosave(void); // on normal exit, deletes the journal
+void resetAutosave(UNICHAR *baseFilenameU); // called when a module is loaded or saved as XM (NULL = no base module)
+void autosaveSaveFailed(void); // can be called from any thread
+void autosaveLazySampleLoaded(int16_t insNum, int16_t smpNum); // the loaded data is from the base module
+void handleAutosave(void);
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <math.h>
+#include <ctype.h>
 #ifdef _WIN32
 #define WIN32_MEAN_AND_LEAN
 #include <shlwapi.h>
@@ -20,6 +21,9 @@
 #include <fts.h> // for fts_open() and stuff in recursiveDelete()
 #include <unistd.h>
 #include <dirent.h>
+#ifdef __linux__
+#include <sys/inotify.h> // for the directory watch (incremental list updates)
+#endif
 #endif
 #include <wchar.h>
 #include <sys/stat.h>
@@ -39,6 +43,9 @@
 #include "ft2_video.h"
 #include "ft2_inst_ed.h"
 #include "ft2_structs.h"
+#include "ft2_hpc.h"
+#include "ft2_profiler.h"
+#include "ft2_mod_index.h"
 
 // hide POSIX warnings for chdir()
 #ifdef _MSC_VER
@@ -48,6 +55,8 @@
 #define FILENAME_TEXT_X 170
 #define FILESIZE_TEXT_X 295
 #define DISKOP_MAX_DRIVE_BUTTONS 8
+#define DIR_READ_FIRST_BATCH 64 // entries shown before the rest of the directory has been read
+#define DIR_READ_UPDATE_MS 100 // show what has been read so far at least this often
 
 #ifdef _WIN32
 #define PARENT_DIR_STR L".."
@@ -68,8 +77,10 @@ enum
 typedef struct DirRec
 {
 	UNICHAR *nameU;
-	bool isDir;
+	bool isDir, hasFilesize; // the size of a plain file is read when it's first drawn (POSIX)
+	bool hasModStamp; // set by indexModules()
 	int32_t filesize;
+	modFileStamp_t modStamp; // for the module index lookups when drawing the list
 } DirRec;
 
 static char FReq_SysReqText[256], *FReq_FileName, *FReq_NameTemp;
@@ -78,11 +89,35 @@ static char *modTmpFNameUTF8; // for window title
 static uint8_t FReq_Item;
 static bool FReq_ShowAllFiles, insPathSet, smpPathSet, patPathSet, trkPathSet, firstTimeOpeningDiskOp = true;
 static int32_t FReq_EntrySelected = -1, FReq_FileCount, FReq_DirPos, lastMouseY;
+static bool FReq_ShowModInfo; // list shows the song titles and formats from the module index
+static int32_t FReq_EntryHovered = -1, FReq_EntryFound = -1; // list row under the mouse, buffer entry of the last match
+static char FReq_FindText[MOD_INDEX_TITLE_LEN+1];
 static UNICHAR *FReq_CurPathU, *FReq_ModCurPathU, *FReq_InsCurPathU, *FReq_SmpCurPathU, *FReq_PatCurPathU, *FReq_TrkCurPathU;
 static DirRec *FReq_Buffer;
-static SDL_Thread *thread;
+static bool FReq_BufferIsSnapshot; // entry names are still owned by the directory reader thread
+static volatile bool dirListComplete; // the directory reader thread has handed over the whole list
+static volatile bool dirReadCancel, dirReadOutOfMemory;
+static SDL_mutex *dirListMutex;
+static SDL_Thread *dirReadThread;
+
+#ifdef __linux__
+typedef struct dirListFilter_t // what decides the contents and order of the list
+{
+	uint8_t item, sortPriority;
+	bool showAllFiles, showWavFiles;
+} dirListFilter_t;
+
+static int dirWatchFd = -1, dirWatchWd = -1;
+static UNICHAR *dirWatchPathU;
+static dirListFilter_t dirWatchFilter;
+#endif
 
 static void setDiskOpItem(uint8_t item);
+static void stopDirReadThread(void);
+#ifdef __linux__
+static void removeDirWatch(void);
+static void closeDirWatch(void);
+#endif
 
 bool setupExecutablePath(void)
 {
@@ -261,7 +296,7 @@ static void freeDirRecBuffer(void)
 {
 	if (FReq_Buffer != NULL)
 	{
-		for (int32_t i = 0; i < FReq_FileCount; i++)
+		for (int32_t i = 0; i < FReq_FileCount && !FReq_BufferIsSnapshot; i++)
 		{
 			if (FReq_Buffer[i].nameU != NULL)
 				free(FReq_Buffer[i].nameU);
@@ -272,6 +307,8 @@ static void freeDirRecBuffer(void)
 	}
 
 	FReq_FileCount = 0;
+	FReq_BufferIsSnapshot = false;
+	FReq_EntryFound = -1;
 }
 
 void freeDiskOp(void)
@@ -301,7 +338,18 @@ void freeDiskOp(void)
 	if (FReq_TrkCurPathU != NULL) { free(FReq_TrkCurPathU); FReq_TrkCurPathU = NULL; }
 	if (modTmpFNameUTF8 != NULL) { free(modTmpFNameUTF8); modTmpFNameUTF8 = NULL; }
 
+	stopDirReadThread();
 	freeDirRecBuffer();
+	modIndexClose();
+#ifdef __linux__
+	closeDirWatch();
+#endif
+
+	if (dirListMutex != NULL)
+	{
+		SDL_DestroyMutex(dirListMutex);
+		dirListMutex = NULL;
+	}
 }
 
 bool setupDiskOp(void)
@@ -318,11 +366,12 @@ bool setupDiskOp(void)
 	FReq_SmpCurPathU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
 	FReq_PatCurPathU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
 	FReq_TrkCurPathU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
+	dirListMutex = SDL_CreateMutex();
 
 	if (modTmpFName      == NULL || insTmpFName      == NULL || smpTmpFName      == NULL ||
 		patTmpFName      == NULL || trkTmpFName      == NULL || FReq_NameTemp    == NULL ||
 		FReq_ModCurPathU == NULL || FReq_InsCurPathU == NULL || FReq_SmpCurPathU == NULL ||
-		FReq_PatCurPathU == NULL || FReq_TrkCurPathU == NULL)
+		FReq_PatCurPathU == NULL || FReq_TrkCurPathU == NULL || dirListMutex     == NULL)
 	{
 		// allocated memory is free'd lateron
 		showErrorMsgBox("Not enough memory!");
@@ -350,6 +399,7 @@ bool setupDiskOp(void)
 
 	setupInitialPaths();
 	setDiskOpItem(0);
+	modIndexInit();
 
 	updateCurrSongFilename(); // for window title
 	updateWindowTitle(true);
@@ -1041,8 +1091,18 @@ static void fileListPressed(int32_t index)
 	int32_t result;
 
 	const int32_t entryIndex = FReq_DirPos + index;
+
+	/* The directory reader thread replaces the list while it's reading, so work on a
+	** copy of the entry. The name stays valid until the next directory read is started.
+	*/
+	SDL_LockMutex(dirListMutex);
 	if (entryIndex >= FReq_FileCount || FReq_FileCount == 0)
+	{
+		SDL_UnlockMutex(dirListMutex);
 		return; // illegal entry
+	}
+	DirRec dirEntryCopy = FReq_Buffer[entryIndex];
+	SDL_UnlockMutex(dirListMutex);
 
 	const int8_t mode = mouse.mode;
 
@@ -1054,7 +1114,7 @@ static void fileListPressed(int32_t index)
 	FReq_EntrySelected = -1;
 	diskOp_DrawFilelist();
 
-	DirRec *dirEntry = &FReq_Buffer[entryIndex];
+	DirRec *dirEntry = &dirEntryCopy;
 	switch (mode)
 	{
 		// open file/folder
@@ -1166,6 +1226,14 @@ bool testDiskOpMouseDown(bool mouseHeldDlown)
 	{
 		FReq_EntrySelected = -1;
 
+		// clicking the path line toggles the module info view of the list
+		if (FReq_Item == DISKOP_ITEM_MODULE && mouse.x >= 2 && mouse.x <= 166 && mouse.y >= 143 && mouse.y <= 155)
+		{
+			FReq_ShowModInfo ^= 1;
+			diskOp_DrawFilelist();
+			return true;
+		}
+
 		if (mouse.x >= 169 && mouse.x <= 331 && mouse.y >= 4 && mouse.y <= 168)
 		{
 			tmpEntry = (mouse.y - 4) / (FONT1_CHAR_H + 1);
@@ -1382,6 +1450,7 @@ static int8_t findFirst(DirRec *searchRec)
 #endif
 
 	searchRec->nameU = NULL; // this one must be initialized
+	searchRec->hasModStamp = false;
 
 #ifdef _WIN32
 	hFind = FindFirstFileW(L"*", &fData);
@@ -1394,6 +1463,7 @@ static int8_t findFirst(DirRec *searchRec)
 
 	searchRec->filesize = (fData.nFileSizeHigh > 0) ? -1 : fData.nFileSizeLow;
 	searchRec->isDir = (fData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
+	searchRec->hasFilesize = true;
 #else
 	hFind = opendir(".");
 	if (hFind == NULL)
@@ -1408,6 +1478,7 @@ static int8_t findFirst(DirRec *searchRec)
 		return LFF_SKIP;
 
 	searchRec->filesize = 0;
+	searchRec->hasFilesize = true;
 
 #if defined(__sun) || defined(sun)
 	stat(fData->d_name, &s);
@@ -1431,13 +1502,9 @@ static int8_t findFirst(DirRec *searchRec)
 				searchRec->isDir = true;
 		}
 	}
-	else if (!searchRec->isDir)
+	else
 	{
-		if (stat(fData->d_name, &st) == 0)
-		{
-			fSize = (int64_t)st.st_size;
-			searchRec->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
-		}
+		searchRec->hasFilesize = searchRec->isDir; // plain file, read size when drawn (saves a stat() per file)
 	}
 #endif
 
@@ -1471,6 +1538,7 @@ static int8_t findNext(DirRec *searchRec)
 #endif
 
 	searchRec->nameU = NULL; // important
+	searchRec->hasModStamp = false;
 
 #ifdef _WIN32
 	if (hFind == NULL || FindNextFileW(hFind, &fData) == 0)
@@ -1482,6 +1550,7 @@ static int8_t findNext(DirRec *searchRec)
 
 	searchRec->filesize = (fData.nFileSizeHigh > 0) ? -1 : fData.nFileSizeLow;
 	searchRec->isDir = (fData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
+	searchRec->hasFilesize = true;
 #else
 	if (hFind == NULL || (fData = readdir(hFind)) == NULL)
 		return LFF_DONE;
@@ -1491,6 +1560,7 @@ static int8_t findNext(DirRec *searchRec)
 		return LFF_SKIP;
 
 	searchRec->filesize = 0;
+	searchRec->hasFilesize = true;
 
 #if defined(__sun) || defined(sun)
 	stat(fData->d_name, &s);
@@ -1514,13 +1584,9 @@ static int8_t findNext(DirRec *searchRec)
 				searchRec->isDir = true;
 		}
 	}
-	else if (!searchRec->isDir)
+	else
 	{
-		if (stat(fData->d_name, &st) == 0)
-		{
-			fSize = (int64_t)st.st_size;
-			searchRec->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
-		}
+		searchRec->hasFilesize = searchRec->isDir; // plain file, read size when drawn (saves a stat() per file)
 	}
 #endif
 
@@ -1552,135 +1618,131 @@ static void findClose(void)
 	}
 }
 
-static bool swapBufferEntry(int32_t a, int32_t b) // used for sorting
+typedef struct sortKey_t // used for sortDirEntries()
 {
-	if (a >= FReq_FileCount || b >= FReq_FileCount)
-		return false;
-
-	DirRec tmpBuffer = FReq_Buffer[a];
-	FReq_Buffer[a] = FReq_Buffer[b];
-	FReq_Buffer[b] = tmpBuffer;
+	const char *key;
+	int32_t index;
+} sortKey_t;
 
-	return true;
-}
-
-static char *ach(int32_t rad) // used for sortDirectory()
+// builds the lowercase sort key of a directory entry, returns its length (max. nameLen+1)
+static int32_t makeSortKey(char *dst, const char *name, int32_t nameLen, bool isDir)
 {
-	DirRec *dirEntry = &FReq_Buffer[rad];
-
-	char *name = unicharToCp437(dirEntry->nameU, true);
-	if (name == NULL)
-		return NULL;
-
-	const int32_t nameLen = (int32_t)strlen(name);
-	if (nameLen == 0)
-	{
-		free(name);
-		return NULL;
-	}
+	int32_t keyLen = 0;
 
-	char *p = (char *)malloc(nameLen+1+1);
-	if (p == NULL)
-	{
-		free(name);
-		return NULL;
-	}
-
-	if (dirEntry->isDir)
+	if (isDir)
 	{
-		// directory
-
 		if (nameLen == 2 && name[0] == '.' && name[1] == '.')
-			p[0] = 0x01; // make ".." directory first priority
+			dst[keyLen++] = 0x01; // make ".." directory first priority
 		else
-			p[0] = 0x02; // make second priority
-
-		strcpy(&p[1], name);
+			dst[keyLen++] = 0x02; // make second priority
 
-		free(name);
-		return p;
+		memcpy(&dst[keyLen], name, nameLen);
+		keyLen += nameLen;
 	}
 	else
 	{
-		// file
-
-		const int32_t i = getExtOffset(name, nameLen);
-		if (config.cfg_SortPriority == 1 || i == -1)
+		const int32_t i = getExtOffset((char *)name, nameLen);
+		if (config.cfg_SortPriority == 1 || i == -1 || nameLen-i <= 1)
 		{
 			// sort by filename
-			strcpy(p, name);
-			free(name);
-			return p;
+			memcpy(dst, name, nameLen);
+			keyLen = nameLen;
 		}
 		else
 		{
-			// sort by filename extension
+			// sort by filename extension: FILENAME.EXT -> EXTFILENAME
 			const int32_t extLen = nameLen - i;
-			if (extLen <= 1)
-			{
-				strcpy(p, name);
-				free(name);
-				return p;
-			}
-
-			// FILENAME.EXT -> EXT.FILENAME (for sorting)
-			memcpy(p, &name[i+1], extLen - 1);
-			memcpy(&p[extLen-1], name, i);
-			p[nameLen-1] = '\0';
-
-			free(name);
-			return p;
+			memcpy(dst, &name[i+1], extLen - 1);
+			memcpy(&dst[extLen-1], name, i);
+			keyLen = nameLen - 1;
 		}
 	}
+
+	for (int32_t i = 0; i < keyLen; i++)
+		dst[i] = (char)tolower((uint8_t)dst[i]); // case-insensitive sorting (like _stricmp())
+
+	dst[keyLen] = '\0';
+	return keyLen;
 }
 
-static void sortDirectory(void)
+static int compareSortKeys(const void *a, const void *b)
 {
-	bool didSwap;
+	const sortKey_t *keyA = (const sortKey_t *)a;
+	const sortKey_t *keyB = (const sortKey_t *)b;
 
-	if (FReq_FileCount < 2)
-		return; // no need to sort
+	const int result = strcmp(keyA->key, keyB->key);
+	if (result != 0)
+		return result;
 
-	uint32_t offset = FReq_FileCount >> 1;
-	while (offset > 0)
+	return keyA->index - keyB->index; // keep the listing order stable for equal names
+}
+
+/* The sort keys are built once per entry into one string pool, and the entries are
+** sorted by index with qsort(), so no memory is allocated per comparison.
+** Returns a sorted copy of the entry list (the names are not copied), or NULL if out of memory.
+*/
+static DirRec *sortDirEntries(const DirRec *entries, int32_t numEntries)
+{
+	const uint64_t startTime = SDL_GetPerformanceCounter();
+
+	sortKey_t *keys = (sortKey_t *)malloc(numEntries * sizeof (sortKey_t));
+	DirRec *sortedEntries = (DirRec *)malloc(numEntries * sizeof (DirRec));
+	if (keys == NULL || sortedEntries == NULL)
+		goto noMemory;
+
+	// convert the names first (temporarily stored in the key pointers) to get the size of the pool
+	size_t poolSize = 0;
+	for (int32_t i = 0; i < numEntries; i++)
 	{
-		const uint32_t limit = FReq_FileCount - offset;
-		do
+		char *name = unicharToCp437(entries[i].nameU, true);
+		if (name == NULL)
 		{
-			didSwap = false;
-			for (uint32_t i = 0; i < limit; i++)
-			{
-				char *p1 = ach(i);
-				char *p2 = ach(offset+i);
+			for (int32_t j = 0; j < i; j++)
+				free((char *)keys[j].key);
 
-				if (p1 == NULL || p2 == NULL)
-				{
-					if (p1 != NULL) free(p1);
-					if (p2 != NULL) free(p2);
-					okBox(0, "System message", "Not enough memory!", NULL);
-					return;
-				}
+			goto noMemory;
+		}
 
-				if (_stricmp(p1, p2) > 0)
-				{
-					if (!swapBufferEntry(i, offset + i))
-					{
-						free(p1);
-						free(p2);
-						return;
-					}
+		keys[i].key = name;
+		keys[i].index = i;
+		poolSize += strlen(name) + 2; // priority/terminator bytes
+	}
 
-					didSwap = true;
-				}
+	char *keyPool = (char *)malloc(poolSize);
+	if (keyPool == NULL)
+	{
+		for (int32_t i = 0; i < numEntries; i++)
+			free((char *)keys[i].key);
 
-				free(p1);
-				free(p2);
-			}
-		}
-		while (didSwap);
+		goto noMemory;
+	}
 
-		offset >>= 1;
+	char *keyPtr = keyPool;
+	for (int32_t i = 0; i < numEntries; i++)
+	{
+		char *name = (char *)keys[i].key;
+
+		keys[i].key = keyPtr;
+		keyPtr += makeSortKey(keyPtr, name, (int32_t)strlen(name), entries[i].isDir) + 1;
+
+		free(name);
 	}
+
+	qsort(keys, numEntries, sizeof (sortKey_t), compareSortKeys);
+
+	for (int32_t i = 0; i < numEntries; i++)
+		sortedEntries[i] = entries[keys[i].index];
+
+	free(keyPool);
+	free(keys);
+
+	profilerSetDirSortTime(numEntries, (SDL_GetPerformanceCounter() - startTime) * hpcFreq.dFreqMulMs);
+	return sortedEntries;
+
+noMemory:
+	if (keys != NULL) free(keys);
+	if (sortedEntries != NULL) free(sortedEntries);
+	return NULL;
 }
 
 static uint8_t numDigits32(uint32_t x)
@@ -1698,11 +1760,29 @@ static uint8_t numDigits32(uint32_t x)
 	return 1;
 }
 
+static void getEntryFilesize(DirRec *dirEntry) // only needed for the visible entries
+{
+#ifndef _WIN32
+	struct stat st;
+
+	dirEntry->filesize = -1;
+	if (stat(dirEntry->nameU, &st) == 0)
+	{
+		const int64_t fSize = (int64_t)st.st_size;
+		dirEntry->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
+	}
+#endif
+	dirEntry->hasFilesize = true;
+}
+
 static void printFormattedFilesize(uint16_t x, uint16_t y, uint32_t bufEntry)
 {
 	char sizeStrBuffer[16];
 	int32_t printFilesize;
 
+	if (!FReq_Buffer[bufEntry].hasFilesize)
+		getEntryFilesize(&FReq_Buffer[bufEntry]);
+
 	const int32_t filesize = FReq_Buffer[bufEntry].filesize;
 	if (filesize == -1)
 	{
@@ -1739,6 +1819,53 @@ forceMB:
 	textOut(x, y, PAL_BLCKTXT, sizeStrBuffer);
 }
 
+static const char *modFormatNames[] = { "???", "STK", "XM", "MOD", "S3M", "STM", "DIGI", "BEM" };
+
+static bool getEntryModuleInfo(int32_t bufEntry, modInfo_t *info) // called with dirListMutex locked
+{
+	if (FReq_Item != DISKOP_ITEM_MODULE || bufEntry < 0 || bufEntry >= FReq_FileCount)
+		return false;
+
+	const DirRec *dirEntry = &FReq_Buffer[bufEntry];
+	if (dirEntry->isDir || dirEntry->nameU == NULL || !dirEntry->hasModStamp)
+		return false;
+
+	return modIndexGetInfo(FReq_CurPathU, dirEntry->nameU, &dirEntry->modStamp, info) && info->format != MODULE_FORMAT_UNKNOWN;
+}
+
+static bool displayModuleInfo(int32_t bufEntry) // called with dirListMutex locked
+{
+	char text[128];
+	modInfo_t info;
+
+	if (!getEntryModuleInfo(bufEntry, &info))
+		return false;
+
+	sprintf(text, "%s %dch %dpos %s", modFormatNames[info.format], info.numChannels, info.songLength, info.title);
+
+	fillRect(4, 145, 162, 10, PAL_DESKTOP);
+	textOutClipX(4, 145, PAL_FORGRND, text, 165);
+
+	return true;
+}
+
+static void displayCurrPath(void);
+
+/* The path line shows the module index info of the pressed entry, or else the one under the
+** mouse, or else the last match of diskOpFindModule(). Called with dirListMutex locked.
+*/
+static void displayInfoLine(void)
+{
+	int32_t bufEntry = FReq_EntryFound;
+	if (FReq_EntrySelected != -1)
+		bufEntry = FReq_DirPos + FReq_EntrySelected;
+	else if (FReq_EntryHovered != -1)
+		bufEntry = FReq_DirPos + FReq_EntryHovered;
+
+	if (!displayModuleInfo(bufEntry))
+		displayCurrPath();
+}
+
 static void displayCurrPath(void)
 {
 	fillRect(4, 145, 162, 10, PAL_DESKTOP);
@@ -1814,8 +1941,21 @@ void diskOp_DrawFilelist(void)
 {
 	clearRect(FILENAME_TEXT_X-1, 4, 162, 164);
 
+	SDL_LockMutex(dirListMutex);
 	if (FReq_FileCount == 0)
+	{
+		displayCurrPath();
+		SDL_UnlockMutex(dirListMutex);
 		return;
+	}
+
+	// draw "found file" rectangle
+	const int32_t foundRow = FReq_EntryFound - FReq_DirPos;
+	if (FReq_EntryFound != -1 && foundRow >= 0 && foundRow < DISKOP_ENTRY_NUM && foundRow != FReq_EntrySelected)
+	{
+		const uint16_t y = 4 + (uint16_t)((FONT1_CHAR_H + 1) * foundRow);
+		fillRect(FILENAME_TEXT_X - 1, y, 162, FONT1_CHAR_H, PAL_BLCKMRK);
+	}
 
 	// draw "selected file" rectangle
 	if (FReq_EntrySelected != -1)
@@ -1833,13 +1973,26 @@ void diskOp_DrawFilelist(void)
 		if (FReq_Buffer[bufEntry].nameU == NULL)
 			continue;
 
+		const uint16_t y = 4 + (i * (FONT1_CHAR_H + 1));
+
+		// module info view: song title (if any) and format instead of filename and size (if indexed)
+		modInfo_t info;
+		const bool showInfo = FReq_ShowModInfo && getEntryModuleInfo(bufEntry, &info);
+		if (showInfo)
+			textOut(FILESIZE_TEXT_X, y, PAL_BLCKTXT, modFormatNames[info.format]);
+
+		if (showInfo && info.title[0] != '\0')
+		{
+			trimEntryName(info.title, false);
+			textOut(FILENAME_TEXT_X, y, PAL_BLCKTXT, info.title);
+			continue;
+		}
+
 		// convert unichar name to codepage 437
 		char *readName = unicharToCp437(FReq_Buffer[bufEntry].nameU, true);
 		if (readName == NULL)
 			continue;
 
-		const uint16_t y = 4 + (i * (FONT1_CHAR_H + 1));
-
 		// shrink entry name and add ".." if it doesn't fit on screen
 		trimEntryName(readName, FReq_Buffer[bufEntry].isDir);
 
@@ -1857,24 +2010,136 @@ void diskOp_DrawFilelist(void)
 
 		free(readName);
 
-		if (!FReq_Buffer[bufEntry].isDir)
+		if (!FReq_Buffer[bufEntry].isDir && !showInfo)
 			printFormattedFilesize(FILESIZE_TEXT_X, y, bufEntry);
 	}
+
+	displayInfoLine();
+
+	SDL_UnlockMutex(dirListMutex);
+}
+
+void diskOp_HandleMouseHover(void) // shows the module info of the entry under the mouse
+{
+	if (!ui.diskOpShown || ui.sysReqShown || FReq_Item != DISKOP_ITEM_MODULE)
+		return;
+
+	int32_t entry = -1;
+	if (mouse.x >= 169 && mouse.x <= 331 && mouse.y >= 4 && mouse.y <= 168)
+	{
+		entry = (mouse.y - 4) / (FONT1_CHAR_H + 1);
+		if (entry >= DISKOP_ENTRY_NUM)
+			entry = -1;
+	}
+
+	if (entry == FReq_EntryHovered)
+		return;
+
+	FReq_EntryHovered = entry;
+
+	SDL_LockMutex(dirListMutex);
+	displayInfoLine();
+	SDL_UnlockMutex(dirListMutex);
+}
+
+static bool containsNoCase(const char *str, const char *find)
+{
+	const size_t findLen = strlen(find);
+	for (; *str != '\0'; str++)
+	{
+		size_t i = 0;
+		while (i < findLen && str[i] != '\0' && tolower((uint8_t)str[i]) == tolower((uint8_t)find[i]))
+			i++;
+
+		if (i == findLen)
+			return true;
+	}
+
+	return false;
+}
+
+static bool entryMatches(int32_t bufEntry, const char *find) // called with dirListMutex locked
+{
+	modInfo_t info;
+
+	if (FReq_Buffer[bufEntry].nameU == NULL)
+		return false;
+
+	char *name = unicharToCp437(FReq_Buffer[bufEntry].nameU, true);
+	if (name != NULL)
+	{
+		const bool nameMatches = containsNoCase(name, find);
+		free(name);
+
+		if (nameMatches)
+			return true;
+	}
+
+	return getEntryModuleInfo(bufEntry, &info) && containsNoCase(info.title, find);
+}
+
+// finds the next entry with the text in its filename or indexed song title (Ctrl+F)
+void diskOpFindModule(void)
+{
+	if (!ui.diskOpShown || FReq_FileCount == 0)
+		return;
+
+	if (inputBox(1, "Find filename or song title:", FReq_FindText, sizeof (FReq_FindText)-1) != 1 || FReq_FindText[0] == '\0')
+		return;
+
+	SDL_LockMutex(dirListMutex);
+
+	int32_t found = -1;
+	for (int32_t i = 1; i <= FReq_FileCount; i++)
+	{
+		const int32_t bufEntry = (FReq_EntryFound + i) % FReq_FileCount; // starts after the last match, wraps around
+		if (entryMatches(bufEntry, FReq_FindText))
+		{
+			found = bufEntry;
+			break;
+		}
+	}
+
+	if (found != -1)
+	{
+		FReq_EntryFound = found;
+
+		// scroll the match into view
+		if (found < FReq_DirPos || found >= FReq_DirPos+DISKOP_ENTRY_NUM)
+		{
+			FReq_DirPos = found;
+			if (FReq_DirPos > FReq_FileCount-DISKOP_ENTRY_NUM)
+				FReq_DirPos = FReq_FileCount-DISKOP_ENTRY_NUM;
+
+			if (FReq_DirPos < 0)
+				FReq_DirPos = 0;
+
+			setScrollBarPos(SB_DISKOP_LIST, FReq_DirPos, false);
+		}
+
+		diskOp_DrawFilelist();
+	}
+
+	SDL_UnlockMutex(dirListMutex);
+
+	if (found == -1)
+		okBox(0, "System message", "No match found!", NULL);
 }
 
 void diskOp_DrawDirectory(void)
 {
 	drawTextBox(TB_DISKOP_FILENAME);
 
-	displayCurrPath();
 #ifdef _WIN32
 	setupDiskOpDrives();
 #endif
 
+	SDL_LockMutex(dirListMutex);
 	setScrollBarEnd(SB_DISKOP_LIST, FReq_FileCount);
 	setScrollBarPos(SB_DISKOP_LIST, FReq_DirPos, false);
 
 	diskOp_DrawFilelist();
+	SDL_UnlockMutex(dirListMutex);
 }
 
 static DirRec *bufferCreateEmptyDir(void) // special case: creates a dir entry with a ".." directory
@@ -1891,106 +2156,507 @@ static DirRec *bufferCreateEmptyDir(void) // special case: creates a dir entry w
 	}
 
 	dirEntry->isDir = true;
+	dirEntry->hasFilesize = true;
+	dirEntry->hasModStamp = false;
 	dirEntry->filesize = 0;
 
 	return dirEntry;
 }
 
-static int32_t SDLCALL diskOp_ReadDirectoryThread(void *ptr)
+/* The directory is read in a thread and the list is updated while reading, so that the first
+** entries are shown right away and the disk op. stays usable (opening another directory
+** cancels the read). The mouse isn't set to busy, since that would block all input.
+**
+** Shows the entries read so far. Until the last update, the list is a sorted copy that points to
+** the names in the reader thread's own list. The last update hands the names over to the list.
+*/
+static void updateDirList(DirRec *entries, int32_t numEntries, bool lastUpdate)
 {
-	DirRec tmpBuffer;
+	DirRec *newList = NULL;
+	if (!dirReadCancel)
+		newList = sortDirEntries(entries, numEntries);
 
-	FReq_DirPos = 0;
+	if (newList == NULL)
+	{
+		if (!lastUpdate)
+			return; // try again on the next update
 
-	// free old buffer
-	freeDirRecBuffer();
+		newList = entries; // cancelled or out of memory, keep the entries unsorted
+		if (!dirReadCancel)
+			dirReadOutOfMemory = true;
+	}
+	else if (lastUpdate)
+	{
+		free(entries);
+	}
 
-	UNICHAR_GETCWD(FReq_CurPathU, PATH_MAX);
+	SDL_LockMutex(dirListMutex);
+	if (FReq_BufferIsSnapshot && FReq_Buffer != NULL)
+		free(FReq_Buffer);
 
-	// read first file
-	int8_t lastFindFileFlag = findFirst(&tmpBuffer);
-	if (lastFindFileFlag != LFF_DONE && lastFindFileFlag != LFF_SKIP)
+	FReq_Buffer = newList;
+	FReq_FileCount = numEntries;
+	FReq_BufferIsSnapshot = !lastUpdate;
+	FReq_EntryFound = -1;
+	dirListComplete = lastUpdate;
+	SDL_UnlockMutex(dirListMutex);
+
+	editor.diskOpReadDone = true; // redraw list
+}
+
+/* Reads the headers of modules that aren't in the module index yet. The files are stat()ed
+** here once, and the list entries keep the stamps for the index lookups when drawing.
+*/
+static void indexModules(void)
+{
+	modFileStamp_t stamp;
+
+	bool indexChanged = false, stampsSet = false;
+	for (int32_t i = 0; !dirReadCancel; i++)
 	{
-		FReq_Buffer = (DirRec *)malloc(sizeof (DirRec) * (FReq_FileCount+1));
-		if (FReq_Buffer == NULL)
+		SDL_LockMutex(dirListMutex);
+		if (i >= FReq_FileCount)
 		{
-			findClose();
+			SDL_UnlockMutex(dirListMutex);
+			break;
+		}
+		// copy the name, the entry can be removed from the list meanwhile (directory watch)
+		UNICHAR *nameU = FReq_Buffer[i].isDir ? NULL : UNICHAR_STRDUP(FReq_Buffer[i].nameU);
+		SDL_UnlockMutex(dirListMutex);
 
-			okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+		if (nameU != NULL)
+		{
+			if (modIndexGetFileStamp(FReq_CurPathU, nameU, &stamp))
+			{
+				if (modIndexUpdateFile(FReq_CurPathU, nameU, &stamp))
+					indexChanged = true;
 
-			FReq_Buffer = bufferCreateEmptyDir();
-			if (FReq_Buffer != NULL)
-				FReq_FileCount = 1;
-			else
-				okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+				SDL_LockMutex(dirListMutex);
+				if (i < FReq_FileCount && FReq_Buffer[i].nameU != NULL && !UNICHAR_STRCMP(FReq_Buffer[i].nameU, nameU))
+				{
+					FReq_Buffer[i].modStamp = stamp;
+					FReq_Buffer[i].hasModStamp = true;
+					stampsSet = true;
+				}
+				SDL_UnlockMutex(dirListMutex);
+			}
 
-			setMouseBusy(false);
-			return false;
+			free(nameU);
 		}
-
-		memcpy(&FReq_Buffer[FReq_FileCount], &tmpBuffer, sizeof (DirRec));
-		FReq_FileCount++;
 	}
 
-	// read remaining files
-	while (lastFindFileFlag != LFF_DONE)
+	if (indexChanged)
+		modIndexSave();
+
+	if (stampsSet)
+		editor.diskOpReadDone = true; // redraw list (for the module info view)
+}
+
+static int32_t SDLCALL diskOp_ReadDirectoryThread(void *ptr)
+{
+	DirRec tmpBuffer, *entries = NULL;
+	int32_t numEntries = 0, maxEntries = 0, numShownEntries = 0;
+
+	uint64_t lastUpdateTime = SDL_GetPerformanceCounter();
+
+	int8_t lastFindFileFlag = findFirst(&tmpBuffer);
+	while (lastFindFileFlag != LFF_DONE && !dirReadCancel)
 	{
-		lastFindFileFlag = findNext(&tmpBuffer);
-		if (lastFindFileFlag != LFF_DONE && lastFindFileFlag != LFF_SKIP)
+		if (lastFindFileFlag == LFF_OK)
 		{
-			DirRec *newPtr = (DirRec *)realloc(FReq_Buffer, sizeof (DirRec) * (FReq_FileCount + 1));
-			if (newPtr == NULL)
+			if (numEntries == maxEntries)
 			{
-				freeDirRecBuffer();
-				okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
-				break;
+				maxEntries = (maxEntries == 0) ? 256 : (maxEntries * 2);
+
+				DirRec *newPtr = (DirRec *)realloc(entries, sizeof (DirRec) * maxEntries);
+				if (newPtr == NULL)
+				{
+					free(tmpBuffer.nameU);
+					dirReadOutOfMemory = true;
+					break;
+				}
+
+				entries = newPtr;
 			}
 
-			FReq_Buffer = newPtr;
+			entries[numEntries++] = tmpBuffer;
 
-			memcpy(&FReq_Buffer[FReq_FileCount], &tmpBuffer, sizeof (DirRec));
-			FReq_FileCount++;
+			/* Show the first entries right away, then update the list when the number of entries
+			** has doubled (so that the re-sorting stays O(n log n) in total), or on a slow drive.
+			*/
+			const double dTimeMs = (SDL_GetPerformanceCounter() - lastUpdateTime) * hpcFreq.dFreqMulMs;
+			if ((numEntries >= numShownEntries*2 && numEntries >= DIR_READ_FIRST_BATCH) || dTimeMs >= DIR_READ_UPDATE_MS)
+			{
+				updateDirList(entries, numEntries, false);
+				numShownEntries = numEntries;
+				lastUpdateTime = SDL_GetPerformanceCounter();
+			}
 		}
+
+		lastFindFileFlag = findNext(&tmpBuffer);
 	}
 
 	findClose();
 
-	if (FReq_FileCount > 0)
-	{
-		sortDirectory();
-	}
-	else
+	if (numEntries == 0)
 	{
 		// access denied or out of memory - create parent directory link
-		FReq_Buffer = bufferCreateEmptyDir();
-		if (FReq_Buffer != NULL)
-			FReq_FileCount = 1;
+		free(entries);
+
+		entries = bufferCreateEmptyDir();
+		if (entries != NULL)
+			numEntries = 1;
 		else
-			okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+			dirReadOutOfMemory = true;
 	}
 
-	editor.diskOpReadDone = true;
-	setMouseBusy(false);
+	updateDirList(entries, numEntries, true);
+
+	if (FReq_Item == DISKOP_ITEM_MODULE)
+		indexModules();
 
 	return true;
 
 	(void)ptr;
 }
 
+static void stopDirReadThread(void) // also cancels a directory read that is still running
+{
+	if (dirReadThread != NULL)
+	{
+		dirReadCancel = true;
+		SDL_WaitThread(dirReadThread, NULL);
+		dirReadThread = NULL;
+	}
+}
+
+#ifdef __linux__
+/* Linux: the current directory is watched with inotify, so that saving, deleting or renaming
+** a file only inserts/removes that entry in the sorted list instead of re-reading the whole
+** directory. The directory is only read again if the event queue overflowed, if the directory
+** itself was removed, or if another directory or list filter is used.
+*/
+
+static void getDirListFilter(dirListFilter_t *filter)
+{
+	filter->item = FReq_Item;
+	filter->sortPriority = config.cfg_SortPriority;
+	filter->showAllFiles = FReq_ShowAllFiles;
+	filter->showWavFiles = (FReq_Item == DISKOP_ITEM_MODULE && editor.moduleSaveMode == MOD_SAVE_MODE_WAV);
+}
+
+static void removeDirWatch(void) // the next refresh will read the whole directory
+{
+	if (dirWatchWd != -1)
+	{
+		inotify_rm_watch(dirWatchFd, dirWatchWd);
+		dirWatchWd = -1;
+	}
+}
+
+static void closeDirWatch(void)
+{
+	removeDirWatch();
+
+	if (dirWatchFd != -1)
+	{
+		close(dirWatchFd);
+		dirWatchFd = -1;
+	}
+
+	if (dirWatchPathU != NULL)
+	{
+		free(dirWatchPathU);
+		dirWatchPathU = NULL;
+	}
+}
+
+static void startDirWatch(void) // called before the directory is read, so that no changes are missed
+{
+	removeDirWatch();
+
+	if (dirWatchPathU == NULL)
+	{
+		dirWatchPathU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
+		if (dirWatchPathU == NULL)
+			return;
+	}
+
+	if (dirWatchFd == -1)
+	{
+		dirWatchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (dirWatchFd == -1)
+			return;
+	}
+
+	/* Events queued for the old watch are skipped by their watch descriptor (they're never reused
+	** right away). Changes made while the directory is being read are applied to the list afterwards,
+	** which is harmless since inserting an existing entry or removing a missing one does nothing.
+	*/
+	dirWatchWd = inotify_add_watch(dirWatchFd, FReq_CurPathU, IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+		IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+	if (dirWatchWd == -1)
+		return;
+
+	UNICHAR_STRCPY(dirWatchPathU, FReq_CurPathU);
+	getDirListFilter(&dirWatchFilter);
+}
+
+static bool dirWatchIsUsable(void) // false if the list doesn't show the watched directory as-is
+{
+	if (dirWatchWd == -1 || !dirListComplete)
+		return false;
+
+	dirListFilter_t filter;
+	getDirListFilter(&filter);
+
+	if (filter.item != dirWatchFilter.item || filter.sortPriority != dirWatchFilter.sortPriority ||
+		filter.showAllFiles != dirWatchFilter.showAllFiles || filter.showWavFiles != dirWatchFilter.showWavFiles)
+	{
+		return false;
+	}
+
+	UNICHAR cwdU[PATH_MAX + 1];
+	if (UNICHAR_GETCWD(cwdU, PATH_MAX) == NULL)
+		return false;
+
+	return !UNICHAR_STRCMP(cwdU, dirWatchPathU);
+}
+
+static int32_t findDirEntry(const UNICHAR *nameU)
+{
+	for (int32_t i = 0; i < FReq_FileCount; i++)
+	{
+		if (FReq_Buffer[i].nameU != NULL && !UNICHAR_STRCMP(FReq_Buffer[i].nameU, nameU))
+			return i;
+	}
+
+	return -1;
+}
+
+#define ENTRY_NAME_BUF_LEN ((NAME_MAX * 2) + 1) // same limit as utf8ToCp437()
+
+// builds the sort key into key (ENTRY_NAME_BUF_LEN+1 bytes) without allocating, see makeSortKey()
+static bool getEntrySortKey(UNICHAR *nameU, bool isDir, char *key)
+{
+	char name[ENTRY_NAME_BUF_LEN];
+
+	if (!utf8ToCp437Buf(nameU, name, sizeof (name), true))
+		return false;
+
+	makeSortKey(key, name, (int32_t)strlen(name), isDir);
+	return true;
+}
+
+static void removeDirEntry(int32_t index)
+{
+	if (FReq_Buffer[index].nameU != NULL)
+		free(FReq_Buffer[index].nameU);
+
+	memmove(&FReq_Buffer[index], &FReq_Buffer[index+1], (FReq_FileCount - (index+1)) * sizeof (DirRec));
+	FReq_FileCount--;
+	FReq_EntryFound = -1;
+
+	if (FReq_DirPos > FReq_FileCount-DISKOP_ENTRY_NUM)
+		FReq_DirPos = FReq_FileCount-DISKOP_ENTRY_NUM;
+
+	if (FReq_DirPos < 0)
+		FReq_DirPos = 0;
+}
+
+static bool insertDirEntry(UNICHAR *nameU, bool isDir) // returns false if out of memory
+{
+	if (handleEntrySkip(nameU, isDir))
+		return true;
+
+	const int32_t oldIndex = findDirEntry(nameU);
+	if (oldIndex != -1)
+	{
+		if (FReq_Buffer[oldIndex].isDir == isDir)
+		{
+			FReq_Buffer[oldIndex].hasFilesize = false; // the file may have been overwritten
+			FReq_Buffer[oldIndex].hasModStamp = false;
+			return true;
+		}
+
+		removeDirEntry(oldIndex); // replaced by a directory (or the other way around), sorts differently
+	}
+
+	char key[ENTRY_NAME_BUF_LEN+1], midKey[ENTRY_NAME_BUF_LEN+1];
+
+	if (!getEntrySortKey(nameU, isDir, key))
+		return false;
+
+	// binary search for the insert position (after entries with an equal key, like the stable sort)
+	int32_t lo = 0, hi = FReq_FileCount;
+	while (lo < hi)
+	{
+		const int32_t mid = (lo + hi) >> 1;
+
+		if (!getEntrySortKey(FReq_Buffer[mid].nameU, FReq_Buffer[mid].isDir, midKey))
+			return false;
+
+		if (strcmp(midKey, key) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	UNICHAR *entryNameU = UNICHAR_STRDUP(nameU);
+	if (entryNameU == NULL)
+		return false;
+
+	DirRec *newPtr = (DirRec *)realloc(FReq_Buffer, (FReq_FileCount + 1) * sizeof (DirRec));
+	if (newPtr == NULL)
+	{
+		free(entryNameU);
+		return false;
+	}
+
+	FReq_Buffer = newPtr;
+	memmove(&FReq_Buffer[lo+1], &FReq_Buffer[lo], (FReq_FileCount - lo) * sizeof (DirRec));
+	FReq_FileCount++;
+
+	FReq_Buffer[lo].nameU = entryNameU;
+	FReq_Buffer[lo].isDir = isDir;
+	FReq_Buffer[lo].hasFilesize = false;
+	FReq_Buffer[lo].hasModStamp = false;
+	FReq_Buffer[lo].filesize = 0;
+
+	return true;
+}
+
+static void handleDirWatchEvents(void)
+{
+	// don't touch the list while an entry is held down (its index is in FReq_EntrySelected)
+	if (FReq_EntrySelected != -1 || !dirWatchIsUsable())
+		return;
+
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	bool listChanged = false, rescan = false;
+
+	SDL_LockMutex(dirListMutex);
+	while (!rescan)
+	{
+		const ssize_t bytesRead = read(dirWatchFd, buffer, sizeof (buffer));
+		if (bytesRead <= 0)
+			break; // no more events (EAGAIN)
+
+		for (char *ptr = buffer; ptr < buffer+bytesRead && !rescan;)
+		{
+			const struct inotify_event *event = (const struct inotify_event *)ptr;
+			ptr += sizeof (struct inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				rescan = true; // events were lost
+				break;
+			}
+
+			if (event->wd != dirWatchWd)
+				continue; // queued before the watch was moved to another directory
+
+			if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+			{
+				rescan = true;
+				break;
+			}
+
+			if (event->len == 0)
+				continue;
+
+			UNICHAR *nameU = (UNICHAR *)event->name;
+			if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+			{
+				const int32_t index = findDirEntry(nameU);
+				if (index != -1)
+					removeDirEntry(index);
+			}
+			else if (!insertDirEntry(nameU, !!(event->mask & IN_ISDIR)))
+			{
+				rescan = true; // out of memory, the directory read will tell
+				break;
+			}
+
+			listChanged = true;
+		}
+	}
+	SDL_UnlockMutex(dirListMutex);
+
+	if (rescan)
+	{
+		removeDirWatch();
+
+		if (ui.diskOpShown)
+			editor.diskOpReadDir = true;
+		else
+			editor.diskOpReadOnOpen = true;
+	}
+	else if (listChanged)
+	{
+		editor.diskOpReadDone = true; // redraw list
+	}
+}
+#endif
+
 void diskOp_StartDirReadThread(void)
 {
+	stopDirReadThread();
+
+	freeDirRecBuffer();
+	FReq_DirPos = 0;
+	UNICHAR_GETCWD(FReq_CurPathU, PATH_MAX);
+	dirListComplete = false;
+
+#ifdef __linux__
+	startDirWatch();
+#endif
+
+	if (ui.diskOpShown)
+		diskOp_DrawFilelist(); // clear old list
+
 	editor.diskOpReadDone = false;
+	dirReadCancel = false;
+	dirReadOutOfMemory = false;
 
-	mouseAnimOn();
-	thread = SDL_CreateThread(diskOp_ReadDirectoryThread, NULL, NULL);
-	if (thread == NULL)
+	dirReadThread = SDL_CreateThread(diskOp_ReadDirectoryThread, NULL, NULL);
+	if (dirReadThread == NULL)
 	{
 		editor.diskOpReadDone = true;
 		okBox(0, "System message", "Couldn't create thread!", NULL);
 		return;
 	}
+}
 
-	SDL_DetachThread(thread);
+void diskOp_RefreshDirectory(void) // after saving etc.
+{
+#ifdef __linux__
+	if (dirWatchIsUsable())
+	{
+		handleDirWatchEvents(); // the changes are already known
+		return;
+	}
+#endif
+	diskOp_StartDirReadThread();
+}
+
+void diskOp_HandleDirChanges(void) // called from the main loop
+{
+#ifdef __linux__
+	handleDirWatchEvents();
+#endif
+}
+
+void diskOp_HandleDirReadUpdate(void) // called from the main loop when the list has been updated
+{
+	if (dirReadOutOfMemory)
+	{
+		dirReadOutOfMemory = false;
+		okBox(0, "System message", "Not enough memory!", NULL);
+	}
+
+	if (ui.diskOpShown)
+		diskOp_DrawDirectory();
 }
 
 static void drawSaveAsElements(void)
@@ -2288,7 +2954,7 @@ void showDiskOpScreen(void)
 	if (editor.diskOpReadOnOpen)
 	{
 		editor.diskOpReadOnOpen = false;
-		diskOp_StartDirReadThread();
+		diskOp_RefreshDirectory();
 	}
 }
 
@@ -2421,6 +3087,9 @@ void pbDiskOpMakeDir(void)
 
 void pbDiskOpRefresh(void)
 {
+#ifdef __linux__
+	removeDirWatch(); // always read the whole directory
+#endif
 	editor.diskOpReadDir = true; // refresh dir
 #ifdef _WIN32
 	setupDiskOpDrives();
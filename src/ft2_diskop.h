@@ -42,8 +42,13 @@ int32_t getExtOffset(char *s, int32_t stringLen); // get byte offset of file ext
 bool testDiskOpMouseDown(bool mouseHeldDown);
 void testDiskOpMouseRelease(void);
 void diskOp_StartDirReadThread(void);
+void diskOp_RefreshDirectory(void); // only applies the changes if the directory is watched (Linux)
+void diskOp_HandleDirChanges(void);
+void diskOp_HandleDirReadUpdate(void);
 void diskOp_DrawFilelist(void);
 void diskOp_DrawDirectory(void);
+void diskOp_HandleMouseHover(void);
+void diskOpFindModule(void);
 void showDiskOpScreen(void);
 void hideDiskOpScreen(void);
 void exitDiskOpScreen(void);
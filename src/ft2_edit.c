@@ -33,9 +33,19 @@ static note_t ptnCopyBuff[MAX_PATT_LEN * MAX_CHANNELS];
 static note_t trackCopyBuff[MAX_PATT_LEN];
 
 // for recordNote()
+#define MAX_KEY_LATENCY_MS 1000
 static const int8_t tickArr[16] = { 16, 8, 0, 4, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 1 };
 
-void recordNote(uint8_t note, int8_t vol);
+static void recordNoteLate(uint8_t noteNum, int8_t vol, int16_t latencyTicks);
+
+static int16_t getKeyLatencyTicks(void) // how late the current key event is being handled, in replayer ticks
+{
+	const uint32_t latencyMs = SDL_GetTicks() - keyb.eventTimestamp;
+	if (latencyMs > MAX_KEY_LATENCY_MS || editor.BPM == 0)
+		return 0;
+
+	return (int16_t)((latencyMs * editor.BPM) / 2500); // a tick is 2500/BPM milliseconds
+}
 
 // when the cursor is at the note slot
 static bool testNoteKeys(SDL_Scancode scancode)
@@ -69,7 +79,7 @@ static bool testNoteKeys(SDL_Scancode scancode)
 
 	if (noteNum > 0 && noteNum <= 96)
 	{
-		recordNote(noteNum, -1);
+		recordNoteLate(noteNum, -1, getKeyLatencyTicks());
 		return true; // note key pressed (and note triggered)
 	}
 
@@ -81,7 +91,7 @@ void testNoteKeysRelease(SDL_Scancode scancode)
 {
 	const int8_t noteNum = scancodeKeyToNote(scancode); // convert key scancode to note number
 	if (noteNum > 0 && noteNum <= 96)
-		recordNote(noteNum, 0); // release note
+		recordNoteLate(noteNum, 0, getKeyLatencyTicks()); // release note
 }
 
 static bool testEditKeys(SDL_Scancode scancode, SDL_Keycode keycode)
@@ -266,13 +276,21 @@ static bool testEditKeys(SDL_Scancode scancode, SDL_Keycode keycode)
 	return true;
 }
 
-static void evaluateTimeStamp(int16_t *songPos, int16_t *pattNum, int16_t *row, int16_t *tick)
+static void evaluateTimeStamp(int16_t *songPos, int16_t *pattNum, int16_t *row, int16_t *tick, int16_t latencyTicks)
 {
 	int16_t outSongPos = editor.songPos;
 	int16_t outPattern = editor.editPattern;
 	int16_t outRow = editor.row;
 	int16_t outTick = editor.speed - editor.tick;
 
+	// move back to where the note was played if the input was handled late (but not into the previous pattern)
+	outTick -= latencyTicks;
+	while (outTick < 0 && outRow > 0)
+	{
+		outTick += editor.speed;
+		outRow--;
+	}
+
 	outTick = CLAMP(outTick, 0, editor.speed-1);
 
 	// this is needed, but also breaks quantization on speed>15
@@ -326,7 +344,12 @@ static void evaluateTimeStamp(int16_t *songPos, int16_t *pattNum, int16_t *row,
 	*tick = outTick;
 }
 
-void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the original FT2 code - what a mess, but it works...
+void recordNote(uint8_t noteNum, int8_t vol)
+{
+	recordNoteLate(noteNum, vol, 0);
+}
+
+static void recordNoteLate(uint8_t noteNum, int8_t vol, int16_t latencyTicks) // directly ported from the original FT2 code - what a mess, but it works...
 {
 	int8_t i;
 	int16_t pattNum, songPos, row, tick;
@@ -338,7 +361,7 @@ void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the origina
 	if (songPlaying)
 	{
 		// row quantization
-		evaluateTimeStamp(&songPos, &pattNum, &row, &tick);
+		evaluateTimeStamp(&songPos, &pattNum, &row, &tick, latencyTicks);
 	}
 	else
 	{
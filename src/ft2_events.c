@@ -19,6 +19,7 @@
 #include "ft2_diskop.h"
 #include "ft2_module_loader.h"
 #include "ft2_module_saver.h"
+#include "ft2_autosave.h"
 #include "ft2_sample_loader.h"
 #include "ft2_mouse.h"
 #include "ft2_midi.h"
@@ -60,6 +61,17 @@ void readInput(void)
 	handleSDLEvents();
 }
 
+/* Input events get their timestamps when they're moved from the OS to SDL's event queue.
+** This is done between the main loop stages, so that a slow stage (f.ex. a sample editor
+** redraw of a huge sample) doesn't make the input look newer than it really is. The events
+** are still handled in the next frame, but note recording uses the timestamps to put the
+** notes where they were played.
+*/
+void pumpInputEvents(void)
+{
+	SDL_PumpEvents();
+}
+
 void handleThreadEvents(void)
 {
 	if (okBoxData.active)
@@ -118,17 +130,22 @@ void handleEvents(void)
 	if (editor.diskOpReadDir)
 	{
 		editor.diskOpReadDir = false;
-		diskOp_StartDirReadThread();
+		diskOp_RefreshDirectory();
 	}
 
+	diskOp_HandleDirChanges();
+
 	if (editor.diskOpReadDone)
 	{
 		editor.diskOpReadDone = false;
-		if (ui.diskOpShown)
-			diskOp_DrawDirectory();
+		diskOp_HandleDirReadUpdate();
 	}
 
+	diskOp_HandleMouseHover();
+
 	handleLoadMusicEvents();
+	handleLazySampleEvents();
+	handleAutosave();
 
 	if (editor.samplingAudioFlag) handleSamplingUpdates();
 	if (ui.setMouseBusy) mouseAnimOn();
@@ -372,6 +389,9 @@ void handleWaitVblQuirk(SDL_Event *event)
 		else if (event->window.event == SDL_WINDOWEVENT_SHOWN)
 			video.windowHidden = false;
 
+		// window was exposed/resized/restored etc., the next frame must be fully presented again
+		markScreenDirty();
+
 		// reset vblank end time if we minimize window
 		if (event->window.event == SDL_WINDOWEVENT_MINIMIZED || event->window.event == SDL_WINDOWEVENT_FOCUS_LOST)
 			hpc_ResetCounters(&video.vblankHpc);
@@ -494,10 +514,12 @@ static void handleSDLEvents(void)
 		}
 		else if (event.type == SDL_KEYUP)
 		{
+			keyb.eventTimestamp = event.key.timestamp;
 			keyUpHandler(event.key.keysym.scancode, event.key.keysym.sym);
 		}
 		else if (event.type == SDL_KEYDOWN)
 		{
+			keyb.eventTimestamp = event.key.timestamp;
 			keyDownHandler(event.key.keysym.scancode, event.key.keysym.sym, event.key.repeat);
 		}
 		else if (event.type == SDL_MOUSEBUTTONUP)
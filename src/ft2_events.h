@@ -14,6 +14,7 @@ enum
 
 void handleThreadEvents(void);
 void readInput(void);
+void pumpInputEvents(void);
 void handleEvents(void);
 void setupCrashHandler(void);
 void handleWaitVblQuirk(SDL_Event *event);
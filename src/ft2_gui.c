@@ -291,6 +291,8 @@ uint16_t textWidth16(const char *textPtr)
 void textOutTiny(int32_t xPos, int32_t yPos, char *str, uint32_t color) // A..Z/a..z and 0..9
 {
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, (int32_t)strlen(str) * FONT3_CHAR_W, FONT3_CHAR_H);
+
 	while (*str != '\0')
 	{
 		char chr = *str++;
@@ -356,6 +358,7 @@ void charOut(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr)
 	const uint32_t pixVal = video.palette[paletteIndex];
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W, FONT1_CHAR_H);
 
 	for (uint32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -383,6 +386,7 @@ void charOutBg(uint16_t xPos, uint16_t yPos, uint8_t fgPalette, uint8_t bgPalett
 
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W-1, FONT1_CHAR_H);
 
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -417,6 +421,7 @@ void charOutShadow(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, uint8_t s
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr1 = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
 	uint32_t *dstPtr2 = dstPtr1 + (SCREEN_W+1);
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W+1, FONT1_CHAR_H+1);
 
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -454,6 +459,8 @@ void charOutClipX(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr,
 	if (xPos+width > clipX)
 		width = FONT1_CHAR_W - ((xPos + width) - clipX);
 
+	markDirtyRect(xPos, yPos, width, FONT1_CHAR_H);
+
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
 		for (int32_t x = 0; x < width; x++)
@@ -478,6 +485,7 @@ void bigCharOut(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr)
 	const uint8_t *srcPtr = &bmp.font2[chr * FONT2_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
 	const uint32_t pixVal = video.palette[paletteIndex];
+	markDirtyRect(xPos, yPos, FONT2_CHAR_W, FONT2_CHAR_H);
 
 	for (int32_t y = 0; y < FONT2_CHAR_H; y++)
 	{
@@ -505,6 +513,7 @@ static void bigCharOutShadow(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex,
 	const uint8_t *srcPtr = &bmp.font2[chr * FONT2_CHAR_W];
 	uint32_t *dstPtr1 = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
 	uint32_t *dstPtr2 = dstPtr1 + (SCREEN_W+1);
+	markDirtyRect(xPos, yPos, FONT2_CHAR_W+1, FONT2_CHAR_H+1);
 
 	for (int32_t y = 0; y < FONT2_CHAR_H; y++)
 	{
@@ -639,6 +648,7 @@ void hexOut(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, uint32_t val, ui
 
 	const uint32_t pixVal = video.palette[paletteIndex];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, numDigits * FONT6_CHAR_W, FONT6_CHAR_H);
 
 	for (int32_t i = numDigits-1; i >= 0; i--)
 	{
@@ -668,6 +678,7 @@ void hexOutBg(uint16_t xPos, uint16_t yPos, uint8_t fgPalette, uint8_t bgPalette
 	const uint32_t fg = video.palette[fgPalette];
 	const uint32_t bg = video.palette[bgPalette];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, numDigits * FONT6_CHAR_W, FONT6_CHAR_H);
 
 	for (int32_t i = numDigits-1; i >= 0; i--)
 	{
@@ -703,6 +714,7 @@ void clearRect(uint16_t xPos, uint16_t yPos, uint16_t w, uint16_t h)
 	const uint32_t pitch = w * sizeof (int32_t);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++, dstPtr += SCREEN_W)
 		memset(dstPtr, 0, pitch);
 }
@@ -713,6 +725,7 @@ void fillRect(uint16_t xPos, uint16_t yPos, uint16_t w, uint16_t h, uint8_t pale
 
 	const uint32_t pixVal = video.palette[paletteIndex];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 
 	for (int32_t y = 0; y < h; y++)
 	{
@@ -728,6 +741,7 @@ void blit32(uint16_t xPos, uint16_t yPos, const uint32_t *srcPtr, uint16_t w, ui
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + w) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -746,6 +760,7 @@ void blit(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t w, uint1
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + w) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -768,6 +783,7 @@ void blitClipX(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t w,
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + clipX) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, clipX, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < clipX; x++)
@@ -787,6 +803,7 @@ void blitFast(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t w, u
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + w) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -805,6 +822,7 @@ void blitFastClipX(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + clipX) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, clipX, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < clipX; x++)
@@ -824,6 +842,7 @@ void hLine(uint16_t x, uint16_t y, uint16_t w, uint8_t paletteIndex)
 	const uint32_t pixVal = video.palette[paletteIndex];
 
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, w, 1);
 	for (int32_t i = 0; i < w; i++)
 		dstPtr[i] = pixVal;
 }
@@ -835,6 +854,7 @@ void vLine(uint16_t x, uint16_t y, uint16_t h, uint8_t paletteIndex)
 	const uint32_t pixVal = video.palette[paletteIndex];
 
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 1, h);
 	for (int32_t i = 0; i < h; i++)
 	{
 		*dstPtr = pixVal;
@@ -869,6 +889,8 @@ void line(int16_t x1, int16_t x2, int16_t y1, int16_t y2, uint8_t paletteIndex)
 	const int32_t pitch  = sy * SCREEN_W;
 	uint32_t *dst32  = &video.frameBuffer[(y * SCREEN_W) + x];
 
+	markDirtyRect(MIN(x1, x2), MIN(y1, y2), ABS(dx) + 1, ABS(dy) + 1);
+
 	// draw line
 	if (ax > ay)
 	{
@@ -281,6 +281,7 @@ static void bigTextOutHalf(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, b
 
 			uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + currX];
 			const uint32_t pixVal = video.palette[paletteIndex];
+			markDirtyRect(currX, yPos, FONT2_CHAR_W, FONT2_CHAR_H/2);
 
 			for (uint32_t y = 0; y < FONT2_CHAR_H/2; y++)
 			{
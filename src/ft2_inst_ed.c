@@ -21,6 +21,8 @@
 #include "ft2_tables.h"
 #include "ft2_bmp.h"
 #include "ft2_structs.h"
+#include "ft2_module_loader.h"
+#include "ft2_module_saver.h"
 #include "ft2_bmp.h"
 
 #ifdef _MSC_VER
@@ -233,6 +235,8 @@ void copyInstr(void) // dstInstr = srcInstr
 	if (editor.curInstr == 0 || editor.srcInstr == editor.curInstr)
 		return;
 
+	lazyLoadInstrument(editor.srcInstr);
+
 	mouseAnimOn();
 	thread = SDL_CreateThread(copyInstrThread, NULL, NULL);
 	if (thread == NULL)
@@ -249,6 +253,9 @@ void xchgInstr(void) // dstInstr <-> srcInstr
 	if (editor.curInstr == 0 || editor.srcInstr == editor.curInstr)
 		return;
 
+	lazyLoadInstrument(editor.curInstr);
+	lazyLoadInstrument(editor.srcInstr);
+
 	lockMixerCallback();
 
 	// swap instruments
@@ -389,6 +396,8 @@ void updateNewSample(void)
 
 void updateNewInstrument(void)
 {
+	lazyLoadInstrument(editor.curInstr); // huge module, make sure the samples are loaded before they are shown
+
 	updateTextBoxPointers();
 
 	if (ui.instrSwitcherShown)
@@ -1568,6 +1577,7 @@ static void pinoaNumberOut(uint16_t xPos, uint16_t yPos, uint8_t fgPalette, uint
 	const uint32_t bg = video.palette[bgPalette];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
 	const uint8_t *srcPtr = &bmp.font8[val * 5];
+	markDirtyRect(xPos, yPos, 5, 7);
 
 	for (int32_t y = 0; y < 7; y++)
 	{
@@ -1764,6 +1774,7 @@ static void envelopeLine(int32_t envNum, int16_t x1, int16_t y1, int16_t x2, int
 	const int32_t pitch = sy * SCREEN_W;
 
 	uint32_t *dst32 = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(MIN(x1, x2), MIN(y1, y2), ABS(dx) + 1, ABS(dy) + 1);
 
 	// draw line
 	if (ax > ay)
@@ -1828,6 +1839,7 @@ static void envelopePixel(int32_t envNum, int16_t x, int16_t y, uint8_t pal)
 {
 	y += (envNum == 0) ? 189 : 276;
 	video.frameBuffer[(y * SCREEN_W) + x] = video.palette[pal];
+	markDirtyRect(x, y, 1, 1);
 }
 
 static void envelopeDot(int32_t envNum, int16_t x, int16_t y)
@@ -1836,6 +1848,7 @@ static void envelopeDot(int32_t envNum, int16_t x, int16_t y)
 
 	const uint32_t pixVal = video.palette[PAL_BLCKTXT];
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 3, 3);
 
 	for (y = 0; y < 3; y++)
 	{
@@ -1855,6 +1868,8 @@ static void envelopeVertLine(int32_t envNum, int16_t x, int16_t y, uint8_t pal)
 	const uint32_t pixVal2 = video.palette[PAL_BLCKTXT];
 
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 1, 33*2);
+
 	for (y = 0; y < 33; y++)
 	{
 		if (*dstPtr != pixVal2)
@@ -2037,6 +2052,7 @@ static void drawPanEnvCoords(int16_t tick, int16_t val)
 		hLine(326, 289, 3, PAL_BCKGRND);
 		video.frameBuffer[(288 * SCREEN_W) + 325] = video.palette[PAL_BCKGRND];
 		video.frameBuffer[(288 * SCREEN_W) + 329] = video.palette[PAL_BCKGRND];
+		markDirtyRect(325, 288, 5, 1);
 
 		hLine(326, 288, 3, PAL_FORGRND);
 	}
@@ -3030,30 +3046,16 @@ static int32_t SDLCALL saveInstrThread(void *ptr)
 		return false;
 	}
 
-	pauseAudio();
 	s = instr[saveInstrNum]->smp;
 	for (int32_t i = 0; i < numSamples; i++, s++)
 	{
-		if (s->dataPtr != NULL && s->length > 0)
+		if (!writeDeltaSampleData(f, s)) // doesn't touch the sample data, no need to pause the audio
 		{
-			unfixSample(s);
-			samp2Delta(s->dataPtr, s->length, s->flags);
-
-			result = fwrite(s->dataPtr, 1, SAMPLE_LENGTH_BYTES(s), f);
-
-			delta2Samp(s->dataPtr, s->length, s->flags);
-			fixSample(s);
-
-			if (result != (size_t)SAMPLE_LENGTH_BYTES(s)) // write not OK
-			{
-				resumeAudio();
-				fclose(f);
-				okBoxThreadSafe(0, "System message", "Error saving instrument: general I/O error!", NULL);
-				return false;
-			}
+			fclose(f);
+			okBoxThreadSafe(0, "System message", "Error saving instrument: general I/O error!", NULL);
+			return false;
 		}
 	}
-	resumeAudio();
 
 	fclose(f);
 
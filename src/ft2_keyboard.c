@@ -912,6 +912,11 @@ static bool checkModifiedKeys(SDL_Keycode keycode)
 				jumpToChannel(11);
 				return true;
 			}
+			else if (keyb.leftCtrlPressed && ui.diskOpShown)
+			{
+				diskOpFindModule();
+				return true;
+			}
 		}
 		break;
 
@@ -10,6 +10,7 @@ typedef struct keyb_t
 	bool ignoreCurrKeyUp, ignoreTextEditKey, numPadPlusPressed;
 	bool keyModifierDown, leftCommandPressed;
 	bool leftShiftPressed, leftCtrlPressed, leftAltPressed;
+	uint32_t eventTimestamp; // SDL_GetTicks() time of the key event being handled
 } keyb_t;
 
 extern keyb_t keyb; // ft2_keyboard.c
@@ -34,12 +34,18 @@
 #include "ft2_bmp.h"
 #include "ft2_structs.h"
 #include "ft2_hpc.h"
+#include "ft2_profiler.h"
+#include "ft2_workers.h"
+#include "ft2_autosave.h"
 
 #ifdef HAS_MIDI
 static SDL_Thread *initMidiThread;
 #endif
 
+static bool compactSincTables;
+
 static void initializeVars(void);
+static void handleStartupSwitches(int *argc, char **argv);
 static void cleanUpAndExit(void); // never call this inside the main loop
 #ifdef __APPLE__
 static void osxSetDirToProgramDirFromArgs(char **argv);
@@ -69,6 +75,7 @@ int main(int argc, char *argv[])
 	SDL_EnableScreenSaver(); // allow screensaver to activate
 
 	initializeVars();
+	handleStartupSwitches(&argc, argv);
 	setupCrashHandler();
 
 	// on Windows and macOS, test what version SDL2.DLL is (against library version used in compilation)
@@ -145,6 +152,7 @@ int main(int argc, char *argv[])
 
 	hpc_Init();
 	hpc_SetDurationInHz(&video.vblankHpc, VBLANK_HZ);
+	initWorkerThreads();
 
 #ifdef __APPLE__
 	osxSetDirToProgramDirFromArgs(argv);
@@ -155,7 +163,7 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
-	if (!calcCubicSplineTable() || !calcWindowedSincTables()) // must be called before config is loaded
+	if (!calcCubicSplineTable() || !calcWindowedSincTables(compactSincTables)) // must be called before config is loaded
 	{
 		cleanUpAndExit();
 		return false;
@@ -241,7 +249,10 @@ int main(int argc, char *argv[])
 #endif
 
 	hpc_ResetCounters(&video.vblankHpc); // quirk: this is needed for potential okBox() calls in handleModuleLoadFromArg()
-	handleModuleLoadFromArg(argc, argv);
+	if (!recoverAutosave()) // the song of a crashed session replaces the module given as argument
+		handleModuleLoadFromArg(argc, argv);
+
+	startAutosave();
 
 	editor.mainLoopOngoing = true;
 	hpc_ResetCounters(&video.vblankHpc); // this must be the last thing we do before entering the main loop
@@ -249,12 +260,29 @@ int main(int argc, char *argv[])
 	while (editor.programRunning)
 	{
 		beginFPSCounter();
+
+		profilerBegin(PROF_THREAD_EVENTS);
 		handleThreadEvents();
+		profilerEnd(PROF_THREAD_EVENTS);
+
+		profilerBegin(PROF_INPUT);
 		readInput();
+		profilerEnd(PROF_INPUT);
+		pumpInputEvents();
+
+		profilerBegin(PROF_EVENTS);
 		handleEvents();
+		profilerEnd(PROF_EVENTS);
+		pumpInputEvents();
+
+		profilerBegin(PROF_REDRAW);
 		handleRedrawing();
+		profilerEnd(PROF_REDRAW);
+		pumpInputEvents();
+
 		flipFrame();
 		endFPSCounter();
+		profilerEndFrame();
 	}
 
 	if (config.cfg_AutoSave)
@@ -327,6 +355,41 @@ static void initializeVars(void)
 	editor.programRunning = true;
 }
 
+/* Startup switches are stripped from argv, so that the rest of the
+** program only sees the (optional) module filename parameter.
+*/
+static void handleStartupSwitches(int *argc, char **argv)
+{
+	int32_t numArgs = 1;
+	for (int32_t i = 1; i < *argc; i++)
+	{
+		if (argv[i] == NULL)
+			continue;
+
+		if (!strcmp(argv[i], "--compact-sinc")) // smaller windowed-sinc LUTs (for CPUs with small caches)
+			compactSincTables = true;
+		else if (!strcmp(argv[i], "--float-samples")) // keep a float copy of all samples for the mixer
+			audio.floatSampleCache = true;
+		else if (!strcmp(argv[i], "--texture-sprites")) // draw the cursors into the texture (no framebuffer save/restore)
+			video.spritesInTexture = true;
+		else if (!strcmp(argv[i], "--profile")) // main loop profiler (shown with the FPS counter)
+			profilerInit(NULL);
+		else if (!strcmp(argv[i], "--profile-trace")) // ...plus Chrome trace export on exit
+		{
+			// the trace filename is optional (but must not be another switch)
+			if (i+1 < *argc && argv[i+1] != NULL && strncmp(argv[i+1], "--", 2) != 0)
+				profilerInit(argv[++i]);
+			else
+				profilerInit(PROF_DEFAULT_TRACE_FILENAME);
+		}
+		else
+			argv[numArgs++] = argv[i];
+	}
+
+	argv[numArgs] = NULL;
+	*argc = numArgs;
+}
+
 static void cleanUpAndExit(void) // never call this inside the main loop!
 {
 #ifdef HAS_MIDI
@@ -337,6 +400,9 @@ static void cleanUpAndExit(void) // never call this inside the main loop!
 	}
 #endif
 
+	profilerClose();
+	closeAutosave();
+	closeWorkerThreads();
 	closeAudio();
 	closeReplayer();
 	closeVideo();
@@ -0,0 +1,311 @@
+/*
+** Read-only memory "file" for the module loaders
+**
+** A module is memory-mapped (or read into memory in one go if that fails) and parsed
+** from there, so the loaders don't make a system call for every small header read/seek.
+*/
+
+// for finding memory leaks in debug mode with Visual Studio
+#if defined _DEBUG && defined _MSC_VER
+#include <crtdbg.h>
+#endif
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define WIN32_MEAN_AND_LEAN
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "ft2_unicode.h"
+#include "ft2_memfile.h"
+
+enum
+{
+	MEMFILE_EXTERNAL = 0, // buffer from mopen(), owned by the caller
+	MEMFILE_MAPPED = 1,
+	MEMFILE_ALLOCATED = 2
+};
+
+struct mem_t
+{
+	const uint8_t *_base;
+	uint32_t _pos, _size;
+	bool _eof;
+	int8_t _type;
+#ifdef _WIN32
+	HANDLE _hMap;
+#endif
+};
+
+MEMFILE *mopen(const uint8_t *src, uint32_t length)
+{
+	if (src == NULL && length > 0)
+		return NULL;
+
+	MEMFILE *b = (MEMFILE *)calloc(1, sizeof (MEMFILE));
+	if (b == NULL)
+		return NULL;
+
+	b->_base = src;
+	b->_size = length;
+	b->_type = MEMFILE_EXTERNAL;
+
+	return b;
+}
+
+static MEMFILE *readWholeFile(const UNICHAR *filenameU) // fallback if the file can't be memory-mapped
+{
+	FILE *f = UNICHAR_FOPEN(filenameU, "rb");
+	if (f == NULL)
+		return NULL;
+
+	fseek(f, 0, SEEK_END);
+	const long fileLength = ftell(f);
+	rewind(f);
+
+	if (fileLength < 0 || fileLength > INT32_MAX)
+	{
+		fclose(f);
+		return NULL;
+	}
+
+	uint8_t *data = (uint8_t *)malloc(fileLength + 1); // +1 so that an empty file isn't a NULL pointer
+	if (data == NULL)
+	{
+		fclose(f);
+		return NULL;
+	}
+
+	const size_t bytesRead = fread(data, 1, fileLength, f);
+	fclose(f);
+
+	MEMFILE *b = mopen(data, (uint32_t)bytesRead);
+	if (b == NULL)
+	{
+		free(data);
+		return NULL;
+	}
+
+	b->_type = MEMFILE_ALLOCATED;
+	return b;
+}
+
+MEMFILE *mopenFile(const UNICHAR *filenameU)
+{
+	if (filenameU == NULL)
+		return NULL;
+
+	MEMFILE *b = NULL;
+
+#ifdef _WIN32
+	HANDLE hFile = CreateFileW(filenameU, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart > INT32_MAX)
+	{
+		CloseHandle(hFile);
+		return NULL;
+	}
+
+	if (fileSize.QuadPart > 0) // empty files can't be mapped
+	{
+		HANDLE hMap = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hMap != NULL)
+		{
+			const uint8_t *data = (const uint8_t *)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+			if (data != NULL)
+				b = mopen(data, (uint32_t)fileSize.QuadPart);
+
+			if (b != NULL)
+			{
+				b->_type = MEMFILE_MAPPED;
+				b->_hMap = hMap;
+			}
+			else
+			{
+				if (data != NULL)
+					UnmapViewOfFile(data);
+
+				CloseHandle(hMap);
+			}
+		}
+	}
+
+	CloseHandle(hFile); // the mapping keeps the file open
+#else
+	const int fd = open(filenameU, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size > INT32_MAX)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	if (st.st_size > 0) // empty files can't be mapped
+	{
+		void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			b = mopen((const uint8_t *)data, (uint32_t)st.st_size);
+			if (b != NULL)
+				b->_type = MEMFILE_MAPPED;
+			else
+				munmap(data, (size_t)st.st_size);
+		}
+	}
+
+	close(fd); // the mapping keeps the file open
+#endif
+
+	if (b == NULL)
+		b = readWholeFile(filenameU);
+
+	return b;
+}
+
+void mclose(MEMFILE **buf)
+{
+	if (buf == NULL || *buf == NULL)
+		return;
+
+	MEMFILE *b = *buf;
+	if (b->_type == MEMFILE_MAPPED)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(b->_base);
+		CloseHandle(b->_hMap);
+#else
+		munmap((void *)b->_base, b->_size);
+#endif
+	}
+	else if (b->_type == MEMFILE_ALLOCATED)
+	{
+		free((void *)b->_base);
+	}
+
+	free(b);
+	*buf = NULL;
+}
+
+size_t mread(void *buffer, size_t size, size_t count, MEMFILE *buf)
+{
+	if (buf == NULL || buffer == NULL || size == 0 || count == 0)
+		return 0;
+
+	const size_t bytesLeft = (buf->_pos < buf->_size) ? (buf->_size - buf->_pos) : 0;
+
+	size_t length = bytesLeft + 1;
+	if (count <= bytesLeft / size) // can't overflow
+		length = size * count;
+
+	if (length > bytesLeft)
+	{
+		// like fread(), copy what's left (the last item is incomplete)
+		length = bytesLeft;
+		buf->_eof = true;
+	}
+
+	if (length > 0)
+	{
+		memcpy(buffer, &buf->_base[buf->_pos], length);
+		buf->_pos += (uint32_t)length;
+	}
+
+	return length / size;
+}
+
+size_t mreadAt(void *buffer, uint32_t offset, size_t length, MEMFILE *buf)
+{
+	if (buf == NULL || buffer == NULL || offset >= buf->_size)
+		return 0;
+
+	const size_t bytesLeft = buf->_size - offset;
+	if (length > bytesLeft)
+		length = bytesLeft;
+
+	memcpy(buffer, &buf->_base[offset], length);
+	return length;
+}
+
+int32_t mgetc(MEMFILE *buf)
+{
+	if (buf == NULL)
+		return EOF;
+
+	if (buf->_pos >= buf->_size)
+	{
+		buf->_eof = true;
+		return EOF;
+	}
+
+	return buf->_base[buf->_pos++];
+}
+
+int32_t mseek(MEMFILE *buf, int32_t offset, int32_t whence)
+{
+	if (buf == NULL)
+		return -1;
+
+	int64_t newPos;
+	switch (whence)
+	{
+		case SEEK_SET: newPos = offset; break;
+		case SEEK_CUR: newPos = (int64_t)buf->_pos + offset; break;
+		case SEEK_END: newPos = (int64_t)buf->_size + offset; break;
+		default: return -1;
+	}
+
+	if (newPos < 0 || newPos > UINT32_MAX)
+		return -1;
+
+	// like fseek(), seeking past the end is allowed (the next read fails)
+	buf->_pos = (uint32_t)newPos;
+	buf->_eof = false;
+
+	return 0;
+}
+
+uint32_t mtell(MEMFILE *buf)
+{
+	if (buf == NULL)
+		return 0;
+
+	return buf->_pos;
+}
+
+void mrewind(MEMFILE *buf)
+{
+	mseek(buf, 0, SEEK_SET);
+}
+
+bool meof(MEMFILE *buf)
+{
+	if (buf == NULL)
+		return true;
+
+	return buf->_eof;
+}
+
+uint32_t msize(MEMFILE *buf)
+{
+	if (buf == NULL)
+		return 0;
+
+	return buf->_size;
+}
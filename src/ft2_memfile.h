@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdio.h> // SEEK_SET/SEEK_CUR/SEEK_END
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_unicode.h"
+
+/* Read-only memory "file" with a cursor, used by the module loaders instead of FILE.
+** The functions work like their stdio counterparts, but they never read outside of the
+** buffer, so a broken (or truncated) file can't make a loader read out of bounds.
+*/
+
+typedef struct mem_t MEMFILE;
+
+MEMFILE *mopen(const uint8_t *src, uint32_t length); // the buffer is not copied, and not freed by mclose()
+MEMFILE *mopenFile(const UNICHAR *filenameU); // memory-maps the file (or reads all of it if that fails)
+void mclose(MEMFILE **buf);
+
+size_t mread(void *buffer, size_t size, size_t count, MEMFILE *buf); // returns number of whole items read
+size_t mreadAt(void *buffer, uint32_t offset, size_t length, MEMFILE *buf); // doesn't use the cursor (can be called from several threads)
+int32_t mgetc(MEMFILE *buf); // returns EOF (-1) at the end of the buffer
+int32_t mseek(MEMFILE *buf, int32_t offset, int32_t whence); // returns -1 if the new position would be negative
+uint32_t mtell(MEMFILE *buf);
+void mrewind(MEMFILE *buf);
+bool meof(MEMFILE *buf); // true after trying to read past the end (cleared by mseek())
+uint32_t msize(MEMFILE *buf);
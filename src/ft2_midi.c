@@ -15,6 +15,7 @@
 #include "ft2_audio.h"
 #include "ft2_mouse.h"
 #include "ft2_pattern_ed.h"
+#include "ft2_video.h"
 #include "ft2_structs.h"
 #include "rtmidi/rtmidi_c.h"
 
@@ -120,6 +121,8 @@ static void midiInCallback(double dTimeStamp, const unsigned char *message, size
 		else if (byte[0] >= 144 && byte[0] <= 144+15)       midiInKeyAction(byte[1], byte[2]);
 		else if (byte[0] >= 176 && byte[0] <= 176+15)   midiInControlChange(byte[1], byte[2]);
 		else if (byte[0] >= 224 && byte[0] <= 224+15) midiInPitchBendChange(byte[1], byte[2]);
+
+		wakeUpMainLoop(); // in case it's idling
 	}
 
 	(void)dTimeStamp;
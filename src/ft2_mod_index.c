@@ -0,0 +1,619 @@
+/*
+** Disk Op. module index (song title, format, channels etc. without loading the module)
+**
+** The directory reader thread reads the headers of the modules in the current directory
+** after listing it. The results are kept in a hash table keyed by the full path, and
+** are only valid if the file's size and modification time still match. The table is
+** saved next to the config file (modindex.bin), so re-opening an indexed directory
+** doesn't read any module headers.
+*/
+
+// for finding memory leaks in debug mode with Visual Studio
+#if defined _DEBUG && defined _MSC_VER
+#include <crtdbg.h>
+#endif
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "ft2_header.h"
+#include "ft2_unicode.h"
+#include "ft2_structs.h"
+#include "ft2_module_loader.h"
+#include "ft2_mod_index.h"
+
+#define INDEX_FILE_ID "FT2MIDX1"
+#define INDEX_MAX_ENTRIES 262144 // no new entries are added after this
+#define INDEX_INIT_TABLE_SIZE 1024 // must be a power of two
+#define HEADER_READ_LEN 1168 // enough for the STM order list, which is the last thing needed
+
+typedef struct indexEntry_t
+{
+	UNICHAR *pathU; // NULL = free slot
+	uint32_t hash;
+	int64_t size, mtime;
+	modInfo_t info;
+} indexEntry_t;
+
+static bool indexChanged;
+static uint32_t tableSize, numEntries;
+static indexEntry_t *table;
+static SDL_mutex *indexMutex;
+
+#define FNV_OFFSET_BASIS 2166136261UL
+
+static uint32_t addToPathHash(uint32_t hash, const UNICHAR *strU) // FNV-1a
+{
+	while (*strU != 0)
+	{
+		hash ^= (uint32_t)*strU++;
+		hash *= 16777619UL;
+	}
+
+	return hash;
+}
+
+static uint32_t getPathHash(const UNICHAR *pathU)
+{
+	return addToPathHash(FNV_OFFSET_BASIS, pathU);
+}
+
+static bool needsDelimiter(const UNICHAR *dirU, size_t dirLen) // see getFullPathU()
+{
+	return dirLen > 0 && dirU[dirLen-1] != DIR_DELIMITER;
+}
+
+static indexEntry_t *findSlot(indexEntry_t *slots, uint32_t slotsSize, const UNICHAR *pathU, uint32_t hash)
+{
+	uint32_t i = hash & (slotsSize-1);
+	while (slots[i].pathU != NULL)
+	{
+		if (slots[i].hash == hash && !UNICHAR_STRCMP(slots[i].pathU, pathU))
+			break;
+
+		i = (i + 1) & (slotsSize-1); // linear probing
+	}
+
+	return &slots[i];
+}
+
+// same as findSlot() with the full path of the file, but without building it (this is called when drawing the list)
+static indexEntry_t *findFileSlot(const UNICHAR *dirU, const UNICHAR *nameU)
+{
+	const UNICHAR delimiterU[2] = { DIR_DELIMITER, 0 };
+
+	const size_t dirLen = UNICHAR_STRLEN(dirU);
+	const bool addDelimiter = needsDelimiter(dirU, dirLen);
+
+	uint32_t hash = addToPathHash(FNV_OFFSET_BASIS, dirU);
+	if (addDelimiter)
+		hash = addToPathHash(hash, delimiterU);
+	hash = addToPathHash(hash, nameU);
+
+	uint32_t i = hash & (tableSize-1);
+	while (table[i].pathU != NULL)
+	{
+		const UNICHAR *pathU = table[i].pathU;
+		if (table[i].hash == hash && !UNICHAR_STRNCMP(pathU, dirU, dirLen))
+		{
+			pathU += dirLen;
+			if (!addDelimiter || *pathU++ == DIR_DELIMITER)
+			{
+				if (!UNICHAR_STRCMP(pathU, nameU))
+					return &table[i];
+			}
+		}
+
+		i = (i + 1) & (tableSize-1); // linear probing
+	}
+
+	return NULL;
+}
+
+static bool growTable(void)
+{
+	const uint32_t newSize = (tableSize == 0) ? INDEX_INIT_TABLE_SIZE : (tableSize * 2);
+
+	indexEntry_t *newTable = (indexEntry_t *)calloc(newSize, sizeof (indexEntry_t));
+	if (newTable == NULL)
+		return false;
+
+	for (uint32_t i = 0; i < tableSize; i++)
+	{
+		if (table[i].pathU != NULL)
+			*findSlot(newTable, newSize, table[i].pathU, table[i].hash) = table[i];
+	}
+
+	if (table != NULL)
+		free(table);
+
+	table = newTable;
+	tableSize = newSize;
+
+	return true;
+}
+
+// takes over pathU
+static void addEntry(UNICHAR *pathU, int64_t size, int64_t mtime, const modInfo_t *info)
+{
+	const uint32_t hash = getPathHash(pathU);
+
+	if ((numEntries+1)*2 > tableSize && (numEntries >= INDEX_MAX_ENTRIES || !growTable()))
+	{
+		// index full or out of memory, only update existing entries
+		indexEntry_t *slot = (tableSize > 0) ? findSlot(table, tableSize, pathU, hash) : NULL;
+		if (slot == NULL || slot->pathU == NULL)
+		{
+			free(pathU);
+			return;
+		}
+	}
+
+	indexEntry_t *slot = findSlot(table, tableSize, pathU, hash);
+	if (slot->pathU != NULL)
+		free(slot->pathU); // replace old entry
+	else
+		numEntries++;
+
+	slot->pathU = pathU;
+	slot->hash = hash;
+	slot->size = size;
+	slot->mtime = mtime;
+	slot->info = *info;
+
+	indexChanged = true;
+}
+
+static UNICHAR *getFullPathU(const UNICHAR *dirU, const UNICHAR *nameU)
+{
+	const size_t dirLen = UNICHAR_STRLEN(dirU);
+	const size_t nameLen = UNICHAR_STRLEN(nameU);
+
+	UNICHAR *pathU = (UNICHAR *)malloc((dirLen + 1 + nameLen + 1) * sizeof (UNICHAR));
+	if (pathU == NULL)
+		return NULL;
+
+	UNICHAR_STRCPY(pathU, dirU);
+	if (needsDelimiter(dirU, dirLen))
+	{
+		pathU[dirLen+0] = DIR_DELIMITER;
+		pathU[dirLen+1] = 0;
+	}
+	UNICHAR_STRCAT(pathU, nameU);
+
+	return pathU;
+}
+
+static bool getFileStamp(const UNICHAR *pathU, int64_t *size, int64_t *mtime)
+{
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_wstat64(pathU, &st) != 0)
+		return false;
+#else
+	struct stat st;
+	if (stat(pathU, &st) != 0)
+		return false;
+#endif
+
+	*size = (int64_t)st.st_size;
+	*mtime = (int64_t)st.st_mtime;
+	return true;
+}
+
+static uint16_t getLE16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static void copyTitle(char *dst, const uint8_t *src, int32_t maxLen)
+{
+	int32_t len = 0;
+	for (; len < maxLen && src[len] != '\0'; len++)
+		dst[len] = (src[len] < ' ' || src[len] > '~') ? ' ' : (char)src[len];
+
+	while (len > 0 && dst[len-1] == ' ')
+		len--; // remove trailing spaces
+
+	dst[len] = '\0';
+}
+
+static uint16_t getNumPatternsFromOrders(const uint8_t *orders, int32_t numOrders)
+{
+	uint8_t maxPattern = 0;
+	for (int32_t i = 0; i < numOrders; i++)
+	{
+		if (orders[i] > maxPattern)
+			maxPattern = orders[i];
+	}
+
+	return maxPattern + 1;
+}
+
+static uint8_t getMODChannels(const uint8_t *id)
+{
+	if (isdigit(id[0]) && id[1] == 'C' && id[2] == 'H' && id[3] == 'N') // xCHN
+		return id[0] - '0';
+
+	if (isdigit(id[0]) && isdigit(id[1]) && id[2] == 'C' && (id[3] == 'H' || id[3] == 'N')) // xxCH/xxCN
+		return ((id[0] - '0') * 10) + (id[1] - '0');
+
+	if (id[0] == 'F' && id[1] == 'A' && id[2] == '0') // FA0x
+		return id[3] - '0';
+
+	if (!memcmp("FLT8", id, 4) || !memcmp("EXO8", id, 4) || !memcmp("OKTA", id, 4) ||
+		!memcmp("OCTA", id, 4) || !memcmp("CD81", id, 4))
+	{
+		return 8;
+	}
+
+	if (!memcmp("CD61", id, 4))
+		return 6;
+
+	return 4;
+}
+
+// parses the few header fields shown in Disk Op. (h is zero-padded to HEADER_READ_LEN)
+static void parseModuleHeader(const uint8_t *h, modInfo_t *info)
+{
+	switch (info->format)
+	{
+		case MODULE_FORMAT_XM:
+		{
+			copyTitle(info->title, &h[17], 20);
+			info->songLength = getLE16(&h[64]);
+			info->numChannels = (uint8_t)getLE16(&h[68]);
+			info->numPatterns = getLE16(&h[70]);
+			info->numInstruments = getLE16(&h[72]);
+		}
+		break;
+
+		case MODULE_FORMAT_MOD:
+		{
+			copyTitle(info->title, &h[0], 20);
+			info->songLength = h[950];
+			info->numChannels = getMODChannels(&h[1080]);
+			info->numPatterns = getNumPatternsFromOrders(&h[952], 128);
+			info->numInstruments = 31;
+		}
+		break;
+
+		case MODULE_FORMAT_POSSIBLY_STK:
+		{
+			copyTitle(info->title, &h[0], 20);
+			info->songLength = h[470];
+			info->numChannels = 4;
+			info->numPatterns = getNumPatternsFromOrders(&h[472], 128);
+			info->numInstruments = 15;
+		}
+		break;
+
+		case MODULE_FORMAT_S3M:
+		{
+			copyTitle(info->title, &h[0], 28);
+			info->songLength = getLE16(&h[0x20]);
+			info->numInstruments = getLE16(&h[0x22]);
+			info->numPatterns = getLE16(&h[0x24]);
+
+			info->numChannels = 0;
+			for (int32_t i = 0; i < 32; i++)
+			{
+				if (h[0x40+i] < 16) // enabled PCM channel
+					info->numChannels++;
+			}
+		}
+		break;
+
+		case MODULE_FORMAT_STM:
+		{
+			copyTitle(info->title, &h[0], 20);
+			info->numChannels = 4;
+			info->numPatterns = h[0x21];
+			info->numInstruments = 31;
+
+			const uint8_t *orders = &h[1040];
+			info->songLength = 0;
+			while (info->songLength < 128 && orders[info->songLength] < 99)
+				info->songLength++;
+		}
+		break;
+
+		case MODULE_FORMAT_DIGI:
+		{
+			copyTitle(info->title, &h[610], 32);
+			info->numChannels = h[0x19];
+			info->numPatterns = h[0x2E] + 1;
+			info->songLength = h[0x2F] + 1;
+			info->numInstruments = 31;
+		}
+		break;
+
+		case MODULE_FORMAT_BEM:
+		{
+			info->numChannels = h[4];
+			info->songLength = getLE16(&h[5]);
+			info->numPatterns = getLE16(&h[9]);
+			info->numInstruments = getLE16(&h[13]);
+
+			uint16_t titleLen = getLE16(&h[0x132]);
+			if (titleLen > MOD_INDEX_TITLE_LEN)
+				titleLen = MOD_INDEX_TITLE_LEN;
+			copyTitle(info->title, &h[0x134], titleLen);
+		}
+		break;
+
+		default: break;
+	}
+}
+
+static bool readModuleInfo(const UNICHAR *pathU, modInfo_t *info)
+{
+	uint8_t header[HEADER_READ_LEN];
+
+	memset(info, 0, sizeof (modInfo_t));
+
+	MEMFILE *f = mopenFile(pathU); // memory-mapped, so only the header pages are actually read
+	if (f == NULL)
+		return false;
+
+	info->format = detectModule(f);
+	if (info->format != MODULE_FORMAT_UNKNOWN)
+	{
+		memset(header, 0, sizeof (header));
+		mread(header, 1, sizeof (header), f);
+		parseModuleHeader(header, info);
+	}
+
+	mclose(&f);
+	return true;
+}
+
+bool modIndexGetFileStamp(const UNICHAR *dirU, const UNICHAR *nameU, modFileStamp_t *stamp)
+{
+	UNICHAR *pathU = getFullPathU(dirU, nameU);
+	if (pathU == NULL)
+		return false;
+
+	const bool result = getFileStamp(pathU, &stamp->size, &stamp->mtime);
+
+	free(pathU);
+	return result;
+}
+
+bool modIndexGetInfo(const UNICHAR *dirU, const UNICHAR *nameU, const modFileStamp_t *stamp, modInfo_t *info)
+{
+	if (indexMutex == NULL)
+		return false;
+
+	bool found = false;
+
+	SDL_LockMutex(indexMutex);
+	if (tableSize > 0)
+	{
+		const indexEntry_t *slot = findFileSlot(dirU, nameU);
+		if (slot != NULL && slot->size == stamp->size && slot->mtime == stamp->mtime)
+		{
+			*info = slot->info;
+			found = true;
+		}
+	}
+	SDL_UnlockMutex(indexMutex);
+
+	return found;
+}
+
+bool modIndexUpdateFile(const UNICHAR *dirU, const UNICHAR *nameU, const modFileStamp_t *stamp) // returns false if the file was already indexed
+{
+	modInfo_t info;
+
+	if (indexMutex == NULL || modIndexGetInfo(dirU, nameU, stamp, &info))
+		return false;
+
+	UNICHAR *pathU = getFullPathU(dirU, nameU);
+	if (pathU == NULL)
+		return false;
+
+	// the header is read without holding the lock, since this can be slow (network drives)
+	if (!readModuleInfo(pathU, &info))
+	{
+		free(pathU);
+		return false;
+	}
+
+	SDL_LockMutex(indexMutex);
+	addEntry(pathU, stamp->size, stamp->mtime, &info);
+	SDL_UnlockMutex(indexMutex);
+
+	return true;
+}
+
+static UNICHAR *getIndexFilePathU(void) // same directory as the config file
+{
+	if (editor.configFileLocationU == NULL)
+		return NULL;
+
+	const int32_t ft2ConfPathLen = (int32_t)UNICHAR_STRLEN(editor.configFileLocationU);
+
+#ifdef _WIN32
+	const int32_t indexNameLen = (int32_t)UNICHAR_STRLEN(L"modindex.bin");
+	const int32_t ft2DotCfgStrLen = (int32_t)UNICHAR_STRLEN(L"FT2.CFG");
+#else
+	const int32_t indexNameLen = (int32_t)UNICHAR_STRLEN("modindex.bin");
+	const int32_t ft2DotCfgStrLen = (int32_t)UNICHAR_STRLEN("FT2.CFG");
+#endif
+
+	UNICHAR *filePathU = (UNICHAR *)malloc((ft2ConfPathLen + indexNameLen + 1) * sizeof (UNICHAR));
+	if (filePathU == NULL)
+		return NULL;
+
+	UNICHAR_STRCPY(filePathU, editor.configFileLocationU);
+	filePathU[ft2ConfPathLen-ft2DotCfgStrLen] = 0;
+
+#ifdef _WIN32
+	UNICHAR_STRCAT(filePathU, L"modindex.bin");
+#else
+	UNICHAR_STRCAT(filePathU, "modindex.bin");
+#endif
+
+	return filePathU;
+}
+
+/* File layout (native byte order and struct layout, the index is only a local cache):
+** ID, sizeof (UNICHAR), sizeof (modInfo_t), number of entries, then per entry:
+** path length, path, size, mtime, info
+*/
+static void loadIndexFile(void)
+{
+	char ID[8];
+	uint8_t unicharSize, infoSize;
+	uint32_t numFileEntries;
+
+	UNICHAR *filePathU = getIndexFilePathU();
+	if (filePathU == NULL)
+		return;
+
+	FILE *f = UNICHAR_FOPEN(filePathU, "rb");
+	free(filePathU);
+
+	if (f == NULL)
+		return; // not made yet
+
+	if (fread(ID, 1, 8, f) != 8 || memcmp(ID, INDEX_FILE_ID, 8) != 0 ||
+		fread(&unicharSize, 1, 1, f) != 1 || unicharSize != sizeof (UNICHAR) ||
+		fread(&infoSize, 1, 1, f) != 1 || infoSize != sizeof (modInfo_t) ||
+		fread(&numFileEntries, 4, 1, f) != 1 || numFileEntries > INDEX_MAX_ENTRIES)
+	{
+		fclose(f);
+		return; // unknown version, it will be overwritten
+	}
+
+	bool entriesRejected = false;
+	for (uint32_t i = 0; i < numFileEntries; i++)
+	{
+		uint16_t pathLen;
+		int64_t size, mtime;
+		modInfo_t info;
+
+		if (fread(&pathLen, 2, 1, f) != 1 || pathLen == 0 || pathLen > PATH_MAX)
+		{
+			entriesRejected = true;
+			break; // corrupt, the rest of the file can't be trusted
+		}
+
+		UNICHAR *pathU = (UNICHAR *)malloc((pathLen + 1) * sizeof (UNICHAR));
+		if (pathU == NULL)
+			break;
+
+		if (fread(pathU, sizeof (UNICHAR), pathLen, f) != pathLen ||
+			fread(&size, 8, 1, f) != 1 || fread(&mtime, 8, 1, f) != 1 ||
+			fread(&info, sizeof (modInfo_t), 1, f) != 1)
+		{
+			free(pathU);
+			break;
+		}
+
+		pathU[pathLen] = 0;
+		info.title[MOD_INDEX_TITLE_LEN] = '\0';
+
+		// the format is used as an index when drawing the list
+		if (info.format < MODULE_FORMAT_UNKNOWN || info.format > MODULE_FORMAT_BEM || size < 0 || UNICHAR_STRLEN(pathU) != pathLen)
+		{
+			free(pathU);
+			entriesRejected = true;
+			continue;
+		}
+
+		addEntry(pathU, size, mtime, &info);
+	}
+
+	fclose(f);
+	indexChanged = entriesRejected; // rewrite it without the bad entries
+}
+
+void modIndexSave(void)
+{
+	if (indexMutex == NULL)
+		return;
+
+	SDL_LockMutex(indexMutex);
+
+	if (indexChanged)
+	{
+		UNICHAR *filePathU = getIndexFilePathU();
+		FILE *f = (filePathU != NULL) ? UNICHAR_FOPEN(filePathU, "wb") : NULL;
+
+		if (f != NULL)
+		{
+			const uint8_t unicharSize = sizeof (UNICHAR);
+			const uint8_t infoSize = sizeof (modInfo_t);
+
+			fwrite(INDEX_FILE_ID, 1, 8, f);
+			fwrite(&unicharSize, 1, 1, f);
+			fwrite(&infoSize, 1, 1, f);
+			fwrite(&numEntries, 4, 1, f);
+
+			for (uint32_t i = 0; i < tableSize; i++)
+			{
+				const indexEntry_t *e = &table[i];
+				if (e->pathU == NULL)
+					continue;
+
+				const uint16_t pathLen = (uint16_t)UNICHAR_STRLEN(e->pathU);
+				fwrite(&pathLen, 2, 1, f);
+				fwrite(e->pathU, sizeof (UNICHAR), pathLen, f);
+				fwrite(&e->size, 8, 1, f);
+				fwrite(&e->mtime, 8, 1, f);
+				fwrite(&e->info, sizeof (modInfo_t), 1, f);
+			}
+
+			fclose(f);
+			indexChanged = false;
+		}
+
+		if (filePathU != NULL)
+			free(filePathU);
+	}
+
+	SDL_UnlockMutex(indexMutex);
+}
+
+void modIndexInit(void)
+{
+	indexMutex = SDL_CreateMutex();
+	if (indexMutex == NULL)
+		return; // the index is optional, Disk Op. works without it
+
+	loadIndexFile();
+}
+
+void modIndexClose(void)
+{
+	modIndexSave();
+
+	if (table != NULL)
+	{
+		for (uint32_t i = 0; i < tableSize; i++)
+		{
+			if (table[i].pathU != NULL)
+				free(table[i].pathU);
+		}
+
+		free(table);
+		table = NULL;
+	}
+
+	tableSize = numEntries = 0;
+
+	if (indexMutex != NULL)
+	{
+		SDL_DestroyMutex(indexMutex);
+		indexMutex = NULL;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_unicode.h"
+
+#define MOD_INDEX_TITLE_LEN 32
+
+typedef struct modInfo_t
+{
+	int8_t format; // MODULE_FORMAT_* (ft2_module_loader.h)
+	uint8_t numChannels;
+	uint16_t songLength, numPatterns, numInstruments;
+	char title[MOD_INDEX_TITLE_LEN+1];
+} modInfo_t;
+
+typedef struct modFileStamp_t // an index entry is only valid if the file still has the same size and modification time
+{
+	int64_t size, mtime;
+} modFileStamp_t;
+
+void modIndexInit(void); // loads the index file (if any)
+void modIndexClose(void); // saves the index file (if changed) and frees memory
+
+// these can be called from any thread
+bool modIndexGetFileStamp(const UNICHAR *dirU, const UNICHAR *nameU, modFileStamp_t *stamp); // false if the file can't be stat()ed
+bool modIndexGetInfo(const UNICHAR *dirU, const UNICHAR *nameU, const modFileStamp_t *stamp, modInfo_t *info); // false if not indexed (or changed)
+bool modIndexUpdateFile(const UNICHAR *dirU, const UNICHAR *nameU, const modFileStamp_t *stamp); // reads the module header if not indexed
+void modIndexSave(void);
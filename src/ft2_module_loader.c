@@ -25,28 +25,19 @@
 #include "ft2_video.h"
 #include "ft2_structs.h"
 #include "ft2_sysreqs.h"
+#include "ft2_module_loader.h"
+#include "ft2_workers.h"
+#include "ft2_autosave.h"
 
-bool detectBEM(FILE* f);
-bool loadBEM(FILE* f, uint32_t filesize);
+bool detectBEM(MEMFILE *f);
+bool loadBEM(MEMFILE *f, uint32_t filesize);
 
-bool loadDIGI(FILE *f, uint32_t filesize);
-bool loadMOD(FILE *f, uint32_t filesize);
-bool loadS3M(FILE *f, uint32_t filesize);
-bool loadSTK(FILE *f, uint32_t filesize);
-bool loadSTM(FILE *f, uint32_t filesize);
-bool loadXM(FILE *f, uint32_t filesize);
-
-enum
-{
-	FORMAT_UNKNOWN = 0,
-	FORMAT_POSSIBLY_STK = 1,
-	FORMAT_XM = 2,
-	FORMAT_MOD = 3,
-	FORMAT_S3M = 4,
-	FORMAT_STM = 5,
-	FORMAT_DIGI = 6,
-	FORMAT_BEM = 7
-};
+bool loadDIGI(MEMFILE *f, uint32_t filesize);
+bool loadMOD(MEMFILE *f, uint32_t filesize);
+bool loadS3M(MEMFILE *f, uint32_t filesize);
+bool loadSTK(MEMFILE *f, uint32_t filesize);
+bool loadSTM(MEMFILE *f, uint32_t filesize);
+bool loadXM(MEMFILE *f, uint32_t filesize);
 
 // file extensions accepted by Disk Op. in module mode
 char *supportedModExtensions[] =
@@ -66,6 +57,17 @@ instr_t *instrTmp[1+256];
 song_t songTmp;
 // --------------------------
 
+typedef struct smpDecodeJob_t
+{
+	sample_t *s;
+	int32_t length; // when queued (before a stereo sample's header was changed to mono)
+	uint8_t type, flags;
+	int8_t adpcmLUT[16];
+} smpDecodeJob_t;
+
+static int32_t numDecodeJobs, maxDecodeJobs;
+static smpDecodeJob_t *decodeJobs;
+
 static volatile bool musicIsLoading, moduleLoaded, moduleFailedToLoad;
 static SDL_Thread *thread;
 static uint8_t oldPlayMode;
@@ -73,55 +75,53 @@ static void setupLoadedModule(void);
 static void freeTmpModule(void);
 
 // Crude module detection routine. These aren't always accurate detections!
-static int8_t detectModule(FILE *f)
+int8_t detectModule(MEMFILE *f) // also used by the Disk Op. module index
 {
 	uint8_t D[256], I[4];
 
-	fseek(f, 0, SEEK_END);
-	uint32_t fileLength = (uint32_t)ftell(f);
-	rewind(f);
+	uint32_t fileLength = msize(f);
 
 	memset(D, 0, sizeof (D));
-	fread(D, 1, sizeof (D), f);
-	fseek(f, 1080, SEEK_SET); // MOD ID
+	mread(D, 1, sizeof (D), f);
+	mseek(f, 1080, SEEK_SET); // MOD ID
 	I[0] = I[1] = I[2] = I[3] = 0;
-	fread(I, 1, 4, f);
-	rewind(f);
+	mread(I, 1, 4, f);
+	mrewind(f);
 
 	// BEM ("UN05", from XM only, MikMod)
 	if (detectBEM(f))
-		return FORMAT_BEM;
+		return MODULE_FORMAT_BEM;
 
 	// DIGI Booster (non-Pro)
 	if (!memcmp("DIGI Booster module", &D[0x00], 19+1) && D[0x19] >= 1 && D[0x19] <= 8)
-		return FORMAT_DIGI;
+		return MODULE_FORMAT_DIGI;
 
 	// Scream Tracker 3 S3M (and compatible trackers)
 	if (!memcmp("SCRM", &D[0x2C], 4) && D[0x1D] == 16) // XXX: byte=16 in all cases?
-		return FORMAT_S3M;
+		return MODULE_FORMAT_S3M;
 
 	// Scream Tracker 2 STM
 	if ((!memcmp("!Scream!", &D[0x14], 8) || !memcmp("BMOD2STM", &D[0x14], 8) ||
 		 !memcmp("WUZAMOD!", &D[0x14], 8) || !memcmp("SWavePro", &D[0x14], 8)) && D[0x1D] == 2) // XXX: byte=2 for "WUZAMOD!"/"SWavePro" ?
 	{
-		return FORMAT_STM;
+		return MODULE_FORMAT_STM;
 	}
 
 	// Generic multi-channel MOD (1..9 channels)
 	if (isdigit(I[0]) && I[0] != '0' && I[1] == 'C' && I[2] == 'H' && I[3] == 'N') // xCHN
-		return FORMAT_MOD;
+		return MODULE_FORMAT_MOD;
 
 	// Digital Tracker (Atari Falcon)
 	if (I[0] == 'F' && I[1] == 'A' && I[2] == '0' && I[3] >= '4' && I[3] <= '8') // FA0x (x=4..8)
-		return FORMAT_MOD;
+		return MODULE_FORMAT_MOD;
 
 	// Generic multi-channel MOD (10..99 channels)
 	if (isdigit(I[0]) && isdigit(I[1]) && I[0] != '0' && I[2] == 'C' && I[3] == 'H') // xxCH
-		return FORMAT_MOD;
+		return MODULE_FORMAT_MOD;
 
 	// Generic multi-channel MOD (10..99 channels)
 	if (isdigit(I[0]) && isdigit(I[1]) && I[0] != '0' && I[2] == 'C' && I[3] == 'N') // xxCN (same as xxCH)
-		return FORMAT_MOD;
+		return MODULE_FORMAT_MOD;
 	
 	// ProTracker and generic MOD formats
 	if (!memcmp("M.K.", I, 4) || !memcmp("M!K!", I, 4) || !memcmp("NSMS", I, 4) ||
@@ -131,7 +131,7 @@ static int8_t detectModule(FILE *f)
 		!memcmp("CD61", I, 4) || !memcmp("CD81", I, 4) || !memcmp("OKTA", I, 4) ||
 		!memcmp("OCTA", I, 4))
 	{
-		return FORMAT_MOD;
+		return MODULE_FORMAT_MOD;
 	}
 
 	/* Check if the file is a .it module (Impulse Tracker, not supported).
@@ -139,14 +139,14 @@ static int8_t detectModule(FILE *f)
 	** reject them here instead of accidentally loading them as .STK
 	*/
 	if (!memcmp("IMPM", D, 4) && D[0x16] == 0)
-		return FORMAT_UNKNOWN;
+		return MODULE_FORMAT_UNKNOWN;
 
 	/* Fasttracker II XM and compatible trackers.
 	** Note: This test can falsely be true for STK modules (and non-supported files) where the
 	** first 17 bytes start with "Extended Module: ". This is unlikely to happen.
 	*/
 	if (!memcmp("Extended Module: ", &D[0x00], 17))
-		return FORMAT_XM;
+		return MODULE_FORMAT_XM;
 
 	/* Lastly, we assume that the file is either a 15-sample STK or an unsupported file.
 	** Let's assume it's an STK and do some sanity checks. If they fail, we have an
@@ -155,18 +155,678 @@ static int8_t detectModule(FILE *f)
 
 	// minimum and maximum (?) possible size for a supported STK
 	if (fileLength < 1624 || fileLength > 984634)
-		return FORMAT_UNKNOWN;
+		return MODULE_FORMAT_UNKNOWN;
 
 	// test STK numOrders+BPM for illegal values
-	fseek(f, 470, SEEK_SET);
+	mseek(f, 470, SEEK_SET);
 	D[0] = D[1] = 0;
-	fread(D, 1, 2, f);
-	rewind(f);
+	mread(D, 1, 2, f);
+	mrewind(f);
 
 	if (D[0] <= 128 && D[1] <= 220)
-		return FORMAT_POSSIBLY_STK;
+		return MODULE_FORMAT_POSSIBLY_STK;
+
+	return MODULE_FORMAT_UNKNOWN;
+}
+
+static void decodeSample(const smpDecodeJob_t *job)
+{
+	sample_t *s = job->s;
+	const bool sample16Bit = !!(job->flags & SAMPLE_16BIT);
+	const bool stereo = !!(job->flags & SAMPLE_STEREO);
+
+	switch (job->type)
+	{
+		default:
+		case SMP_DECODE_DELTA:
+			delta2Samp(s->dataPtr, job->length, job->flags);
+		break;
+
+		case SMP_DECODE_SIGN:
+		{
+			if (sample16Bit)
+				conv16BitSample(s->dataPtr, job->length, stereo);
+			else
+				conv8BitSample(s->dataPtr, job->length, stereo);
+		}
+		break;
+
+		case SMP_DECODE_ADPCM:
+		{
+			// decoded in place, every packed byte is read before it's overwritten
+			const int32_t dataLength = (job->length + 1) / 2;
+			const uint8_t *src = (const uint8_t *)s->dataPtr + dataLength;
+			int8_t *dst = s->dataPtr;
+
+			int8_t currSample = 0;
+			for (int32_t i = 0; i < dataLength; i++)
+			{
+				const uint8_t nibbles = src[i];
+
+				currSample += job->adpcmLUT[nibbles & 0x0F];
+				*dst++ = currSample;
+
+				currSample += job->adpcmLUT[nibbles >> 4];
+				*dst++ = currSample;
+			}
+		}
+		break;
+	}
+
+	if (stereo) // mixed to mono, dealloc unused memory
+		reallocateSmpData(s, s->length, sample16Bit);
+}
+
+void decodeSampleLater(sample_t *s, uint8_t type, bool stereo, const int8_t *adpcmLUT)
+{
+	smpDecodeJob_t job;
+
+	job.s = s;
+	job.length = s->length;
+	job.type = type;
+	job.flags = (s->flags & SAMPLE_16BIT) | (stereo ? SAMPLE_STEREO : 0);
+
+	if (adpcmLUT != NULL)
+		memcpy(job.adpcmLUT, adpcmLUT, sizeof (job.adpcmLUT));
+
+	if (numDecodeJobs == maxDecodeJobs)
+	{
+		const int32_t newMaxJobs = (maxDecodeJobs == 0) ? 256 : (maxDecodeJobs * 2);
+
+		smpDecodeJob_t *newPtr = (smpDecodeJob_t *)realloc(decodeJobs, newMaxJobs * sizeof (smpDecodeJob_t));
+		if (newPtr == NULL)
+		{
+			decodeSample(&job); // decode it right away instead
+			return;
+		}
+
+		decodeJobs = newPtr;
+		maxDecodeJobs = newMaxJobs;
+	}
+
+	decodeJobs[numDecodeJobs++] = job;
+}
+
+static void freeDecodeJobs(void)
+{
+	if (decodeJobs != NULL)
+	{
+		free(decodeJobs);
+		decodeJobs = NULL;
+	}
+
+	numDecodeJobs = maxDecodeJobs = 0;
+}
+
+static int compareDecodeJobs(const void *a, const void *b) // biggest first
+{
+	const smpDecodeJob_t *jobA = (const smpDecodeJob_t *)a;
+	const smpDecodeJob_t *jobB = (const smpDecodeJob_t *)b;
+
+	const int32_t bytesA = jobA->length << !!(jobA->flags & SAMPLE_16BIT);
+	const int32_t bytesB = jobB->length << !!(jobB->flags & SAMPLE_16BIT);
+
+	return (bytesA < bytesB) - (bytesA > bytesB);
+}
+
+static int compareSampleLengths(const void *a, const void *b) // biggest first
+{
+	const sample_t *smpA = *(sample_t * const *)a;
+	const sample_t *smpB = *(sample_t * const *)b;
+
+	const int32_t bytesA = SAMPLE_LENGTH_BYTES(smpA);
+	const int32_t bytesB = SAMPLE_LENGTH_BYTES(smpB);
+
+	return (bytesA < bytesB) - (bytesA > bytesB);
+}
+
+static void decodeSamplesChunk(int32_t start, int32_t end, void *userData)
+{
+	for (int32_t i = start; i < end; i++)
+		decodeSample(&decodeJobs[i]);
+
+	(void)userData;
+}
+
+static void fixSamplesChunk(int32_t start, int32_t end, void *userData)
+{
+	sample_t **samples = (sample_t **)userData;
+	for (int32_t i = start; i < end; i++)
+	{
+		sanitizeSample(samples[i]);
+		fixSample(samples[i]); // prepare sample for branchless linear interpolation
+	}
+}
+
+/* Decodes the samples queued with decodeSampleLater() and prepares all samples for the mixer,
+** one sample per task on the worker threads. This is done in the loader thread, so the loaded
+** module is only handed over to the replayer (setupLoadedModule()) when all samples are ready.
+*/
+static void decodeAndFixSamples(void)
+{
+	qsort(decodeJobs, numDecodeJobs, sizeof (smpDecodeJob_t), compareDecodeJobs);
+	parallelForEach(numDecodeJobs, decodeSamplesChunk, NULL);
+	freeDecodeJobs();
+
+	sample_t **samples = (sample_t **)malloc(MAX_INST * MAX_SMP_PER_INST * sizeof (sample_t *));
+
+	int32_t numSamples = 0;
+	for (int32_t i = 1; i <= MAX_INST; i++)
+	{
+		if (instrTmp[i] == NULL)
+			continue;
+
+		for (int32_t j = 0; j < MAX_SMP_PER_INST; j++)
+		{
+			sample_t *s = &instrTmp[i]->smp[j];
+			if (s->dataPtr == NULL)
+				continue;
+
+			if (samples != NULL)
+			{
+				samples[numSamples++] = s;
+			}
+			else // out of memory, do it here
+			{
+				sanitizeSample(s);
+				fixSample(s);
+			}
+		}
+	}
+
+	if (samples != NULL)
+	{
+		qsort(samples, numSamples, sizeof (sample_t *), compareSampleLengths);
+		parallelForEach(numSamples, fixSamplesChunk, samples);
+		free(samples);
+	}
+}
+
+enum
+{
+	LAZY_SMP_QUEUED = 0,
+	LAZY_SMP_LOADING = 1, // being read and decoded (with the mutex unlocked)
+	LAZY_SMP_CANCELLED = 2, // instrument was freed while loading
+	LAZY_SMP_READY = 3, // waiting to be handed over to the instrument (main thread)
+	LAZY_SMP_DONE = 4
+};
+
+typedef struct lazySample_t
+{
+	int16_t insNum, smpNum, firstOrder;
+	uint32_t fileOffset, dataLength;
+	volatile int8_t state;
+	sample_t smp; // the header until loaded, then the loaded (and fixed) sample
+	smpDecodeJob_t job;
+} lazySample_t;
+
+// built by the loader thread, handed over to the session in setupLoadedModule()
+static int32_t numQueuedLazySmps, maxQueuedLazySmps;
+static lazySample_t *queuedLazySmps;
+static MEMFILE *queuedLazyFile;
+
+// the session
+static volatile bool lazyLoading, lazyStopThread, lazyOutOfMemory, lazyInstrWanted[1+MAX_INST];
+static int32_t numLazySmps;
+static lazySample_t *lazySmps;
+static MEMFILE *lazyFile;
+static SDL_mutex *lazyMutex;
+static SDL_Thread *lazyThread;
+
+bool loadSampleLater(int16_t insNum, int16_t smpNum, sample_t *s, uint32_t fileOffset, uint32_t dataLength,
+	uint8_t type, bool stereo, const int8_t *adpcmLUT)
+{
+	if (numQueuedLazySmps == maxQueuedLazySmps)
+	{
+		const int32_t newMaxSmps = (maxQueuedLazySmps == 0) ? 256 : (maxQueuedLazySmps * 2);
+
+		lazySample_t *newPtr = (lazySample_t *)realloc(queuedLazySmps, newMaxSmps * sizeof (lazySample_t));
+		if (newPtr == NULL)
+			return false;
+
+		queuedLazySmps = newPtr;
+		maxQueuedLazySmps = newMaxSmps;
+	}
+
+	lazySample_t *l = &queuedLazySmps[numQueuedLazySmps++];
+	memset(l, 0, sizeof (lazySample_t));
+
+	l->insNum = insNum;
+	l->smpNum = smpNum;
+	l->fileOffset = fileOffset;
+	l->dataLength = dataLength;
+	l->state = LAZY_SMP_QUEUED;
+
+	l->job.length = s->length;
+	l->job.type = type;
+	l->job.flags = (s->flags & SAMPLE_16BIT) | (stereo ? SAMPLE_STEREO : 0);
+	if (adpcmLUT != NULL)
+		memcpy(l->job.adpcmLUT, adpcmLUT, sizeof (l->job.adpcmLUT));
+
+	l->smp.length = s->length;
+	l->smp.loopStart = s->loopStart;
+	l->smp.loopLength = s->loopLength;
+	l->smp.flags = s->flags & ~SAMPLE_STEREO;
+
+	if (stereo) // mixed to mono when decoded
+	{
+		l->smp.length >>= 1;
+		l->smp.loopStart >>= 1;
+		l->smp.loopLength >>= 1;
+	}
+
+	// the sample is empty until the data is loaded
+	s->length = 0;
+	s->loopStart = 0;
+	s->loopLength = 0;
+
+	return true;
+}
+
+static void freeQueuedLazySamples(void) // called on module load error
+{
+	if (queuedLazySmps != NULL)
+	{
+		free(queuedLazySmps);
+		queuedLazySmps = NULL;
+	}
+
+	numQueuedLazySmps = maxQueuedLazySmps = 0;
+	mclose(&queuedLazyFile);
+}
+
+/* Called with lazyMutex locked, which is unlocked while allocating, reading and decoding.
+** The data is read without the shared file cursor, so the main thread can load a sample too.
+*/
+static void loadLazySample(lazySample_t *l)
+{
+	sample_t *s = &l->smp;
+	const bool sample16Bit = !!(l->job.flags & SAMPLE_16BIT);
+
+	l->state = LAZY_SMP_LOADING;
+	SDL_UnlockMutex(lazyMutex);
+
+	if (!allocateSmpData(s, l->job.length, sample16Bit))
+	{
+		lazyOutOfMemory = true;
+
+		SDL_LockMutex(lazyMutex);
+		l->state = LAZY_SMP_DONE; // the sample stays empty
+		return;
+	}
+
+	int8_t *dst = s->dataPtr;
+	if (l->job.type == SMP_DECODE_ADPCM) // see loadADPCMSample() in the XM loader
+	{
+		dst += (l->job.length + 1) / 2;
+		memset(dst, 0xFF, l->dataLength);
+	}
+
+	mreadAt(dst, l->fileOffset, l->dataLength, lazyFile);
+
+	l->job.s = s;
+	decodeSample(&l->job);
+	sanitizeSample(s);
+	fixSample(s);
+
+	SDL_LockMutex(lazyMutex);
+
+	if (l->state == LAZY_SMP_CANCELLED)
+	{
+		freeSmpData(s);
+		l->state = LAZY_SMP_DONE;
+	}
+	else
+	{
+		l->state = LAZY_SMP_READY;
+	}
+}
+
+static void installLazySample(lazySample_t *l) // called with lazyMutex locked, from the main thread
+{
+	sample_t *src = &l->smp;
+	l->state = LAZY_SMP_DONE;
+
+	sample_t *s = (instr[l->insNum] != NULL) ? &instr[l->insNum]->smp[l->smpNum] : NULL;
+	if (s == NULL || s->dataPtr != NULL) // shouldn't happen, the instrument would have cancelled it
+	{
+		freeSmpData(src);
+		return;
+	}
+
+	const bool audioWasntLocked = !audio.locked;
+	if (audioWasntLocked)
+		lockAudio();
+
+	// the name, volume etc. may have been changed since the module was loaded, so only copy the sample data fields
+	s->flags = src->flags;
+	s->length = src->length;
+	s->loopStart = src->loopStart;
+	s->loopLength = src->loopLength;
+	s->isFixed = src->isFixed;
+	s->fixedPos = src->fixedPos;
+	memcpy(s->leftEdgeTapSamples8, src->leftEdgeTapSamples8, sizeof (s->leftEdgeTapSamples8));
+	memcpy(s->leftEdgeTapSamples16, src->leftEdgeTapSamples16, sizeof (s->leftEdgeTapSamples16));
+	memcpy(s->fixedSmp, src->fixedSmp, sizeof (s->fixedSmp));
+	s->dataGeneration = src->dataGeneration;
+	s->peakDataValid = false;
+
+	// the scopes test dataPtr before reading the rest, so set it last
+	s->origDataPtr = src->origDataPtr;
+	SDL_MemoryBarrierRelease();
+	s->dataPtr = src->dataPtr;
+
+	if (audioWasntLocked)
+		unlockAudio();
+
+	src->origDataPtr = src->dataPtr = NULL; // the float sample cache goes with the data
+
+	autosaveLazySampleLoaded(l->insNum, l->smpNum);
+}
+
+static lazySample_t *getNextLazySample(void) // called with lazyMutex locked
+{
+	lazySample_t *next = NULL;
+
+	lazySample_t *l = lazySmps;
+	for (int32_t i = 0; i < numLazySmps; i++, l++)
+	{
+		if (l->state != LAZY_SMP_QUEUED)
+			continue;
 
-	return FORMAT_UNKNOWN;
+		if (lazyInstrWanted[l->insNum])
+			return l;
+
+		if (next == NULL)
+			next = l; // sorted by first use in the song
+	}
+
+	return next;
+}
+
+static int32_t SDLCALL lazyLoadThread(void *ptr)
+{
+	SDL_LockMutex(lazyMutex);
+	while (!lazyStopThread)
+	{
+		lazySample_t *l = getNextLazySample();
+		if (l == NULL)
+			break;
+
+		loadLazySample(l);
+	}
+	SDL_UnlockMutex(lazyMutex);
+
+	return true;
+	(void)ptr;
+}
+
+static int compareLazySamples(const void *a, const void *b) // first used in the song first
+{
+	const lazySample_t *smpA = (const lazySample_t *)a;
+	const lazySample_t *smpB = (const lazySample_t *)b;
+
+	if (smpA->firstOrder != smpB->firstOrder)
+		return smpA->firstOrder - smpB->firstOrder;
+
+	if (smpA->insNum != smpB->insNum)
+		return smpA->insNum - smpB->insNum;
+
+	return smpA->smpNum - smpB->smpNum;
+}
+
+static void sortLazySamples(void)
+{
+	int16_t firstOrder[1+MAX_INST];
+	bool pattScanned[MAX_PATTERNS];
+
+	for (int32_t i = 0; i <= MAX_INST; i++)
+		firstOrder[i] = MAX_ORDERS; // not used in the song, loaded last
+
+	memset(pattScanned, 0, sizeof (pattScanned));
+
+	for (int16_t i = 0; i < song.songLength; i++)
+	{
+		const uint8_t pattNum = song.orders[i];
+		if (pattScanned[pattNum] || pattern[pattNum] == NULL)
+			continue;
+
+		pattScanned[pattNum] = true;
+
+		const note_t *p = pattern[pattNum];
+		for (int32_t j = 0; j < patternNumRows[pattNum] * MAX_CHANNELS; j++, p++)
+		{
+			if (p->instr > 0 && p->instr <= MAX_INST && firstOrder[p->instr] > i)
+				firstOrder[p->instr] = i;
+		}
+	}
+
+	for (int32_t i = 0; i < numLazySmps; i++)
+		lazySmps[i].firstOrder = firstOrder[lazySmps[i].insNum];
+
+	qsort(lazySmps, numLazySmps, sizeof (lazySample_t), compareLazySamples);
+}
+
+static void endLazySampleLoading(void) // called from the main thread
+{
+	if (!lazyLoading)
+		return;
+
+	lazyStopThread = true;
+	if (lazyThread != NULL)
+	{
+		SDL_WaitThread(lazyThread, NULL);
+		lazyThread = NULL;
+	}
+
+	SDL_LockMutex(lazyMutex); // cancelLazySamples() can be called from other threads
+
+	for (int32_t i = 0; i < numLazySmps; i++)
+		freeSmpData(&lazySmps[i].smp); // samples that were loaded but not handed over
+
+	free(lazySmps);
+	lazySmps = NULL;
+	numLazySmps = 0;
+
+	mclose(&lazyFile);
+	lazyLoading = false;
+
+	SDL_UnlockMutex(lazyMutex);
+}
+
+static void startLazySampleLoading(void) // called from setupLoadedModule()
+{
+	if (numQueuedLazySmps == 0)
+		return;
+
+	if (lazyMutex == NULL)
+	{
+		lazyMutex = SDL_CreateMutex();
+		if (lazyMutex == NULL)
+		{
+			freeQueuedLazySamples();
+			okBox(0, "System message", "Couldn't create mutex! The samples can't be loaded.", NULL);
+			return;
+		}
+	}
+
+	lazySmps = queuedLazySmps;
+	numLazySmps = numQueuedLazySmps;
+	lazyFile = queuedLazyFile;
+
+	queuedLazySmps = NULL;
+	numQueuedLazySmps = maxQueuedLazySmps = 0;
+	queuedLazyFile = NULL;
+
+	sortLazySamples();
+
+	memset((void *)lazyInstrWanted, 0, sizeof (lazyInstrWanted));
+	lazyStopThread = false;
+	lazyLoading = true;
+
+	lazyThread = SDL_CreateThread(lazyLoadThread, NULL, NULL);
+	// if this fails, the samples are loaded when they are needed (or by lazyLoadAllSamples())
+}
+
+void lazyLoadInstrument(int16_t insNum) // called from the main thread
+{
+	if (!lazyLoading || insNum < 1 || insNum > MAX_INST)
+		return;
+
+	SDL_LockMutex(lazyMutex);
+	while (true)
+	{
+		bool waitForThread = false;
+
+		lazySample_t *l = lazySmps;
+		for (int32_t i = 0; i < numLazySmps; i++, l++)
+		{
+			if (l->insNum != insNum)
+				continue;
+
+			if (l->state == LAZY_SMP_QUEUED)
+				loadLazySample(l);
+
+			if (l->state == LAZY_SMP_LOADING)
+				waitForThread = true;
+			else if (l->state == LAZY_SMP_READY)
+				installLazySample(l);
+		}
+
+		if (!waitForThread)
+			break;
+
+		// the loader thread is decoding one of the samples
+		SDL_UnlockMutex(lazyMutex);
+		SDL_Delay(1);
+		SDL_LockMutex(lazyMutex);
+	}
+	SDL_UnlockMutex(lazyMutex);
+}
+
+void lazyLoadAllSamples(void) // called from the main thread
+{
+	if (!lazyLoading)
+		return;
+
+	// the loader thread keeps going in parallel
+	for (int16_t i = 1; i <= MAX_INST; i++)
+		lazyLoadInstrument(i);
+
+	endLazySampleLoading();
+}
+
+void lazySampleWanted(int16_t insNum) // called from the replayer (audio thread)
+{
+	if (lazyLoading && insNum >= 1 && insNum <= MAX_INST)
+		lazyInstrWanted[insNum] = true;
+}
+
+void cancelLazySamples(int16_t insNum) // don't call this with the audio locked (see installLazySample())
+{
+	if (!lazyLoading || insNum < 1 || insNum > MAX_INST)
+		return;
+
+	SDL_LockMutex(lazyMutex);
+	if (!lazyLoading) // ended while waiting for the mutex
+	{
+		SDL_UnlockMutex(lazyMutex);
+		return;
+	}
+
+	lazySample_t *l = lazySmps;
+	for (int32_t i = 0; i < numLazySmps; i++, l++)
+	{
+		if (l->insNum != insNum)
+			continue;
+
+		if (l->state == LAZY_SMP_LOADING)
+		{
+			l->state = LAZY_SMP_CANCELLED; // freed when done
+		}
+		else if (l->state != LAZY_SMP_CANCELLED)
+		{
+			freeSmpData(&l->smp);
+			l->state = LAZY_SMP_DONE;
+		}
+	}
+
+	SDL_UnlockMutex(lazyMutex);
+}
+
+void stopLazySampleLoading(void)
+{
+	endLazySampleLoading();
+}
+
+// called from the main thread, hands the loaded samples over to the instruments
+void handleLazySampleEvents(void)
+{
+	if (!lazyLoading)
+		return;
+
+	if (lazyOutOfMemory)
+	{
+		lazyOutOfMemory = false;
+		okBox(0, "System message", "Not enough memory! Some samples couldn't be loaded.", NULL);
+	}
+
+	if (lazyThread == NULL) // couldn't create the loader thread, load the wanted instruments here
+	{
+		for (int16_t i = 1; i <= MAX_INST; i++)
+		{
+			if (lazyInstrWanted[i])
+			{
+				lazyInstrWanted[i] = false;
+				lazyLoadInstrument(i);
+			}
+		}
+	}
+
+	bool allDone = true;
+
+	SDL_LockMutex(lazyMutex);
+
+	lazySample_t *l = lazySmps;
+	for (int32_t i = 0; i < numLazySmps; i++, l++)
+	{
+		if (l->state == LAZY_SMP_READY)
+			installLazySample(l);
+		else if (l->state != LAZY_SMP_DONE)
+			allDone = false;
+	}
+
+	SDL_UnlockMutex(lazyMutex);
+
+	if (allDone)
+		endLazySampleLoading();
+}
+
+static void loadModuleFromMemFile(MEMFILE *f) // the file can be memory-mapped or any buffer in memory
+{
+	const int8_t format = detectModule(f);
+	const uint32_t filesize = msize(f);
+
+	mrewind(f);
+	switch (format)
+	{
+		case MODULE_FORMAT_XM: moduleLoaded = loadXM(f, filesize); break;
+		case MODULE_FORMAT_S3M: moduleLoaded = loadS3M(f, filesize); break;
+		case MODULE_FORMAT_STM: moduleLoaded = loadSTM(f, filesize); break;
+		case MODULE_FORMAT_MOD: moduleLoaded = loadMOD(f, filesize); break;
+		case MODULE_FORMAT_POSSIBLY_STK: moduleLoaded = loadSTK(f, filesize); break;
+		case MODULE_FORMAT_DIGI: moduleLoaded = loadDIGI(f, filesize); break;
+		case MODULE_FORMAT_BEM: moduleLoaded = loadBEM(f, filesize); break;
+
+		default:
+			loaderMsgBox("This file is not a supported module!");
+		break;
+	}
+
+	if (moduleLoaded)
+		decodeAndFixSamples();
+
+	freeDecodeJobs(); // if the loader failed
 }
 
 static bool doLoadMusic(bool externalThreadFlag)
@@ -181,33 +841,19 @@ static bool doLoadMusic(bool externalThreadFlag)
 		goto loadError;
 	}
 
-	FILE *f = UNICHAR_FOPEN(editor.tmpFilenameU, "rb");
+	MEMFILE *f = mopenFile(editor.tmpFilenameU);
 	if (f == NULL)
 	{
 		loaderMsgBox("General I/O error during loading! Is the file in use? Does it exist?");
 		goto loadError;
 	}
 
-	int8_t format = detectModule(f);
-	fseek(f, 0, SEEK_END);
-	uint32_t filesize = ftell(f);
-
-	rewind(f);
-	switch (format)
-	{
-		case FORMAT_XM: moduleLoaded = loadXM(f, filesize); break;
-		case FORMAT_S3M: moduleLoaded = loadS3M(f, filesize); break;
-		case FORMAT_STM: moduleLoaded = loadSTM(f, filesize); break;
-		case FORMAT_MOD: moduleLoaded = loadMOD(f, filesize); break;
-		case FORMAT_POSSIBLY_STK: moduleLoaded = loadSTK(f, filesize); break;
-		case FORMAT_DIGI: moduleLoaded = loadDIGI(f, filesize); break;
-		case FORMAT_BEM: moduleLoaded = loadBEM(f, filesize); break;
+	loadModuleFromMemFile(f);
 
-		default:
-			loaderMsgBox("This file is not a supported module!");
-		break;
-	}
-	fclose(f);
+	if (moduleLoaded && numQueuedLazySmps > 0)
+		queuedLazyFile = f; // the sample data is loaded from it later
+	else
+		mclose(&f);
 
 	if (!moduleLoaded)
 		goto loadError;
@@ -318,6 +964,8 @@ bool allocateTmpInstr(int16_t insNum)
 
 static void freeTmpModule(void) // called on module load error
 {
+	freeQueuedLazySamples();
+
 	// free all patterns
 	for (int32_t i = 0; i < MAX_PATTERNS; i++)
 	{
@@ -415,9 +1063,9 @@ static void setupLoadedModule(void)
 			{
 				sample_t *s = &instr[i]->smp[j];
 
-				sanitizeSample(s);
-				if (s->dataPtr != NULL)
-					fixSample(s); // prepare sample for branchless linear interpolation
+				// samples with data were sanitized and fixed by the loader thread (decodeAndFixSamples())
+				if (s->dataPtr == NULL)
+					sanitizeSample(s);
 			}
 		}
 	}
@@ -471,6 +1119,8 @@ static void setupLoadedModule(void)
 		}
 	}
 
+	startLazySampleLoading(); // for huge modules, the sample data is loaded from now on (needs the sanitized song)
+
 	setScrollBarEnd(SB_POS_ED, (song.songLength - 1) + 5);
 	setScrollBarPos(SB_POS_ED, 0, false);
 
@@ -502,6 +1152,9 @@ static void setupLoadedModule(void)
 	resetPlaybackTime();
 
 	diskOpSetFilename(DISKOP_ITEM_MODULE, editor.tmpFilenameU);
+	resetAutosave(editor.tmpFilenameU); // the loaded module is the new base of the autosave journal
+
+	lazyLoadInstrument(editor.curInstr); // shown in the instrument/sample editor
 
 	// redraw top part of screen
 	if (ui.extended)
@@ -595,18 +1248,18 @@ bool handleModuleLoadFromArg(int argc, char **argv)
 
 static bool fileIsModule(UNICHAR *pathU)
 {
-	FILE *f = UNICHAR_FOPEN(pathU, "rb");
+	MEMFILE *f = mopenFile(pathU);
 	if (f == NULL)
 		return false;
 
 	int8_t modFormat = detectModule(f);
-	fclose(f);
+	mclose(&f);
 
 	/* If the module was not identified (possibly STK type),
 	** check the file extension and handle it as a module only
 	** if it starts with "mod."/"stk." or ends with ".mod"/".stk" (case insensitive).
 	*/
-	if (modFormat == FORMAT_POSSIBLY_STK)
+	if (modFormat == MODULE_FORMAT_POSSIBLY_STK)
 	{
 		char *path = unicharToCp437(pathU, false);
 		if (path == NULL)
@@ -648,7 +1301,7 @@ static bool fileIsModule(UNICHAR *pathU)
 		return false;
 	}
 
-	return (modFormat != FORMAT_UNKNOWN);
+	return (modFormat != MODULE_FORMAT_UNKNOWN);
 }
 
 void loadDroppedFile(char *fullPathUTF8, bool songModifiedCheck)
@@ -4,7 +4,53 @@
 #include <stdbool.h>
 #include "ft2_header.h"
 #include "ft2_unicode.h"
+#include "ft2_memfile.h"
 
+enum
+{
+	MODULE_FORMAT_UNKNOWN = 0,
+	MODULE_FORMAT_POSSIBLY_STK = 1,
+	MODULE_FORMAT_XM = 2,
+	MODULE_FORMAT_MOD = 3,
+	MODULE_FORMAT_S3M = 4,
+	MODULE_FORMAT_STM = 5,
+	MODULE_FORMAT_DIGI = 6,
+	MODULE_FORMAT_BEM = 7
+};
+
+enum // decodeSampleLater() types
+{
+	SMP_DECODE_DELTA = 0, // delta values (XM/BEM)
+	SMP_DECODE_SIGN = 1, // unsigned to signed (S3M)
+	SMP_DECODE_ADPCM = 2 // 4-bit ADPCM (ModPlug XM), the packed bytes are stored at dataPtr+((length+1)/2)
+};
+
+/* Called by the loaders after reading the raw sample data (before the header of a stereo
+** sample is changed to mono). The sample is decoded (stereo samples are also mixed to mono
+** and shrunk) after the loader is done, on all CPU cores.
+*/
+void decodeSampleLater(sample_t *s, uint8_t type, bool stereo, const int8_t *adpcmLUT);
+
+/* Lazy sample loading for huge modules (XM files of LAZY_LOAD_MIN_FILESIZE or more).
+** The loader only records where the sample data is in the (memory-mapped) file, and the
+** sample is left empty. Once the module is set up, the samples are loaded in the background,
+** starting with the instruments that are used first in the song. The current instrument and
+** the instruments triggered by the replayer are loaded first.
+*/
+#define LAZY_LOAD_MIN_FILESIZE (64*1024*1024)
+
+// called by the loader instead of reading the sample data (before the header of a stereo sample is changed to mono)
+bool loadSampleLater(int16_t insNum, int16_t smpNum, sample_t *s, uint32_t fileOffset, uint32_t dataLength,
+	uint8_t type, bool stereo, const int8_t *adpcmLUT);
+
+void lazyLoadInstrument(int16_t insNum); // waits until the samples of the instrument are loaded
+void lazyLoadAllSamples(void); // waits until all samples are loaded (call before saving etc.)
+void lazySampleWanted(int16_t insNum); // called by the replayer when an empty sample is triggered
+void cancelLazySamples(int16_t insNum); // called when an instrument is freed (can be called from any thread)
+void stopLazySampleLoading(void); // called when all instruments are freed
+void handleLazySampleEvents(void);
+
+int8_t detectModule(MEMFILE *f); // crude, see comments in the function
 bool tmpPatternEmpty(uint16_t pattNum);
 void clearUnusedChannels(note_t *p, int16_t numRows, int32_t numChannels);
 bool allocateTmpInstr(int16_t insNum);
@@ -4,17 +4,38 @@
 #endif
 
 #include <stdio.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define WIN32_MEAN_AND_LEAN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
 #include "ft2_header.h"
 #include "ft2_audio.h"
 #include "ft2_gui.h"
 #include "ft2_mouse.h"
 #include "ft2_sample_ed.h"
 #include "ft2_module_loader.h"
+#include "ft2_module_saver.h"
+#include "ft2_autosave.h"
+#include "ft2_diskop.h"
 #include "ft2_tables.h"
 #include "ft2_structs.h"
 
-static int8_t smpChunkBuf[1024];
+#define SAVE_FILE_BUFFER_SIZE (1024*1024)
+#define SMP_SAVE_CHUNK_SIZE 65536 // in bytes
+
+#ifdef _WIN32
+#define TMP_FILE_EXT L".tmp"
+#else
+#define TMP_FILE_EXT ".tmp"
+#endif
+
+static volatile bool musicIsSaving;
 static uint8_t packedPattData[65536], modPattData[64*32*4];
 static SDL_Thread *thread;
 
@@ -26,11 +47,219 @@ static const char modIDs[32][5] =
 	"25CH", "26CH", "27CH", "28CH", "29CH", "30CH", "31CH", "32CH"
 };
 
-static uint16_t packPatt(uint8_t *writePtr, uint8_t *pattPtr, uint16_t numRows);
+static uint16_t packPatt(uint8_t *writePtr, uint8_t *pattPtr, uint16_t numRows, int32_t numChannels);
 
-bool saveXM(UNICHAR *filenameU)
+void freeSnapshot(saveSnapshot_t *snap)
+{
+	if (snap->ownsData)
+	{
+		for (int32_t i = 0; i < MAX_PATTERNS; i++)
+		{
+			if (snap->pattern[i] != NULL)
+				free(snap->pattern[i]);
+		}
+
+		for (int32_t i = 1; i <= MAX_INST; i++)
+		{
+			if (snap->instr[i] == NULL)
+				continue;
+
+			for (int32_t j = 0; j < MAX_SMP_PER_INST; j++)
+				freeSmpData(&snap->instr[i]->smp[j]); // releases the shared sample data
+
+			free(snap->instr[i]);
+		}
+	}
+
+	if (snap->filenameU != NULL)
+		free(snap->filenameU);
+
+	free(snap);
+}
+
+saveSnapshot_t *takeSnapshot(UNICHAR *filenameU, uint8_t saveMode, bool copyData)
 {
-	int16_t i, j, k, a;
+	saveSnapshot_t *snap = (saveSnapshot_t *)calloc(1, sizeof (saveSnapshot_t));
+	if (snap == NULL)
+		return NULL;
+
+	snap->ownsData = copyData;
+	snap->saveMode = saveMode;
+
+	snap->filenameU = (filenameU != NULL) ? UNICHAR_STRDUP(filenameU) : NULL;
+	if (filenameU != NULL && snap->filenameU == NULL)
+	{
+		freeSnapshot(snap);
+		return NULL;
+	}
+
+	if (copyData) // the replayer changes the song struct while playing (don't lock the audio in the crash handler)
+		lockAudio();
+
+	memcpy(&snap->song, &song, sizeof (song_t));
+	snap->linearPeriodsFlag = audio.linearPeriodsFlag;
+
+	if (copyData)
+		unlockAudio();
+
+	for (int32_t i = 0; i < MAX_PATTERNS; i++)
+	{
+		snap->patternNumRows[i] = patternNumRows[i];
+		snap->patternIsEmpty[i] = patternEmpty((uint16_t)i);
+
+		if (pattern[i] == NULL)
+			continue;
+
+		if (!copyData)
+		{
+			snap->pattern[i] = pattern[i];
+			continue;
+		}
+
+		const size_t pattBytes = patternNumRows[i] * TRACK_WIDTH;
+
+		snap->pattern[i] = (note_t *)malloc(pattBytes);
+		if (snap->pattern[i] == NULL)
+		{
+			freeSnapshot(snap);
+			return NULL;
+		}
+
+		memcpy(snap->pattern[i], pattern[i], pattBytes);
+	}
+
+	for (int16_t i = 1; i <= MAX_INST; i++)
+	{
+		snap->usedSamples[i] = getUsedSamples(i);
+		snap->realUsedSamples[i] = getRealUsedSamples(i);
+
+		if (instr[i] == NULL)
+			continue;
+
+		if (!copyData)
+		{
+			snap->instr[i] = instr[i];
+			continue;
+		}
+
+		snap->instr[i] = (instr_t *)malloc(sizeof (instr_t));
+		if (snap->instr[i] == NULL)
+		{
+			freeSnapshot(snap);
+			return NULL;
+		}
+
+		memcpy(snap->instr[i], instr[i], sizeof (instr_t));
+		for (int32_t j = 0; j < MAX_SMP_PER_INST; j++)
+			referenceSample(&instr[i]->smp[j], &snap->instr[i]->smp[j]);
+	}
+
+	// count number of patterns (XM)
+	int16_t numPatterns = MAX_PATTERNS;
+	while (numPatterns > 0 && snap->patternIsEmpty[numPatterns-1])
+		numPatterns--;
+	snap->numPatterns = numPatterns;
+
+	// count number of instruments (XM)
+	int16_t numInstr = 128;
+	while (numInstr > 0 && snap->usedSamples[numInstr] == 0 && snap->song.instrName[numInstr][0] == '\0')
+		numInstr--;
+	snap->numInstr = numInstr;
+
+	return snap;
+}
+
+// writes the sample data delta encoded (XM/XI), the sample is left unchanged (its data can be shared)
+bool writeDeltaSampleData(FILE *f, const sample_t *s)
+{
+	if (s->dataPtr == NULL || s->length <= 0)
+		return true;
+
+	const bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
+	const int32_t chunkLength = SMP_SAVE_CHUNK_SIZE >> sample16Bit;
+
+	int8_t *chunk = (int8_t *)malloc(SMP_SAVE_CHUNK_SIZE);
+	if (chunk == NULL)
+		return false;
+
+	int16_t lastSmp = 0; // last sample of the previous chunk (before encoding)
+	for (int32_t pos = 0; pos < s->length; pos += chunkLength)
+	{
+		int32_t length = s->length - pos;
+		if (length > chunkLength)
+			length = chunkLength;
+
+		copyUnfixedSampleData(s, chunk, pos, length);
+
+		if (sample16Bit)
+		{
+			int16_t *chunk16 = (int16_t *)chunk;
+			const int16_t newLastSmp = chunk16[length-1];
+
+			samp2Delta(chunk, length, s->flags);
+			chunk16[0] -= lastSmp;
+			lastSmp = newLastSmp;
+		}
+		else
+		{
+			const int8_t newLastSmp = chunk[length-1];
+
+			samp2Delta(chunk, length, s->flags);
+			chunk[0] -= (int8_t)lastSmp;
+			lastSmp = newLastSmp;
+		}
+
+		const size_t bytes = (size_t)length << sample16Bit;
+		if (fwrite(chunk, 1, bytes, f) != bytes)
+		{
+			free(chunk);
+			return false;
+		}
+	}
+
+	free(chunk);
+	return true;
+}
+
+// writes 'numSamples' samples as 8-bit (MOD), the sample is left unchanged (its data can be shared)
+static bool writeMODSampleData(FILE *f, const sample_t *s, int32_t numSamples)
+{
+	const bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
+	const int32_t chunkLength = SMP_SAVE_CHUNK_SIZE >> sample16Bit;
+
+	int8_t *chunk = (int8_t *)malloc(SMP_SAVE_CHUNK_SIZE);
+	if (chunk == NULL)
+		return false;
+
+	for (int32_t pos = 0; pos < numSamples; pos += chunkLength)
+	{
+		int32_t length = numSamples - pos;
+		if (length > chunkLength)
+			length = chunkLength;
+
+		copyUnfixedSampleData(s, chunk, pos, length);
+
+		if (sample16Bit) // convert to 8-bit (in place)
+		{
+			const int16_t *chunk16 = (const int16_t *)chunk;
+			for (int32_t i = 0; i < length; i++)
+				chunk[i] = chunk16[i] >> 8;
+		}
+
+		if (fwrite(chunk, 1, length, f) != (size_t)length)
+		{
+			free(chunk);
+			return false;
+		}
+	}
+
+	free(chunk);
+	return true;
+}
+
+static bool writeXM(FILE *f, const saveSnapshot_t *snap)
+{
+	int16_t i, k, a;
 	size_t result;
 	xmHdr_t h;
 	xmPatHdr_t ph;
@@ -39,23 +268,16 @@ bool saveXM(UNICHAR *filenameU)
 	sample_t *s;
 	xmSmpHdr_t *dst;
 
-	FILE *f = UNICHAR_FOPEN(filenameU, "wb");
-	if (f == NULL)
-	{
-		okBoxThreadSafe(0, "System message", "Error opening file for saving, is it in use?", NULL);
-		return false;
-	}
-
 	memcpy(h.ID, "Extended Module: ", 17);
 
 	// song name
-	int32_t nameLength = (int32_t)strlen(song.name);
+	int32_t nameLength = (int32_t)strlen(snap->song.name);
 	if (nameLength > 20)
 		nameLength = 20;
 
 	memset(h.name, ' ', 20); // yes, FT2 pads the name with spaces
 	if (nameLength > 0)
-		memcpy(h.name, song.name, nameLength);
+		memcpy(h.name, snap->song.name, nameLength);
 
 	h.x1A = 0x1A;
 
@@ -70,77 +292,48 @@ bool saveXM(UNICHAR *filenameU)
 
 	h.version = 0x0104;
 	h.headerSize = 20 + 256;
-	h.numOrders = song.songLength;
-	h.songLoopStart = song.songLoopStart;
-	h.numChannels = (uint16_t)song.numChannels;
-	h.speed = song.speed;
-	h.BPM = song.BPM;
-
-	// count number of patterns
-	i = MAX_PATTERNS;
-	do
-	{
-		if (patternEmpty(i-1))
-			i--;
-		else
-			break;
-	}
-	while (i > 0);
-	h.numPatterns = i;
-
-	// count number of instruments
-	i = 128;
-	while (i > 0 && getUsedSamples(i) == 0 && song.instrName[i][0] == '\0')
-		i--;
-	h.numInstr = i;
-
-	h.flags = audio.linearPeriodsFlag;
-	memcpy(h.orders, song.orders, 256);
+	h.numOrders = snap->song.songLength;
+	h.songLoopStart = snap->song.songLoopStart;
+	h.numChannels = (uint16_t)snap->song.numChannels;
+	h.speed = snap->song.speed;
+	h.BPM = snap->song.BPM;
+	h.numPatterns = snap->numPatterns;
+	h.numInstr = snap->numInstr;
+	h.flags = snap->linearPeriodsFlag;
+	memcpy(h.orders, snap->song.orders, 256);
 
 	if (fwrite(&h, sizeof (h), 1, f) != 1)
 	{
-		fclose(f);
 		okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
 		return false;
 	}
 
 	for (i = 0; i < h.numPatterns; i++)
 	{
-		if (patternEmpty(i))
-		{
-			if (pattern[i] != NULL)
-			{
-				free(pattern[i]);
-				pattern[i] = NULL;
-			}
-
-			patternNumRows[i] = 64;
-		}
-
 		ph.headerSize = sizeof (xmPatHdr_t);
-		ph.numRows = patternNumRows[i];
 		ph.type = 0;
 
-		if (pattern[i] == NULL)
+		if (snap->patternIsEmpty[i])
 		{
+			ph.numRows = 64;
 			ph.dataSize = 0;
+
 			if (fwrite(&ph, ph.headerSize, 1, f) != 1)
 			{
-				fclose(f);
 				okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
 				return false;
 			}
 		}
 		else
 		{
-			ph.dataSize = packPatt(packedPattData, (uint8_t *)pattern[i], patternNumRows[i]);
+			ph.numRows = snap->patternNumRows[i];
+			ph.dataSize = packPatt(packedPattData, (uint8_t *)snap->pattern[i], ph.numRows, snap->song.numChannels);
 
 			result = fwrite(&ph, ph.headerSize, 1, f);
 			result += fwrite(packedPattData, ph.dataSize, 1, f);
 
 			if (result != 2) // write was not OK
 			{
-				fclose(f);
 				okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
 				return false;
 			}
@@ -151,20 +344,15 @@ bool saveXM(UNICHAR *filenameU)
 
 	for (i = 1; i <= h.numInstr; i++)
 	{
-		if (instr[i] == NULL)
-			j = 0;
-		else
-			j = i;
-
-		a = getUsedSamples(i);
+		a = snap->usedSamples[i];
 
-		nameLength = (int32_t)strlen(song.instrName[i]);
+		nameLength = (int32_t)strlen(snap->song.instrName[i]);
 		if (nameLength > 22)
 			nameLength = 22;
 
 		memset(ih.name, 0, 22); // pad with zero
 		if (nameLength > 0)
-			memcpy(ih.name, song.instrName[i], nameLength);
+			memcpy(ih.name, snap->song.instrName[i], nameLength);
 
 		ih.type = 0;
 		ih.numSamples = a;
@@ -172,7 +360,7 @@ bool saveXM(UNICHAR *filenameU)
 
 		if (a > 0)
 		{
-			ins = instr[j];
+			ins = snap->instr[i];
 
 			memcpy(ih.note2SampleLUT, ins->note2SampleLUT, 96);
 			memcpy(ih.volEnvPoints, ins->volEnvPoints, 12*2*sizeof(int16_t));
@@ -198,10 +386,10 @@ bool saveXM(UNICHAR *filenameU)
 			ih.midiBend = ins->midiBend;
 			ih.mute = ins->mute ? 1 : 0;
 			ih.instrSize = INSTR_HEADER_SIZE;
-			
+
 			for (k = 0; k < a; k++)
 			{
-				s = &instr[j]->smp[k];
+				s = &ins->smp[k];
 				dst = &ih.smp[k];
 
 				bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
@@ -244,45 +432,24 @@ bool saveXM(UNICHAR *filenameU)
 
 		if (fwrite(&ih, ih.instrSize + (a * sizeof (xmSmpHdr_t)), 1, f) != 1)
 		{
-			fclose(f);
 			okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
 			return false;
 		}
 
-		for (k = 1; k <= a; k++)
+		for (k = 0; k < a; k++)
 		{
-			s = &instr[j]->smp[k-1];
-			if (s->dataPtr != NULL)
+			if (!writeDeltaSampleData(f, &snap->instr[i]->smp[k]))
 			{
-				unfixSample(s);
-				samp2Delta(s->dataPtr, s->length, s->flags);
-
-				result = fwrite(s->dataPtr, 1, SAMPLE_LENGTH_BYTES(s), f);
-
-				delta2Samp(s->dataPtr, s->length, s->flags);
-				fixSample(s);
-
-				if (result != (size_t)SAMPLE_LENGTH_BYTES(s)) // write not OK
-				{
-					fclose(f);
-					okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
-					return false;
-				}
+				okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
+				return false;
 			}
 		}
 	}
 
-	removeSongModifiedFlag();
-
-	fclose(f);
-
-	editor.diskOpReadDir = true; // force diskop re-read
-
-	setMouseBusy(false);
 	return true;
 }
 
-static bool saveMOD(UNICHAR *filenameU)
+static bool writeMOD(FILE *f, const saveSnapshot_t *snap)
 {
 	int16_t i;
 	int32_t j, k;
@@ -296,7 +463,7 @@ static bool saveMOD(UNICHAR *filenameU)
 		okBoxThreadSafe(0, "System message", "Warning: \"Frequency slides\" is not set to Amiga!");
 	*/
 
-	int32_t songLength = song.songLength;
+	int32_t songLength = snap->song.songLength;
 	if (songLength > 128)
 	{
 		songLength = 128;
@@ -307,8 +474,8 @@ static bool saveMOD(UNICHAR *filenameU)
 	int32_t numPatterns = 0;
 	for (i = 0; i < songLength; i++)
 	{
-		if (song.orders[i] > numPatterns)
-			numPatterns = song.orders[i];
+		if (snap->song.orders[i] > numPatterns)
+			numPatterns = snap->song.orders[i];
 	}
 	numPatterns++;
 
@@ -321,7 +488,7 @@ static bool saveMOD(UNICHAR *filenameU)
 	// check if song has more than 31 instruments
 	for (i = 32; i <= 128; i++)
 	{
-		if (getRealUsedSamples(i) > 0)
+		if (snap->realUsedSamples[i] > 0)
 		{
 			okBoxThreadSafe(0, "System message", "Warning: Song has more than 31 instruments!", NULL);
 			break;
@@ -333,7 +500,7 @@ static bool saveMOD(UNICHAR *filenameU)
 	bool test2 = false;
 	for (i = 1; i <= 31; i++)
 	{
-		ins = instr[i];
+		ins = snap->instr[i];
 		if (ins == NULL)
 			continue;
 
@@ -351,13 +518,13 @@ static bool saveMOD(UNICHAR *filenameU)
 	test = false;
 	for (i = 1; i <= 31; i++)
 	{
-		ins = instr[i];
+		ins = snap->instr[i];
 		if (ins == NULL)
 			continue;
 
 		smp = &ins->smp[0];
 
-		j = getRealUsedSamples(i);
+		j = snap->realUsedSamples[i];
 		if (j > 1)
 		{
 			test = true;
@@ -383,23 +550,23 @@ static bool saveMOD(UNICHAR *filenameU)
 
 	for (i = 0; i < numPatterns; i++)
 	{
-		if (pattern[i] == NULL)
+		if (snap->pattern[i] == NULL)
 			continue;
 
-		if (patternNumRows[i] < 64)
+		if (snap->patternNumRows[i] < 64)
 		{
 			okBoxThreadSafe(0, "System message", "Error: Pattern lengths can't be below 64! Module wasn't saved.", NULL);
 			return false;
 		}
 
-		if (patternNumRows[i] > 64)
+		if (snap->patternNumRows[i] > 64)
 			tooLongPatterns = true;
 
 		for (j = 0; j < 64; j++)
 		{
-			for (k = 0; k < song.numChannels; k++)
+			for (k = 0; k < snap->song.numChannels; k++)
 			{
-				note_t *p = &pattern[i][(j * MAX_CHANNELS) + k];
+				note_t *p = &snap->pattern[i][(j * MAX_CHANNELS) + k];
 
 				if (p->instr > 31)
 					tooManyInstr = true;
@@ -424,43 +591,43 @@ static bool saveMOD(UNICHAR *filenameU)
 	memset(&hdr, 0, sizeof (hdr));
 
 	// song name
-	int32_t nameLength = (int32_t)strlen(song.name);
+	int32_t nameLength = (int32_t)strlen(snap->song.name);
 	if (nameLength > 20)
 		nameLength = 20;
 
 	memset(hdr.name, 0, 20); // pad with zeroes
 	if (nameLength > 0)
-		memcpy(hdr.name, song.name, nameLength);
+		memcpy(hdr.name, snap->song.name, nameLength);
 
 	hdr.numOrders = (uint8_t)songLength; // pre-clamped to 0..128
 
-	hdr.songLoopStart = (uint8_t)song.songLoopStart;
+	hdr.songLoopStart = (uint8_t)snap->song.songLoopStart;
 	if (hdr.songLoopStart >= hdr.numOrders) // repeat-point must be lower than the song length
 		hdr.songLoopStart = 0;
 
-	memcpy(hdr.orders, song.orders, hdr.numOrders);
+	memcpy(hdr.orders, snap->song.orders, hdr.numOrders);
 
-	if (song.numChannels == 4)
+	if (snap->song.numChannels == 4)
 		memcpy(hdr.ID, (numPatterns > 64) ? "M!K!" : "M.K.", 4);
 	else
-		memcpy(hdr.ID, modIDs[song.numChannels-1], 4);
+		memcpy(hdr.ID, modIDs[snap->song.numChannels-1], 4);
 
 	// fill MOD sample headers
 	for (i = 1; i <= 31; i++)
 	{
 		modSmpHdr_t *modSmp = &hdr.smp[i-1];
 
-		nameLength = (int32_t)strlen(song.instrName[i]);
+		nameLength = (int32_t)strlen(snap->song.instrName[i]);
 		if (nameLength > 22)
 			nameLength = 22;
 
 		memset(modSmp->name, 0, 22); // pad with zeroes
 		if (nameLength > 0)
-			memcpy(modSmp->name, song.instrName[i], nameLength);
+			memcpy(modSmp->name, snap->song.instrName[i], nameLength);
 
-		if (instr[i] != NULL && getRealUsedSamples(i) != 0)
+		if (snap->instr[i] != NULL && snap->realUsedSamples[i] != 0)
 		{
-			smp = &instr[i]->smp[0];
+			smp = &snap->instr[i]->smp[0];
 
 			int32_t length = smp->length >> 1;
 			int32_t loopStart = smp->loopStart >> 1;
@@ -496,25 +663,18 @@ static bool saveMOD(UNICHAR *filenameU)
 		}
 	}
 
-	FILE *f = UNICHAR_FOPEN(filenameU, "wb");
-	if (f == NULL)
-	{
-		okBoxThreadSafe(0, "System message", "Error opening file for saving, is it in use?", NULL);
-		return false;
-	}
-
 	// write header
 	if (fwrite(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
 	{
 		okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
-		goto modSaveError;
+		return false;
 	}
 
 	// write pattern data
-	const int32_t patternBytes = song.numChannels * 64 * 4;
+	const int32_t patternBytes = snap->song.numChannels * 64 * 4;
 	for (i = 0; i < numPatterns; i++)
 	{
-		if (pattern[i] == NULL) // empty pattern
+		if (snap->pattern[i] == NULL) // empty pattern
 		{
 			memset(modPattData, 0, patternBytes);
 		}
@@ -523,9 +683,9 @@ static bool saveMOD(UNICHAR *filenameU)
 			int32_t offs = 0;
 			for (j = 0; j < 64; j++)
 			{
-				for (k = 0; k < song.numChannels; k++)
+				for (k = 0; k < snap->song.numChannels; k++)
 				{
-					note_t *p = &pattern[i][(j * MAX_CHANNELS) + k];
+					note_t *p = &snap->pattern[i][(j * MAX_CHANNELS) + k];
 
 					uint8_t inst = p->instr;
 					uint8_t note = p->note;
@@ -573,113 +733,197 @@ static bool saveMOD(UNICHAR *filenameU)
 		if (fwrite(modPattData, 1, patternBytes, f) != (size_t)patternBytes)
 		{
 			okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
-			goto modSaveError;
+			return false;
 		}
 	}
 
 	// write sample data
 	for (i = 1; i <= 31; i++)
 	{
-		if (instr[i] == NULL || getRealUsedSamples(i) == 0)
+		if (snap->instr[i] == NULL || snap->realUsedSamples[i] == 0)
 			continue;
 
-		smp = &instr[i]->smp[0];
+		smp = &snap->instr[i]->smp[0];
 		if (smp->dataPtr == NULL || smp->length <= 0)
 			continue;
 
-		modSmpHdr_t *modSmp = &hdr.smp[i-1];
-
-		unfixSample(smp);
+		const int32_t sampleBytes = SWAP16(hdr.smp[i-1].length) * 2;
+		if (!writeMODSampleData(f, smp, sampleBytes))
+		{
+			okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
+			return false;
+		}
+	}
 
-		int32_t sampleBytes = SWAP16(modSmp->length) * 2;
+	return true;
+}
 
-		if (smp->flags & SAMPLE_16BIT) // 16-bit sample (convert to 8-bit)
-		{
-			int8_t *dstPtr = (int8_t *)smpChunkBuf;
-			int32_t writeLen = sampleBytes;
-			int32_t samplesWritten = 0;
 
-			while (samplesWritten < writeLen) // write in chunks
-			{
-	 			int32_t samplesToWrite = sizeof (smpChunkBuf);
-				if (samplesWritten+samplesToWrite > writeLen)
-					samplesToWrite = writeLen - samplesWritten;
+bool replaceFile(UNICHAR *srcU, UNICHAR *dstU)
+{
+#ifdef _WIN32
+	return MoveFileExW(srcU, dstU, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	// the new file gets the permissions of the old one, not the ones from our umask
+	struct stat st;
+	if (stat(dstU, &st) == 0)
+		chmod(srcU, st.st_mode & 07777);
+
+	return rename(srcU, dstU) == 0; // atomic
+#endif
+}
 
-				int16_t *srcPtr16 = (int16_t *)smp->dataPtr + samplesWritten;
-				for (j = 0; j < samplesToWrite; j++)
-					dstPtr[j] = srcPtr16[j] >> 8; // convert 16-bit to 8-bit
+/* The module is written to "<filename>.tmp" which then replaces the file, so the old
+** file is left untouched if the save fails halfway (disk full, crash etc.).
+** If the file is a symlink, the file it points to is replaced instead of the link.
+*/
+static bool saveSnapshotToFile(saveSnapshot_t *snap)
+{
+	UNICHAR *dstFilenameU = snap->filenameU;
+#ifndef _WIN32
+	char *realFilename = realpath(snap->filenameU, NULL); // NULL if the file doesn't exist yet
+	if (realFilename != NULL)
+		dstFilenameU = realFilename;
+#endif
 
-				if (fwrite(dstPtr, 1, samplesToWrite, f) != (size_t)samplesToWrite)
-				{
-					fixSample(smp);
-					okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
-					goto modSaveError;
-				}
+	UNICHAR *tmpFilenameU = (UNICHAR *)malloc((UNICHAR_STRLEN(dstFilenameU) + 4 + 1) * sizeof (UNICHAR));
+	if (tmpFilenameU == NULL)
+	{
+#ifndef _WIN32
+		free(realFilename);
+#endif
+		okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+		return false;
+	}
 
-				samplesWritten += samplesToWrite;
-			}
-		}
-		else // 8-bit sample
-		{
-			if (fwrite(smp->dataPtr, 1, sampleBytes, f) != (size_t)sampleBytes)
-			{
-				fixSample(smp);
-				okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
-				goto modSaveError;
-			}
-		}
+	UNICHAR_STRCPY(tmpFilenameU, dstFilenameU);
+	UNICHAR_STRCAT(tmpFilenameU, TMP_FILE_EXT);
 
-		fixSample(smp);
+	FILE *f = UNICHAR_FOPEN(tmpFilenameU, "wb");
+	if (f == NULL)
+	{
+#ifndef _WIN32
+		free(realFilename);
+#endif
+		free(tmpFilenameU);
+		okBoxThreadSafe(0, "System message", "Error opening file for saving, is it in use?", NULL);
+		return false;
 	}
 
-	fclose(f);
-	removeSongModifiedFlag();
+	setvbuf(f, NULL, _IOFBF, SAVE_FILE_BUFFER_SIZE);
 
-	editor.diskOpReadDir = true; // force diskop re-read
+	bool result;
+	if (snap->saveMode == MOD_SAVE_MODE_XM)
+		result = writeXM(f, snap);
+	else
+		result = writeMOD(f, snap);
 
-	setMouseBusy(false);
-	return true;
+	if (fclose(f) != 0 && result)
+	{
+		okBoxThreadSafe(0, "System message", "Error saving module: general I/O error!", NULL);
+		result = false;
+	}
 
-modSaveError:
-	fclose(f);
-	return false;
+	if (result && !replaceFile(tmpFilenameU, dstFilenameU))
+	{
+		okBoxThreadSafe(0, "System message", "Error saving module: couldn't replace the file!", NULL);
+		result = false;
+	}
+
+	if (!result)
+		UNICHAR_REMOVE(tmpFilenameU);
+
+#ifndef _WIN32
+	free(realFilename);
+#endif
+	free(tmpFilenameU);
+	return result;
 }
 
 static int32_t SDLCALL saveMusicThread(void *ptr)
 {
-	assert(editor.tmpFilenameU != NULL);
-	if (editor.tmpFilenameU == NULL)
-		return false;
-
-	pauseAudio();
+	saveSnapshot_t *snap = (saveSnapshot_t *)ptr;
 
-	if (editor.moduleSaveMode == 1)
-		saveXM(editor.tmpFilenameU);
+	if (saveSnapshotToFile(snap))
+		editor.diskOpReadDir = true; // force diskop re-read
 	else
-		saveMOD(editor.tmpFilenameU);
+	{
+		setSongModifiedFlag(); // the song was not saved after all
+		if (snap->saveMode == MOD_SAVE_MODE_XM)
+			autosaveSaveFailed();
+	}
+
+	freeSnapshot(snap);
+	musicIsSaving = false;
 
-	resumeAudio();
 	return true;
+}
 
-	(void)ptr;
+bool isMusicSaving(void)
+{
+	return musicIsSaving;
 }
 
 void saveMusic(UNICHAR *filenameU)
 {
-	UNICHAR_STRCPY(editor.tmpFilenameU, filenameU);
+	if (musicIsSaving)
+	{
+		okBox(0, "System message", "The previous save is still in progress, please wait.", NULL);
+		return;
+	}
+
+	lazyLoadAllSamples(); // huge module, the samples may not all be loaded yet
 
-	mouseAnimOn();
-	thread = SDL_CreateThread(saveMusicThread, NULL, NULL);
+	saveSnapshot_t *snap = takeSnapshot(filenameU, editor.moduleSaveMode, true);
+	if (snap == NULL)
+	{
+		okBox(0, "System message", "Not enough memory!", NULL);
+		return;
+	}
+
+	/* The song is saved as it is now, so edits made while the thread is
+	** writing correctly flag the song as modified again.
+	*/
+	const bool songWasModified = song.isModified;
+	removeSongModifiedFlag();
+
+	if (snap->saveMode == MOD_SAVE_MODE_XM)
+		resetAutosave(filenameU); // the saved module is the new base of the autosave journal
+
+	musicIsSaving = true;
+	thread = SDL_CreateThread(saveMusicThread, NULL, snap);
 	if (thread == NULL)
 	{
-		okBoxThreadSafe(0, "System message", "Couldn't create thread!", NULL);
+		musicIsSaving = false;
+		freeSnapshot(snap);
+
+		if (songWasModified)
+			setSongModifiedFlag();
+
+		if (editor.moduleSaveMode == MOD_SAVE_MODE_XM)
+			autosaveSaveFailed();
+
+		okBox(0, "System message", "Couldn't create thread!", NULL);
 		return;
 	}
 
 	SDL_DetachThread(thread);
 }
 
-static uint16_t packPatt(uint8_t *writePtr, uint8_t *pattPtr, uint16_t numRows)
+// used by the crash handler, saves the song directly (no copies, no thread)
+bool saveXM(UNICHAR *filenameU)
+{
+	saveSnapshot_t *snap = takeSnapshot(filenameU, MOD_SAVE_MODE_XM, false);
+	if (snap == NULL)
+		return false;
+
+	const bool result = saveSnapshotToFile(snap);
+
+	freeSnapshot(snap);
+	return result;
+}
+
+static uint16_t packPatt(uint8_t *writePtr, uint8_t *pattPtr, uint16_t numRows, int32_t numChannels)
 {
 	uint8_t bytes[5];
 
@@ -688,10 +932,10 @@ static uint16_t packPatt(uint8_t *writePtr, uint8_t *pattPtr, uint16_t numRows)
 
 	uint16_t totalPackLen = 0;
 
-	const int32_t pitch = sizeof (note_t) * (MAX_CHANNELS - song.numChannels);
+	const int32_t pitch = sizeof (note_t) * (MAX_CHANNELS - numChannels);
 	for (int32_t row = 0; row < numRows; row++)
 	{
-		for (int32_t chn = 0; chn < song.numChannels; chn++)
+		for (int32_t chn = 0; chn < numChannels; chn++)
 		{
 			bytes[0] = *pattPtr++;
 			bytes[1] = *pattPtr++;
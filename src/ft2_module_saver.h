@@ -1,8 +1,35 @@
 #pragma once
 
+#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "ft2_replayer.h"
 #include "ft2_unicode.h"
 
-void saveMusic(UNICHAR *filenameU);
-bool saveXM(UNICHAR *filenameU);
+/* A snapshot of the song, taken on the main thread. It has the song header, copies of the
+** patterns, and copies of the instruments. The copied samples share the sample data with
+** the song, which is copy-on-write (makeSampleDataUnique()), so taking the snapshot is cheap.
+** Module saving and autosaving write the snapshot on a thread while the editor stays usable.
+*/
+typedef struct saveSnapshot_t
+{
+	bool ownsData; // false = patterns and instruments point to the song (crash backup)
+	bool linearPeriodsFlag;
+	uint8_t saveMode;
+	int16_t numPatterns, numInstr; // XM
+	int16_t patternNumRows[MAX_PATTERNS], usedSamples[1+MAX_INST], realUsedSamples[1+MAX_INST];
+	bool patternIsEmpty[MAX_PATTERNS];
+	note_t *pattern[MAX_PATTERNS];
+	instr_t *instr[1+MAX_INST];
+	song_t song;
+	UNICHAR *filenameU;
+} saveSnapshot_t;
+
+saveSnapshot_t *takeSnapshot(UNICHAR *filenameU, uint8_t saveMode, bool copyData); // main thread only, NULL if out of memory
+void freeSnapshot(saveSnapshot_t *snap); // can be called from any thread
+
+void saveMusic(UNICHAR *filenameU); // saves a snapshot of the song on a thread
+bool isMusicSaving(void);
+bool saveXM(UNICHAR *filenameU); // saves the song directly (crash handler)
+bool writeDeltaSampleData(FILE *f, const sample_t *s); // XM/XI, the sample data is not changed
+bool replaceFile(UNICHAR *srcU, UNICHAR *dstU); // moves the file over dstU (atomic on most systems)
@@ -260,6 +260,7 @@ static void nibbleWriteLevelSprite(int16_t xOut, int16_t yOut, int16_t levelNum)
 
 	const uint8_t *src = (const uint8_t *)&bmp.nibblesStages[(readY * 530) + readX];
 	uint32_t *dst = &video.frameBuffer[(yOut * SCREEN_W) + xOut];
+	markDirtyRect(xOut, yOut, 51+2, 23+2);
 
 	for (int32_t y = 0; y < 23+2; y++)
 	{
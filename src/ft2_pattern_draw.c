@@ -5,8 +5,13 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+#include <emmintrin.h>
+#endif
 #include "ft2_header.h"
 #include "ft2_pattern_ed.h"
+#include "ft2_pattern_draw.h"
 #include "ft2_config.h"
 #include "ft2_gui.h"
 #include "ft2_video.h"
@@ -14,8 +19,60 @@
 #include "ft2_bmp.h"
 #include "ft2_structs.h"
 
+#define PATT_GLYPH_H 8 // max. height of the pattern editor fonts
+#define PATT_ROW_H_MAX 11 // row height with pattern stretch
+
+typedef struct pattDrawState_t // everything that affects how the visible pattern rows look
+{
+	const note_t *pattPtr;
+	int32_t pattNum, numRows, channelOffset, numChannelsShown, maxVisibleChannels;
+	bool extended, pattChanScrollShown, markShown;
+	uint8_t ptnStretch, ptnShowVolColumn, ptnHex, ptnLineLight, ptnChnNumbers, ptnInstrZero, ptnFrmWrk;
+	int16_t ptnFont, ptnAcc;
+	uint32_t palette[PAL_NUM];
+} pattDrawState_t;
+
 static note_t emptyPattern[MAX_CHANNELS * MAX_PATT_LEN];
 
+// for incremental scrolling in writePattern()
+static bool pattScrollValid;
+static int32_t lastDrawnRow;
+static pattDrawState_t lastDrawState;
+static note_t drawnNotes[MAX_CHANNELS * MAX_PATT_LEN]; // pattern data that is currently on screen
+static uint32_t upperRowBg[SCREEN_W * PATT_ROW_H_MAX], lowerRowBg[SCREEN_W * PATT_ROW_H_MAX], midRowBg[SCREEN_W * 9];
+
+/* Pre-rendered pattern cells (one channel of one row), LRU-managed. Most cells on screen are repeats
+** (empty cells, the same few notes/effects), so a hit replaces the per-pixel glyph drawing with a fast
+** expansion pass. A cell only ever consists of its text color over a flat background, so it's stored
+** as an 8-bit coverage mask (0x00 = background, 0xFF = text) keyed by the note data alone. The colors
+** are applied when expanding, which means that palette changes and the selected row (different text
+** and background color) don't need cells of their own. Everything else that affects the look of a
+** cell (layout, fonts, config) flushes the cache when changed.
+*/
+#define PATT_CELL_CACHE_BYTES (256*1024)
+#define PATT_CELL_MAX_ENTRIES 1024 // enough for the narrowest channel width
+#define PATT_CELL_HASH_SIZE 2048 // must be a power of two
+
+typedef struct pattCell_t
+{
+	note_t note;
+	int16_t hashNext, lruPrev, lruNext;
+} pattCell_t;
+
+typedef struct pattCellLayout_t // everything besides the key that affects the look of a cell
+{
+	const uint8_t *font4Ptr;
+	uint32_t cellWidth, numChannelsShown;
+	uint8_t ptnShowVolColumn, ptnInstrZero;
+	int16_t ptnAcc;
+} pattCellLayout_t;
+
+static pattCell_t pattCells[PATT_CELL_MAX_ENTRIES];
+static pattCellLayout_t pattCellLayout;
+static int16_t pattCellHash[PATT_CELL_HASH_SIZE], pattCellLruHead = -1, pattCellLruTail = -1;
+static int32_t numPattCells, maxPattCells;
+static uint8_t pattCellMasks[PATT_CELL_CACHE_BYTES];
+
 static const uint8_t *font4Ptr, *font5Ptr;
 static const uint8_t vol2charTab1[16] = { 39, 0, 1, 2, 3, 4, 36, 52, 53, 54, 28, 31, 25, 58, 59, 22 };
 static const uint8_t vol2charTab2[16] = { 42, 0, 1, 2, 3, 4, 36, 37, 38, 39, 28, 31, 25, 40, 41, 22 };
@@ -44,6 +101,11 @@ static void drawEmptyNoteBig(uint32_t xPos, uint32_t yPos, uint32_t color);
 static void drawKeyOffBig(uint32_t xPos, uint32_t yPos, uint32_t color);
 static void drawNoteBig(uint32_t xPos, uint32_t yPos, int32_t noteNum, uint32_t color);
 
+static void (*drawNote)(uint32_t, uint32_t, int16_t, uint32_t);
+static void (*drawInst)(uint32_t, uint32_t, uint8_t, uint32_t);
+static void (*drawVolEfx)(uint32_t, uint32_t, uint8_t, uint32_t);
+static void (*drawEfx)(uint32_t, uint32_t, uint8_t, uint8_t, uint32_t);
+
 void updatePattFontPtrs(void)
 {
 	//config.ptnFont is pre-clamped and safe to use
@@ -51,8 +113,176 @@ void updatePattFontPtrs(void)
 	font5Ptr = &bmp.font4[(4 + config.ptnFont) * (FONT4_WIDTH * FONT4_CHAR_H)];
 }
 
+static void clearPattCellCache(void)
+{
+	memset(pattCellHash, 0xFF, sizeof (pattCellHash)); // -1 = empty bucket
+	pattCellLruHead = pattCellLruTail = -1;
+	numPattCells = 0;
+}
+
+static void updatePattCellLayout(void) // flushes the cell cache if the cell layout has changed
+{
+	pattCellLayout_t layout;
+
+	memset(&layout, 0, sizeof (layout)); // compared with memcmp(), so clear padding bytes too
+
+	layout.font4Ptr = font4Ptr;
+	layout.cellWidth = ui.patternChannelWidth - 3;
+	layout.numChannelsShown = ui.numChannelsShown;
+	layout.ptnShowVolColumn = config.ptnShowVolColumn;
+	layout.ptnInstrZero = config.ptnInstrZero;
+	layout.ptnAcc = config.ptnAcc;
+
+	if (maxPattCells > 0 && !memcmp(&layout, &pattCellLayout, sizeof (layout)))
+		return;
+
+	pattCellLayout = layout;
+
+	maxPattCells = PATT_CELL_CACHE_BYTES / (layout.cellWidth * PATT_GLYPH_H);
+	if (maxPattCells > PATT_CELL_MAX_ENTRIES)
+		maxPattCells = PATT_CELL_MAX_ENTRIES;
+
+	clearPattCellCache();
+}
+
+static uint32_t pattCellHashIndex(const note_t *p)
+{
+	uint32_t h = p->note | (p->instr << 8) | (p->vol << 16) | ((uint32_t)p->efx << 24);
+	h ^= p->efxData * 0x9E3779B1;
+	h ^= h >> 15;
+	h *= 0x2C1B3C6D;
+	h ^= h >> 12;
+
+	return h & (PATT_CELL_HASH_SIZE-1);
+}
+
+static void unlinkPattCellLru(int32_t i)
+{
+	pattCell_t *c = &pattCells[i];
+
+	if (c->lruPrev != -1)
+		pattCells[c->lruPrev].lruNext = c->lruNext;
+	else
+		pattCellLruHead = c->lruNext;
+
+	if (c->lruNext != -1)
+		pattCells[c->lruNext].lruPrev = c->lruPrev;
+	else
+		pattCellLruTail = c->lruPrev;
+}
+
+static void linkPattCellLru(int32_t i) // as most recently used
+{
+	pattCell_t *c = &pattCells[i];
+
+	c->lruPrev = -1;
+	c->lruNext = pattCellLruHead;
+
+	if (pattCellLruHead != -1)
+		pattCells[pattCellLruHead].lruPrev = (int16_t)i;
+	else
+		pattCellLruTail = (int16_t)i;
+
+	pattCellLruHead = (int16_t)i;
+}
+
+static uint8_t *findPattCell(const note_t *p) // returns NULL if not cached
+{
+	for (int32_t i = pattCellHash[pattCellHashIndex(p)]; i != -1; i = pattCells[i].hashNext)
+	{
+		if (!memcmp(&pattCells[i].note, p, sizeof (note_t)))
+		{
+			if (i != pattCellLruHead)
+			{
+				unlinkPattCellLru(i);
+				linkPattCellLru(i);
+			}
+
+			return &pattCellMasks[i * pattCellLayout.cellWidth * PATT_GLYPH_H];
+		}
+	}
+
+	return NULL;
+}
+
+static uint8_t *addPattCell(const note_t *p)
+{
+	int32_t i;
+	if (numPattCells < maxPattCells)
+	{
+		i = numPattCells++;
+	}
+	else
+	{
+		// evict least recently used cell
+		i = pattCellLruTail;
+		unlinkPattCellLru(i);
+
+		int16_t *link = &pattCellHash[pattCellHashIndex(&pattCells[i].note)];
+		while (*link != i)
+			link = &pattCells[*link].hashNext;
+		*link = pattCells[i].hashNext;
+	}
+
+	const uint32_t hash = pattCellHashIndex(p);
+
+	pattCell_t *c = &pattCells[i];
+	c->note = *p;
+	c->hashNext = pattCellHash[hash];
+	pattCellHash[hash] = (int16_t)i;
+	linkPattCellLru(i);
+
+	return &pattCellMasks[i * pattCellLayout.cellWidth * PATT_GLYPH_H];
+}
+
+// conversion pass: coverage mask -> 32-bit pixels
+static void expandPattCell(uint32_t *dstPtr, const uint8_t *maskPtr, uint32_t color, uint32_t bg)
+{
+	const int32_t width = pattCellLayout.cellWidth;
+	const uint32_t colorXor = color ^ bg;
+
+	for (int32_t y = 0; y < PATT_GLYPH_H; y++, dstPtr += SCREEN_W, maskPtr += width)
+	{
+		int32_t x = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+		const __m128i bg4 = _mm_set1_epi32(bg);
+		const __m128i xor4 = _mm_set1_epi32(colorXor);
+
+		for (; x+16 <= width; x += 16)
+		{
+			// 0x00/0xFF bytes -> 0x00000000/0xFFFFFFFF dwords
+			const __m128i m8 = _mm_loadu_si128((const __m128i *)&maskPtr[x]);
+			const __m128i m16lo = _mm_unpacklo_epi8(m8, m8);
+			const __m128i m16hi = _mm_unpackhi_epi8(m8, m8);
+
+			__m128i *out = (__m128i *)&dstPtr[x];
+			_mm_storeu_si128(out+0, _mm_xor_si128(bg4, _mm_and_si128(xor4, _mm_unpacklo_epi16(m16lo, m16lo))));
+			_mm_storeu_si128(out+1, _mm_xor_si128(bg4, _mm_and_si128(xor4, _mm_unpackhi_epi16(m16lo, m16lo))));
+			_mm_storeu_si128(out+2, _mm_xor_si128(bg4, _mm_and_si128(xor4, _mm_unpacklo_epi16(m16hi, m16hi))));
+			_mm_storeu_si128(out+3, _mm_xor_si128(bg4, _mm_and_si128(xor4, _mm_unpackhi_epi16(m16hi, m16hi))));
+		}
+#endif
+		for (; x < width; x++)
+			dstPtr[x] = bg ^ (colorXor & (uint32_t)(int8_t)maskPtr[x]);
+	}
+}
+
+static void capturePattCell(uint8_t *maskPtr, const uint32_t *srcPtr, uint32_t bg)
+{
+	const int32_t width = pattCellLayout.cellWidth;
+
+	for (int32_t y = 0; y < PATT_GLYPH_H; y++, srcPtr += SCREEN_W, maskPtr += width)
+	{
+		for (int32_t x = 0; x < width; x++)
+			maskPtr[x] = (srcPtr[x] != bg) ? 0xFF : 0x00;
+	}
+}
+
 void drawPatternBorders(void)
 {
+	pattScrollValid = false; // pattern area gets cleared, nothing to scroll from
+
 	// get heights/pos/rows depending on configuration
 	const pattCoord2_t *pattCoord = &pattCoord2Table[config.ptnStretch][ui.pattChanScrollShown][ui.extended];
 
@@ -149,11 +379,13 @@ void drawPatternBorders(void)
 		{
 			const int32_t clearSize = ui.pattChanScrollShown ? (SCREEN_W * sizeof (int32_t) * 330) : (SCREEN_W * sizeof (int32_t) * 347);
 			memset(&video.frameBuffer[53 * SCREEN_W], 0, clearSize);
+			markDirtyRect(0, 53, SCREEN_W, clearSize / (SCREEN_W * sizeof (int32_t)));
 		}
 		else
 		{
 			const int32_t clearSize = ui.pattChanScrollShown ? (SCREEN_W * sizeof(int32_t) * 210) : (SCREEN_W * sizeof(int32_t) * 227);
 			memset(&video.frameBuffer[173 * SCREEN_W], 0, clearSize);
+			markDirtyRect(0, 173, SCREEN_W, clearSize / (SCREEN_W * sizeof (int32_t)));
 		}
 
 		drawFramework(0, pattCoord->lowerRowsY - 10, SCREEN_W, 11, FRAMEWORK_TYPE1);
@@ -634,14 +866,181 @@ static void showEfxNoVolColumn(uint32_t xPos, uint32_t yPos, uint8_t efx, uint8_
 	pattCharOut(xPos + (charW * 2), yPos, efxData & 0x0F, fontType, color);
 }
 
+static void setupRowDrawFuncs(void)
+{
+	if (config.ptnShowVolColumn)
+	{
+		drawNote = showNoteNum;
+		drawInst = showInstrNum;
+		drawVolEfx = showVolEfx;
+		drawEfx = showEfx;
+	}
+	else
+	{
+		drawNote = showNoteNumNoVolColumn;
+		drawInst = showInstrNumNoVolColumn;
+		drawVolEfx = showNoVolEfx;
+		drawEfx = showEfxNoVolColumn;
+	}
+}
+
+static void drawPatternRow(int32_t textY, int32_t row, bool selectedRowFlag, const note_t *pattBase, int32_t numRows)
+{
+	if (row < 0 || row >= numRows)
+		return; // outside of pattern, leave empty
+
+	drawRowNums(textY, (uint8_t)row, selectedRowFlag);
+
+	const note_t *p = &pattBase[((uint32_t)row * MAX_CHANNELS) + ui.channelOffset];
+	const int32_t xWidth = ui.patternChannelWidth;
+	const uint32_t color = video.palette[selectedRowFlag ? PAL_FORGRND : PAL_PATTEXT];
+
+	int32_t xPos = 29;
+	for (int32_t j = 0; j < ui.numChannelsShown; j++, p++, xPos += xWidth)
+	{
+		// the cell area is empty at this point, so its first pixel is the background color of the whole cell
+		uint32_t *dstPtr = &video.frameBuffer[(textY * SCREEN_W) + xPos];
+		const uint32_t bg = *dstPtr;
+
+		const uint8_t *maskPtr = findPattCell(p);
+		if (maskPtr != NULL)
+		{
+			expandPattCell(dstPtr, maskPtr, color, bg);
+			continue;
+		}
+
+		drawNote(xPos, textY, p->note, color);
+		drawInst(xPos, textY, p->instr, color);
+		drawVolEfx(xPos, textY, p->vol, color);
+		drawEfx(xPos, textY, p->efx, p->efxData, color);
+
+		if (color != bg) // the text would be invisible, can't get a mask from it
+			capturePattCell(addPattCell(p), dstPtr, bg);
+	}
+
+	// keep a copy of what's on screen, so that scrolled rows can be checked for edits
+	memcpy(&drawnNotes[(uint32_t)row * MAX_CHANNELS], &pattBase[(uint32_t)row * MAX_CHANNELS], MAX_CHANNELS * sizeof (note_t));
+}
+
+static void getPattDrawState(pattDrawState_t *state, int32_t currPattern)
+{
+	memset(state, 0, sizeof (pattDrawState_t)); // compared with memcmp(), so clear padding bytes too
+
+	state->pattPtr = pattern[currPattern];
+	state->pattNum = currPattern;
+	state->numRows = patternNumRows[currPattern];
+	state->channelOffset = ui.channelOffset;
+	state->numChannelsShown = ui.numChannelsShown;
+	state->maxVisibleChannels = ui.maxVisibleChannels;
+	state->extended = ui.extended;
+	state->pattChanScrollShown = ui.pattChanScrollShown;
+	state->markShown = (pattMark.markY1 != pattMark.markY2);
+	state->ptnStretch = config.ptnStretch;
+	state->ptnShowVolColumn = config.ptnShowVolColumn;
+	state->ptnHex = config.ptnHex;
+	state->ptnLineLight = config.ptnLineLight;
+	state->ptnChnNumbers = config.ptnChnNumbers;
+	state->ptnInstrZero = config.ptnInstrZero;
+	state->ptnFrmWrk = config.ptnFrmWrk;
+	state->ptnFont = config.ptnFont;
+	state->ptnAcc = config.ptnAcc;
+	memcpy(state->palette, video.palette, sizeof (state->palette));
+}
+
+static void scrollPatternRows(int32_t textY, int32_t numBandRows, int32_t rowDelta, uint32_t rowHeight)
+{
+	const int32_t height = ((numBandRows - ABS(rowDelta) - 1) * rowHeight) + PATT_GLYPH_H;
+
+	int32_t srcY = textY, dstY = textY;
+	if (rowDelta > 0)
+		srcY += rowDelta * rowHeight;
+	else
+		dstY -= rowDelta * rowHeight;
+
+	memmove(&video.frameBuffer[dstY * SCREEN_W], &video.frameBuffer[srcY * SCREEN_W], height * SCREEN_W * sizeof (int32_t));
+}
+
+static void updateScrolledRows(int32_t textY, int32_t numBandRows, int32_t firstRow, int32_t rowDelta, int32_t numForcedRows,
+	const uint32_t *bgStrip, uint32_t rowHeight, const note_t *pattBase, int32_t numRows)
+{
+	for (int32_t i = 0; i < numBandRows; i++, textY += rowHeight)
+	{
+		const int32_t row = firstRow + i;
+
+		// newly exposed rows
+		bool redraw = (rowDelta > 0) ? (i >= numBandRows-rowDelta) : (i < -rowDelta);
+
+		// rows that were scrolled, but have been edited since they were drawn
+		if (!redraw && row >= 0 && row < numRows)
+		{
+			const uint32_t offset = (uint32_t)row * MAX_CHANNELS;
+			redraw = memcmp(&drawnNotes[offset], &pattBase[offset], MAX_CHANNELS * sizeof (note_t)) != 0;
+		}
+
+		if (redraw || i < numForcedRows)
+		{
+			// clear the row including the spacing below it (not below the last row, that's the framework)
+			const int32_t height = (i < numBandRows-1) ? rowHeight : PATT_GLYPH_H;
+			memcpy(&video.frameBuffer[textY * SCREEN_W], bgStrip, SCREEN_W * height * sizeof (int32_t));
+			drawPatternRow(textY, row, false, pattBase, numRows);
+		}
+	}
+}
+
 void writePattern(int32_t currRow, int32_t currPattern)
 {
-	uint32_t noteTextColors[2];
+	pattDrawState_t state;
+
+	getPattDrawState(&state, currPattern);
+
+	// get heights/pos/rows depending on configuration
+	uint32_t rowHeight = config.ptnStretch ? 11 : 8;
+	const pattCoord_t *pattCoord = &pattCoordTable[config.ptnStretch][ui.pattChanScrollShown][ui.extended];
+	const int32_t numRows = patternNumRows[currPattern];
+	const note_t *pattBase = (pattern[currPattern] == NULL) ? emptyPattern : pattern[currPattern];
+	const int32_t rowDelta = currRow - lastDrawnRow;
+
+	setupRowDrawFuncs();
+
+	/* If only the row changed since the last draw (f.ex. during playback), move the existing pixels
+	** of the upper/lower rows and only draw the newly exposed rows, the current row and the cursor.
+	** Anything that could have changed the look of the scrolled pixels (pattern, channel scroll,
+	** config, palette, pattern mark, or something else drawing over the pattern area) falls
+	** back to a full redraw.
+	*/
+	if (pattScrollValid && rowDelta != 0 && !state.markShown &&
+	    ABS(rowDelta) < pattCoord->numUpperRows && ABS(rowDelta) < pattCoord->numLowerRows &&
+	    !memcmp(&state, &lastDrawState, sizeof (pattDrawState_t)))
+	{
+		const int32_t pattAreaY = ui.extended ? 53 : 173;
+		markDirtyRect(0, pattAreaY, SCREEN_W, SCREEN_H - pattAreaY);
+
+		// the channel numbers cover the first two rows (which are moved down when scrolling backwards)
+		int32_t numForcedRows = 0;
+		if (config.ptnChnNumbers)
+			numForcedRows = (rowDelta < 0) ? (2 - rowDelta) : 2;
+
+		scrollPatternRows(pattCoord->upperRowsTextY, pattCoord->numUpperRows, rowDelta, rowHeight);
+		scrollPatternRows(pattCoord->lowerRowsTextY, pattCoord->numLowerRows, rowDelta, rowHeight);
+
+		updateScrolledRows(pattCoord->upperRowsTextY, pattCoord->numUpperRows, currRow - pattCoord->numUpperRows,
+			rowDelta, numForcedRows, upperRowBg, rowHeight, pattBase, numRows);
+
+		updateScrolledRows(pattCoord->lowerRowsTextY, pattCoord->numLowerRows, currRow + 1,
+			rowDelta, 0, lowerRowBg, rowHeight, pattBase, numRows);
+
+		// current row
+		memcpy(&video.frameBuffer[editor.ptnCursorY * SCREEN_W], midRowBg, sizeof (midRowBg));
+		drawPatternRow(pattCoord->midRowTextY, currRow, true, pattBase, numRows);
+
+		writeCursor();
 
-	void (*drawNote)(uint32_t, uint32_t, int16_t, uint32_t);
-	void (*drawInst)(uint32_t, uint32_t, uint8_t, uint32_t);
-	void (*drawVolEfx)(uint32_t, uint32_t, uint8_t, uint32_t);
-	void (*drawEfx)(uint32_t, uint32_t, uint8_t, uint8_t, uint32_t);
+		if (config.ptnChnNumbers)
+			drawChannelNumbering(pattCoord->upperRowsTextY);
+
+		lastDrawnRow = currRow;
+		return;
+	}
 
 	/* Draw pattern framework every time (erasing existing content).
 	** FT2 doesn't do this. This is quite lazy and consumes more CPU
@@ -650,6 +1049,15 @@ void writePattern(int32_t currRow, int32_t currPattern)
 	*/
 	drawPatternBorders();
 
+	// the pattern data/cursor/mark routines below write to the framebuffer directly
+	const int32_t pattAreaY = ui.extended ? 53 : 173;
+	markDirtyRect(0, pattAreaY, SCREEN_W, SCREEN_H - pattAreaY);
+
+	// save empty row backgrounds for the scroll path above
+	memcpy(upperRowBg, &video.frameBuffer[pattCoord->upperRowsTextY * SCREEN_W], sizeof (upperRowBg));
+	memcpy(lowerRowBg, &video.frameBuffer[pattCoord->lowerRowsTextY * SCREEN_W], sizeof (lowerRowBg));
+	memcpy(midRowBg, &video.frameBuffer[editor.ptnCursorY * SCREEN_W], sizeof (midRowBg));
+
 	// setup variables
 
 	uint32_t chans = ui.numChannelsShown;
@@ -661,65 +1069,19 @@ void writePattern(int32_t currRow, int32_t currPattern)
 	// get channel width
 	const uint32_t chanWidth = chanWidths[(chans / 2) - 1];
 	ui.patternChannelWidth = (uint16_t)(chanWidth + 3);
+	updatePattCellLayout();
 
-	// get heights/pos/rows depending on configuration
-	uint32_t rowHeight = config.ptnStretch ? 11 : 8;
-	const pattCoord_t *pattCoord = &pattCoordTable[config.ptnStretch][ui.pattChanScrollShown][ui.extended];
 	const int32_t midRowTextY = pattCoord->midRowTextY;
 	const int32_t lowerRowsTextY = pattCoord->lowerRowsTextY;
 	int32_t row = currRow - pattCoord->numUpperRows;
 	const int32_t rowsOnScreen = pattCoord->numUpperRows + 1 + pattCoord->numLowerRows;
 	int32_t textY = pattCoord->upperRowsTextY;
 	const int32_t afterCurrRow = currRow + 1;
-	const int32_t numChannels = ui.numChannelsShown;
-	note_t *pattPtr = pattern[currPattern];
-	const int32_t numRows = patternNumRows[currPattern];
-
-	// increment pattern data pointer by horizontal scrollbar offset/channel
-	if (pattPtr != NULL)
-		pattPtr += ui.channelOffset;
-
-	// set up function pointers for drawing
-	if (config.ptnShowVolColumn)
-	{
-		drawNote = showNoteNum;
-		drawInst = showInstrNum;
-		drawVolEfx = showVolEfx;
-		drawEfx = showEfx;
-	}
-	else
-	{
-		drawNote = showNoteNumNoVolColumn;
-		drawInst = showInstrNumNoVolColumn;
-		drawVolEfx = showNoVolEfx;
-		drawEfx = showEfxNoVolColumn;
-	}
-
-	noteTextColors[0] = video.palette[PAL_PATTEXT]; // not selected
-	noteTextColors[1] = video.palette[PAL_FORGRND]; // selected
 
 	// draw pattern data
 	for (int32_t i = 0; i < rowsOnScreen; i++)
 	{
-		if (row >= 0)
-		{
-			const bool selectedRowFlag = (row == currRow);
-
-			drawRowNums(textY, (uint8_t)row, selectedRowFlag);
-
-			const note_t *p = (pattPtr == NULL) ? emptyPattern : &pattPtr[(uint32_t)row * MAX_CHANNELS];
-			const int32_t xWidth = ui.patternChannelWidth;
-			const uint32_t color = noteTextColors[selectedRowFlag];
-
-			int32_t xPos = 29;
-			for (int32_t j = 0; j < numChannels; j++, p++, xPos += xWidth)
-			{
-				drawNote(xPos, textY, p->note, color);
-				drawInst(xPos, textY, p->instr, color);
-				drawVolEfx(xPos, textY, p->vol, color);
-				drawEfx(xPos, textY, p->efx, p->efxData, color);
-			}
-		}
+		drawPatternRow(textY, row, (row == currRow), pattBase, numRows);
 
 		// next row
 		if (++row >= numRows)
@@ -743,6 +1105,10 @@ void writePattern(int32_t currRow, int32_t currPattern)
 	// channel numbers must be drawn lastly
 	if (config.ptnChnNumbers)
 		drawChannelNumbering(pattCoord->upperRowsTextY);
+
+	lastDrawState = state;
+	lastDrawnRow = currRow;
+	pattScrollValid = true;
 }
 
 // ========== CHARACTER DRAWING ROUTINES FOR PATTERN EDITOR ==========
@@ -752,6 +1118,7 @@ void pattTwoHexOut(uint32_t xPos, uint32_t yPos, uint8_t val, uint32_t color)
 	const uint8_t *ch1Ptr = &font4Ptr[(val   >> 4) * FONT4_CHAR_W];
 	const uint8_t *ch2Ptr = &font4Ptr[(val & 0x0F) * FONT4_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W*2, FONT4_CHAR_H);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
 	{
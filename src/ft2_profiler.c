@@ -0,0 +1,249 @@
+/*
+** Main loop profiler (per-section frame times, overlay and Chrome trace export)
+**
+** Enabled with the "--profile" or "--profile-trace <file>" startup switches.
+** The trace file can be loaded in chrome://tracing or ui.perfetto.dev.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ft2_header.h"
+#include "ft2_gui.h"
+#include "ft2_video.h"
+#include "ft2_hpc.h"
+#include "ft2_profiler.h"
+
+#define OVERLAY_LINES 16
+#define OVERLAY_X 292
+#define OVERLAY_Y 2
+#define OVERLAY_W 335
+#define OVERLAY_H (((FONT1_CHAR_H + 1) * OVERLAY_LINES) + 1)
+
+static const char *sectionNames[PROF_SECTIONS] =
+{
+	"threadEvents", "readInput", "handleEvents", "handleRedrawing", "writePattern",
+	"drawScopes", "sampleEdExt", "sprites", "textureUpload", "present", "vblankWait",
+	"frame"
+};
+
+static const char *overlayNames[PROF_SECTIONS] =
+{
+	"Thread events", "Input", "Events", "Redrawing", "  Pattern editor",
+	"  Scopes", "  Smp. ed. ext.", "Sprites", "Texture upload", "Present", "Vblank wait",
+	"Whole frame"
+};
+
+profiler_t profiler; // globalized
+
+static uint64_t lastFrameEnd;
+
+bool profilerInit(const char *traceFilename)
+{
+	profiler.enabled = true;
+
+	if (traceFilename == NULL)
+		return true;
+
+	profiler.traceEvents = malloc(PROF_MAX_TRACE_EVENTS * sizeof (*profiler.traceEvents));
+	if (profiler.traceEvents == NULL)
+	{
+		showErrorMsgBox("Not enough memory for the profiler trace buffer!");
+		return false;
+	}
+
+	// opened right away, since the current directory changes once the disk op. is used
+	profiler.traceFile = fopen(traceFilename, "w");
+	if (profiler.traceFile == NULL)
+	{
+		free(profiler.traceEvents);
+		profiler.traceEvents = NULL;
+
+		showErrorMsgBox("Couldn't open profiler trace file for writing:\n%s", traceFilename);
+		return false;
+	}
+
+	return true;
+}
+
+void profilerBegin(int32_t section)
+{
+	if (!profiler.enabled)
+		return;
+
+	profiler.sectionStart[section] = SDL_GetPerformanceCounter();
+	if (profiler.startTime == 0)
+		profiler.startTime = lastFrameEnd = profiler.sectionStart[section];
+}
+
+static void addTraceEvent(int32_t section, uint64_t start, uint64_t duration)
+{
+	if (profiler.traceEvents == NULL)
+		return;
+
+	profiler.traceEvents[profiler.traceWritePos].start = start;
+	profiler.traceEvents[profiler.traceWritePos].duration = duration;
+	profiler.traceEvents[profiler.traceWritePos].section = (uint8_t)section;
+
+	profiler.traceWritePos = (profiler.traceWritePos + 1) & (PROF_MAX_TRACE_EVENTS-1);
+	if (profiler.numTraceEvents < PROF_MAX_TRACE_EVENTS)
+		profiler.numTraceEvents++;
+}
+
+void profilerEnd(int32_t section)
+{
+	if (!profiler.enabled)
+		return;
+
+	const uint64_t start = profiler.sectionStart[section];
+	const uint64_t duration = SDL_GetPerformanceCounter() - start;
+
+	profiler.frameTime[section] += duration; // a section can run more than once per frame
+	addTraceEvent(section, start, duration);
+}
+
+void profilerEndFrame(void)
+{
+	if (!profiler.enabled)
+		return;
+
+	const uint64_t frameEnd = SDL_GetPerformanceCounter();
+	if (profiler.startTime == 0)
+		profiler.startTime = lastFrameEnd = frameEnd;
+
+	profiler.frameTime[PROF_FRAME] = frameEnd - lastFrameEnd;
+	addTraceEvent(PROF_FRAME, lastFrameEnd, frameEnd - lastFrameEnd);
+	lastFrameEnd = frameEnd;
+
+	// update rolling averages and maximums
+
+	const uint32_t pos = profiler.historyPos;
+	for (int32_t i = 0; i < PROF_SECTIONS; i++)
+	{
+		profiler.history[i][pos] = profiler.frameTime[i];
+		profiler.frameTime[i] = 0;
+
+		uint64_t sum = 0, max = 0;
+		for (int32_t j = 0; j < PROF_AVG_FRAMES; j++)
+		{
+			const uint64_t time = profiler.history[i][j];
+
+			sum += time;
+			if (time > max)
+				max = time;
+		}
+
+		profiler.dAvgMs[i] = (sum * hpcFreq.dFreqMulMs) / PROF_AVG_FRAMES;
+		profiler.dMaxMs[i] = max * hpcFreq.dFreqMulMs;
+	}
+
+	if (++profiler.historyPos >= PROF_AVG_FRAMES)
+		profiler.historyPos = 0;
+}
+
+void profilerSetDirSortTime(int32_t numFiles, double dMs)
+{
+	profiler.dirSortFiles = numFiles;
+	profiler.dDirSortMs = dMs;
+}
+
+static void numberOutRight(uint16_t xEnd, uint16_t y, double dMs)
+{
+	char text[32];
+
+	if (dMs > 9999.99)
+		dMs = 9999.99; // prevent number from overflowing the column
+
+	sprintf(text, "%.2f", dMs);
+	textOut(xEnd - textWidth(text), y, PAL_FORGRND, text);
+}
+
+void drawProfilerOverlay(void) // drawn next to the FPS counter
+{
+	char text[64];
+
+	if (!profiler.enabled)
+		return;
+
+	clearRect(OVERLAY_X+2, OVERLAY_Y+2, OVERLAY_W-2, OVERLAY_H);
+	vLineDouble(OVERLAY_X, OVERLAY_Y+1, OVERLAY_H+2, PAL_FORGRND);
+	vLineDouble(OVERLAY_X+OVERLAY_W, OVERLAY_Y+1, OVERLAY_H+2, PAL_FORGRND);
+	hLineDouble(OVERLAY_X+1, OVERLAY_Y, OVERLAY_W, PAL_FORGRND);
+	hLineDouble(OVERLAY_X+1, OVERLAY_Y+OVERLAY_H+2, OVERLAY_W, PAL_FORGRND);
+
+	uint16_t y = OVERLAY_Y+3;
+
+	textOut(OVERLAY_X+4, y, PAL_FORGRND, "Section (ms, last 60 frames)");
+	textOut(OVERLAY_X+OVERLAY_W-94, y, PAL_FORGRND, "avg");
+	textOut(OVERLAY_X+OVERLAY_W-34, y, PAL_FORGRND, "max");
+	y += FONT1_CHAR_H+1;
+
+	for (int32_t i = 0; i < PROF_SECTIONS; i++)
+	{
+		textOut(OVERLAY_X+4, y, PAL_FORGRND, overlayNames[i]);
+		numberOutRight(OVERLAY_X+OVERLAY_W-70, y, profiler.dAvgMs[i]);
+		numberOutRight(OVERLAY_X+OVERLAY_W-10, y, profiler.dMaxMs[i]);
+		y += FONT1_CHAR_H+1;
+	}
+
+	if (profiler.traceFile != NULL)
+		sprintf(text, "Trace: %u events (written on exit)", profiler.numTraceEvents);
+	else
+		strcpy(text, "Trace: off (use --profile-trace <file>)");
+
+	y += FONT1_CHAR_H+1;
+	textOut(OVERLAY_X+4, y, PAL_FORGRND, text);
+
+	sprintf(text, "Disk op. dir sort: %d files, %.2f ms", profiler.dirSortFiles, profiler.dDirSortMs);
+	y += FONT1_CHAR_H+1;
+	textOut(OVERLAY_X+4, y, PAL_FORGRND, text);
+}
+
+static void writeTraceFile(void)
+{
+	FILE *f = profiler.traceFile;
+
+	fprintf(f, "{\"traceEvents\":[\n");
+
+	// oldest event first (the buffer may have wrapped around)
+	uint32_t readPos = (profiler.traceWritePos - profiler.numTraceEvents) & (PROF_MAX_TRACE_EVENTS-1);
+	for (uint32_t i = 0; i < profiler.numTraceEvents; i++)
+	{
+		const uint64_t start = profiler.traceEvents[readPos].start;
+		const uint64_t duration = profiler.traceEvents[readPos].duration;
+		const int32_t section = profiler.traceEvents[readPos].section;
+
+		// Chrome trace-event "complete" events, time stamps are in microseconds
+		const double dStartUs = (int64_t)(start - profiler.startTime) * hpcFreq.dFreqMulMicro;
+		const double dDurationUs = duration * hpcFreq.dFreqMulMicro;
+
+		fprintf(f, "{\"name\":\"%s\",\"cat\":\"ft2\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+			sectionNames[section], dStartUs, dDurationUs, (i < profiler.numTraceEvents-1) ? "," : "");
+
+		readPos = (readPos + 1) & (PROF_MAX_TRACE_EVENTS-1);
+	}
+
+	fprintf(f, "],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+void profilerClose(void)
+{
+	if (profiler.traceFile != NULL)
+	{
+		if (profiler.traceEvents != NULL && profiler.startTime != 0)
+			writeTraceFile();
+
+		fclose(profiler.traceFile);
+		profiler.traceFile = NULL;
+	}
+
+	if (profiler.traceEvents != NULL)
+	{
+		free(profiler.traceEvents);
+		profiler.traceEvents = NULL;
+	}
+
+	profiler.enabled = false;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// main loop sections (see profilerBegin()/profilerEnd() calls)
+enum
+{
+	PROF_THREAD_EVENTS = 0,
+	PROF_INPUT,
+	PROF_EVENTS,
+	PROF_REDRAW,
+	PROF_PATTERN,
+	PROF_SCOPES,
+	PROF_SMPED_EXT,
+	PROF_SPRITES,
+	PROF_UPLOAD,
+	PROF_PRESENT,
+	PROF_VBLANK_WAIT,
+	PROF_FRAME, // whole frame, measured in profilerEndFrame()
+
+	PROF_SECTIONS
+};
+
+#define PROF_AVG_FRAMES 60 // rolling window for the overlay (one second)
+#define PROF_MAX_TRACE_EVENTS 131072 // ring buffer, oldest events are overwritten
+#define PROF_DEFAULT_TRACE_FILENAME "ft2-trace.json" // "--profile-trace" without a filename
+
+typedef struct profiler_t
+{
+	bool enabled;
+	FILE *traceFile;
+	uint64_t startTime, sectionStart[PROF_SECTIONS], frameTime[PROF_SECTIONS];
+	uint64_t history[PROF_SECTIONS][PROF_AVG_FRAMES];
+	double dAvgMs[PROF_SECTIONS], dMaxMs[PROF_SECTIONS];
+	uint32_t historyPos, numTraceEvents, traceWritePos;
+	int32_t dirSortFiles; // last disk op. directory sort (set by the directory reader thread)
+	double dDirSortMs;
+	struct
+	{
+		uint64_t start, duration;
+		uint8_t section;
+	} *traceEvents;
+} profiler_t;
+
+extern profiler_t profiler; // ft2_profiler.c
+
+bool profilerInit(const char *traceFilename);
+void profilerBegin(int32_t section);
+void profilerEnd(int32_t section);
+void profilerEndFrame(void);
+void profilerSetDirSortTime(int32_t numFiles, double dMs);
+void drawProfilerOverlay(void);
+void profilerClose(void); // writes trace file (if any) and frees memory
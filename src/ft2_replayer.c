@@ -18,8 +18,10 @@
 #include "scopes/ft2_scopes.h"
 #include "ft2_mouse.h"
 #include "ft2_sample_loader.h"
+#include "ft2_module_loader.h"
 #include "ft2_tables.h"
 #include "ft2_structs.h"
+#include "ft2_sample_kernels.h"
 #include "mixer/ft2_cubic_spline.h"
 #include "mixer/ft2_windowed_sinc.h"
 
@@ -529,6 +531,8 @@ static void triggerNote(uint8_t note, uint8_t efx, uint8_t efxData, channel_t *c
 
 	ch->smpNum = ins->note2SampleLUT[note-1] & 0xF; // FT2 doesn't mask it, but let's do it anyway
 	sample_t *s = &ins->smp[ch->smpNum];
+	if (s->dataPtr == NULL)
+		lazySampleWanted(ch->instrNum); // huge module, the sample may not be loaded yet
 
 	ch->smpPtr = s;
 	ch->relativeNote = s->relativeNote;
@@ -2423,104 +2427,41 @@ void delta2Samp(int8_t *p, int32_t length, uint8_t smpFlags)
 	{
 		length >>= 1;
 
+		// decode both channels, then mix them to mono in the left channel (the right channel is left decoded)
 		if (sample16Bit)
 		{
 			int16_t *p16L = (int16_t *)p;
 			int16_t *p16R = (int16_t *)p + length;
 
-			int16_t olds16L = 0;
-			int16_t olds16R = 0;
-
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int16_t news16L = p16L[i] + olds16L;
-				p16L[i] = news16L;
-				olds16L = news16L;
-
-				const int16_t news16R = p16R[i] + olds16R;
-				p16R[i] = news16R;
-				olds16R = news16R;
-
-				p16L[i] = (int16_t)((olds16L + olds16R) >> 1);
-			}
+			prefixSum16(p16L, length, 0);
+			prefixSum16(p16R, length, 0);
+			average16(p16L, p16R, length, 0);
 		}
 		else // 8-bit
 		{
 			int8_t *p8L = (int8_t *)p;
 			int8_t *p8R = (int8_t *)p + length;
 
-			int8_t olds8L = 0;
-			int8_t olds8R = 0;
-
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int8_t news8L = p8L[i] + olds8L;
-				p8L[i] = news8L;
-				olds8L = news8L;
-
-				const int8_t news8R = p8R[i] + olds8R;
-				p8R[i] = news8R;
-				olds8R = news8R;
-
-				p8L[i] = (int8_t)((olds8L + olds8R) >> 1);
-			}
+			prefixSum8(p8L, length, 0);
+			prefixSum8(p8R, length, 0);
+			average8(p8L, p8R, length, 0);
 		}
 	}
 	else // mono (normal sample)
 	{
 		if (sample16Bit)
-		{
-			int16_t *p16 = (int16_t *)p;
-
-			int16_t olds16L = 0;
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int16_t news16 = p16[i] + olds16L;
-				p16[i] = news16;
-				olds16L = news16;
-			}
-		}
-		else // 8-bit
-		{
-			int8_t *p8 = (int8_t *)p;
-
-			int8_t olds8L = 0;
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int8_t news8 = p8[i] + olds8L;
-				p8[i] = news8;
-				olds8L = news8;
-			}
-		}
+			prefixSum16((int16_t *)p, length, 0);
+		else
+			prefixSum8((int8_t *)p, length, 0);
 	}
 }
 
 void samp2Delta(int8_t *p, int32_t length, uint8_t smpFlags)
 {
 	if (smpFlags & SAMPLE_16BIT)
-	{
-		int16_t *p16 = (int16_t *)p;
-
-		int16_t newS16 = 0;
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int16_t oldS16 = p16[i];
-			p16[i] -= newS16;
-			newS16 = oldS16;
-		}
-	}
-	else // 8-bit
-	{
-		int8_t *p8 = (int8_t *)p;
-
-		int8_t newS8 = 0;
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int8_t oldS8 = p8[i];
-			p8[i] -= newS8;
-			newS8 = oldS8;
-		}
-	}
+		deltaEncode16((int16_t *)p, length);
+	else
+		deltaEncode8((int8_t *)p, length);
 }
 
 bool allocateInstr(int16_t insNum)
@@ -2559,6 +2500,7 @@ void freeInstr(int32_t insNum)
 	if (instr[insNum] == NULL)
 		return; // not allocated
 
+	cancelLazySamples(insNum);
 	pauseAudio(); // channel instrument pointers are now cleared
 
 	sample_t *s = instr[insNum]->smp;
@@ -2573,6 +2515,7 @@ void freeInstr(int32_t insNum)
 
 void freeAllInstr(void)
 {
+	stopLazySampleLoading();
 	pauseAudio(); // channel instrument pointers are now cleared
 	for (int32_t i = 1; i <= MAX_INST; i++)
 	{
@@ -2753,20 +2696,11 @@ void conv8BitSample(int8_t *p, int32_t length, bool stereo) // changes sample si
 	if (stereo)
 	{
 		length >>= 1;
-
-		int8_t *p2 = &p[length];
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int8_t l = p[i] ^ 0x80;
-			const int8_t r = p2[i] ^ 0x80;
-
-			p[i] = (int8_t)((l + r) >> 1);
-		}
+		average8(p, &p[length], length, (int8_t)0x80);
 	}
 	else
 	{
-		for (int32_t i = 0; i < length; i++)
-			p[i] ^= 0x80;
+		flipSign8(p, length);
 	}
 }
 
@@ -2777,20 +2711,11 @@ void conv16BitSample(int8_t *p, int32_t length, bool stereo) // changes sample s
 	if (stereo)
 	{
 		length >>= 1;
-
-		int16_t *p16_2 = (int16_t *)p + length;
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int16_t l = p16_1[i] ^ 0x8000;
-			const int16_t r = p16_2[i] ^ 0x8000;
-
-			p16_1[i] = (int16_t)((l + r) >> 1);
-		}
+		average16(p16_1, p16_1 + length, length, (int16_t)0x8000);
 	}
 	else
 	{
-		for (int32_t i = 0; i < length; i++)
-			p16_1[i] ^= 0x8000;
+		flipSign16(p16_1, length);
 	}
 }
 
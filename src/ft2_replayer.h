@@ -214,12 +214,18 @@ typedef struct sample_t
 	int8_t finetune, relativeNote, *dataPtr, *origDataPtr;
 	uint8_t volume, flags, panning;
 	int32_t length, loopStart, loopLength;
+	uint32_t dataGeneration; // changes whenever the sample data does (see setDataGeneration())
 
 	// fix for resampling interpolation taps
 	int8_t leftEdgeTapSamples8[MAX_TAPS*2];
 	int16_t leftEdgeTapSamples16[MAX_TAPS*2];
 	int16_t fixedSmp[MAX_TAPS*2];
 	int32_t fixedPos;
+
+	// min/max peak pyramid for the sample editor waveform (built on demand)
+	int16_t *peakData;
+	int32_t peakDataLength;
+	bool peakDataValid;
 } sample_t;
 
 typedef struct instr_t
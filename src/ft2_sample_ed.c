@@ -28,6 +28,7 @@
 #include "ft2_keyboard.h"
 #include "ft2_structs.h"
 #include "ft2_replayer.h"
+#include "ft2_workers.h"
 #include "mixer/ft2_windowed_sinc.h" // SINC_TAPS, SINC_NEGATIVE_TAPS
 
 static const char sharpNote1Char[12] = { 'C', 'C', 'D', 'D', 'E', 'F', 'F', 'G', 'G', 'A', 'A', 'B' };
@@ -45,24 +46,107 @@ static int32_t lastMouseX, lastMouseY, lastDrawX, lastDrawY, mouseXOffs, curSmpL
 static double dScrPosScaled, dPos2ScrMul, dScr2SmpPosMul;
 static sample_t smpCopySample;
 static SDL_Thread *thread;
+static SDL_atomic_t lastDataGeneration;
 
 // globals
 int32_t smpEd_Rx1 = 0, smpEd_Rx2 = 0;
 
+/* Sample data buffers are reference counted, so that copying a sample (or a whole instrument)
+** only shares its data. The count is stored in a small header in front of the allocation, and
+** a shared buffer is copied before its first destructive edit (see unfixSample()).
+** The float sample cache (if enabled) belongs to the buffer, so it's shared the same way.
+*/
+#define SMP_DATA_HEADER_LEN 16 // keeps the sample data alignment the same
+
+typedef struct smpDataHeader_t // must fit in SMP_DATA_HEADER_LEN
+{
+	SDL_atomic_t refCount;
+	int32_t fLength; // length of the float sample cache (0 = not built yet)
+	float *fOrigPtr;
+} smpDataHeader_t;
+
+// compile-time check (16 bytes on 64-bit, 12 on 32-bit)
+typedef char smpDataHeaderSizeCheck[(sizeof (smpDataHeader_t) <= SMP_DATA_HEADER_LEN) ? 1 : -1];
+
+static smpDataHeader_t *getDataHeader(int8_t *origPtr)
+{
+	return (smpDataHeader_t *)origPtr;
+}
+
+static SDL_atomic_t *getRefCount(int8_t *origPtr)
+{
+	return &getDataHeader(origPtr)->refCount;
+}
+
+static int8_t *allocSmpDataBuffer(int32_t numBytes)
+{
+	int8_t *newPtr = (int8_t *)malloc(SMP_DATA_HEADER_LEN + numBytes + SAMPLE_PAD_LENGTH);
+	if (newPtr != NULL)
+	{
+		smpDataHeader_t *hdr = getDataHeader(newPtr);
+		SDL_AtomicSet(&hdr->refCount, 1);
+		hdr->fLength = 0;
+		hdr->fOrigPtr = NULL;
+	}
+
+	return newPtr;
+}
+
+static void releaseSmpDataBuffer(int8_t *origPtr)
+{
+	if (SDL_AtomicDecRef(getRefCount(origPtr)))
+	{
+		smpDataHeader_t *hdr = getDataHeader(origPtr);
+		if (hdr->fOrigPtr != NULL)
+			free(hdr->fOrigPtr);
+
+		free(origPtr);
+	}
+}
+
+static float *getFloatSampleCache(const sample_t *s) // NULL = none (or not built for the current length)
+{
+	if (s->origDataPtr == NULL)
+		return NULL;
+
+	const smpDataHeader_t *hdr = getDataHeader(s->origDataPtr);
+	if (hdr->fOrigPtr == NULL || hdr->fLength != s->length)
+		return NULL;
+
+	SDL_MemoryBarrierAcquire(); // the cache is filled before fLength is set
+	return hdr->fOrigPtr + FLOAT_SMP_DATA_OFFSET;
+}
+
+const float *getFloatSampleData(const sample_t *s)
+{
+	return getFloatSampleCache(s);
+}
+
+/* Gives the sample data a new generation number, so that the autosave can tell if it was changed
+** since the last checkpoint without holding a reference to it. The numbers are unique (samples
+** can be loaded and fixed on other threads), and copies of a sample keep the number of the data.
+*/
+static void setDataGeneration(sample_t *s)
+{
+	s->dataGeneration = (uint32_t)SDL_AtomicAdd(&lastDataGeneration, 1) + 1;
+}
+
 // allocs sample with proper alignment and padding for branchless resampling interpolation
 bool allocateSmpData(sample_t *s, int32_t length, bool sample16Bit)
 {
 	if (sample16Bit)
 		length <<= 1;
 
-	s->origDataPtr = (int8_t *)malloc(length + SAMPLE_PAD_LENGTH);
+	setDataGeneration(s);
+
+	s->origDataPtr = allocSmpDataBuffer(length);
 	if (s->origDataPtr == NULL)
 	{
 		s->dataPtr = NULL;
 		return false;
 	}
 
-	s->dataPtr = s->origDataPtr + SMP_DAT_OFFSET;
+	s->dataPtr = s->origDataPtr + (SMP_DATA_HEADER_LEN + SMP_DAT_OFFSET);
 	return true;
 }
 
@@ -71,13 +155,13 @@ bool allocateSmpDataPtr(smpPtr_t *sp, int32_t length, bool sample16Bit)
 	if (sample16Bit)
 		length <<= 1;
 
-	int8_t *newPtr = (int8_t *)malloc(length + SAMPLE_PAD_LENGTH);
+	int8_t *newPtr = allocSmpDataBuffer(length);
 	if (newPtr == NULL)
 		return false;
 
 	sp->origPtr = newPtr;
 
-	sp->ptr = sp->origPtr + SMP_DAT_OFFSET;
+	sp->ptr = sp->origPtr + (SMP_DATA_HEADER_LEN + SMP_DAT_OFFSET);
 	return true;
 }
 
@@ -87,15 +171,20 @@ bool reallocateSmpData(sample_t *s, int32_t length, bool sample16Bit)
 	if (s->origDataPtr == NULL)
 		return allocateSmpData(s, length, sample16Bit);
 
+	if (!makeSampleDataUnique(s)) // the other users of the data keep the old buffer
+		return false;
+
 	if (sample16Bit)
 		length <<= 1;
 
-	int8_t *newPtr = (int8_t *)realloc(s->origDataPtr, length + SAMPLE_PAD_LENGTH);
+	int8_t *newPtr = (int8_t *)realloc(s->origDataPtr, SMP_DATA_HEADER_LEN + length + SAMPLE_PAD_LENGTH);
 	if (newPtr == NULL)
 		return false;
 
+	setDataGeneration(s);
+
 	s->origDataPtr = newPtr;
-	s->dataPtr = s->origDataPtr + SMP_DAT_OFFSET;
+	s->dataPtr = s->origDataPtr + (SMP_DATA_HEADER_LEN + SMP_DAT_OFFSET);
 
 	return true;
 }
@@ -109,18 +198,20 @@ bool reallocateSmpDataPtr(smpPtr_t *sp, int32_t length, bool sample16Bit)
 	if (sample16Bit)
 		length <<= 1;
 
-	int8_t *newPtr = (int8_t *)realloc(sp->origPtr, length + SAMPLE_PAD_LENGTH);
+	int8_t *newPtr = (int8_t *)realloc(sp->origPtr, SMP_DATA_HEADER_LEN + length + SAMPLE_PAD_LENGTH);
 	if (newPtr == NULL)
 		return false;
 
 	sp->origPtr = newPtr;
-	sp->ptr = sp->origPtr + SMP_DAT_OFFSET;
+	sp->ptr = sp->origPtr + (SMP_DATA_HEADER_LEN + SMP_DAT_OFFSET);
 
 	return true;
 }
 
 void setSmpDataPtr(sample_t *s, smpPtr_t *sp)
 {
+	setDataGeneration(s);
+
 	s->origDataPtr = sp->origPtr;
 	s->dataPtr = sp->ptr;
 }
@@ -129,29 +220,90 @@ void freeSmpDataPtr(smpPtr_t *sp)
 {
 	if (sp->origPtr != NULL)
 	{
-		free(sp->origPtr);
+		releaseSmpDataBuffer(sp->origPtr);
 		sp->origPtr = NULL;
 	}
 
 	sp->ptr = NULL;
 }
 
+int32_t getSampleDataRefCount(sample_t *s) // 0 = no sample data
+{
+	if (s->origDataPtr == NULL)
+		return 0;
+
+	return SDL_AtomicGet(getRefCount(s->origDataPtr));
+}
+
+// gives the sample its own copy of the sample data if it's shared with other samples
+bool makeSampleDataUnique(sample_t *s)
+{
+	if (getSampleDataRefCount(s) <= 1)
+		return true;
+
+	const int32_t numBytes = s->length << !!(s->flags & SAMPLE_16BIT);
+
+	int8_t *newPtr = allocSmpDataBuffer(numBytes);
+	if (newPtr == NULL)
+		return false;
+
+	// the data is copied with the fixed interpolation taps, they're the same for all users of the data
+	memcpy(newPtr + SMP_DATA_HEADER_LEN, s->origDataPtr + SMP_DATA_HEADER_LEN, numBytes + SAMPLE_PAD_LENGTH);
+
+	// ...and so is the float sample cache (if it can't be copied, the next fixSample() rebuilds it)
+	const float *fData = getFloatSampleCache(s);
+	if (fData != NULL)
+	{
+		const size_t fBytes = FLOAT_SMP_CACHE_LEN(s->length) * sizeof (float);
+
+		float *fNewPtr = (float *)malloc(fBytes);
+		if (fNewPtr != NULL)
+		{
+			memcpy(fNewPtr, fData - FLOAT_SMP_DATA_OFFSET, fBytes);
+
+			smpDataHeader_t *hdr = getDataHeader(newPtr);
+			hdr->fOrigPtr = fNewPtr;
+			hdr->fLength = s->length;
+		}
+	}
+
+	releaseSmpDataBuffer(s->origDataPtr);
+
+	s->origDataPtr = newPtr;
+	s->dataPtr = s->origDataPtr + (SMP_DATA_HEADER_LEN + SMP_DAT_OFFSET);
+
+	return true;
+}
+
+static void freeSamplePeaks(sample_t *s)
+{
+	if (s->peakData != NULL)
+	{
+		free(s->peakData);
+		s->peakData = NULL;
+	}
+
+	s->peakDataLength = 0;
+	s->peakDataValid = false;
+}
+
 void freeSmpData(sample_t *s)
 {
 	if (s->origDataPtr != NULL)
 	{
-		free(s->origDataPtr);
+		releaseSmpDataBuffer(s->origDataPtr);
 		s->origDataPtr = NULL;
 	}
 
 	s->dataPtr = NULL;
 	s->isFixed = false;
+
+	freeSamplePeaks(s);
+	setDataGeneration(s);
 }
 
-bool cloneSample(sample_t *src, sample_t *dst)
+bool cloneSample(sample_t *src, sample_t *dst) // the sample data is shared, not copied
 {
-	smpPtr_t sp;
-
 	freeSmpData(dst);
 
 	if (src == NULL)
@@ -163,29 +315,51 @@ bool cloneSample(sample_t *src, sample_t *dst)
 		memcpy(dst, src, sizeof (sample_t));
 
 		// zero out stuff that wasn't supposed to be cloned
-		dst->origDataPtr = dst->dataPtr = NULL;
-		dst->isFixed = false;
-		dst->fixedPos = 0;
+		dst->peakData = NULL;
+		dst->peakDataLength = 0;
+		dst->peakDataValid = false;
 
-		// if source sample isn't empty, allocate room and copy it over (and fix it)
+		/* If source sample isn't empty, share its data (and float sample cache). The data is
+		** already fixed, and the tap fix state (fixedSmp[], left edge taps etc.) was copied with
+		** the sample header.
+		*/
 		if (src->length > 0 && src->dataPtr != NULL)
 		{
-			bool sample16Bit = !!(src->flags & SAMPLE_16BIT);
-			if (!allocateSmpDataPtr(&sp, src->length, sample16Bit))
-			{
-				dst->length = 0;
-				return false;
-			}
-
-			setSmpDataPtr(dst, &sp);
-			memcpy(dst->dataPtr, src->dataPtr, src->length << sample16Bit);
-			fixSample(dst);
+			SDL_AtomicIncRef(getRefCount(src->origDataPtr));
+		}
+		else
+		{
+			dst->origDataPtr = dst->dataPtr = NULL;
+			dst->isFixed = false;
+			dst->fixedPos = 0;
 		}
 	}
 
 	return true;
 }
 
+// for read-only copies of a sample (f.ex. the module saver's snapshot), the sample data is shared
+void referenceSample(const sample_t *src, sample_t *dst)
+{
+	memcpy(dst, src, sizeof (sample_t));
+
+	// the copy has no peaks (they belong to the source)
+	dst->peakData = NULL;
+	dst->peakDataLength = 0;
+	dst->peakDataValid = false;
+
+	if (src->length > 0 && src->dataPtr != NULL)
+	{
+		SDL_AtomicIncRef(getRefCount(src->origDataPtr)); // released by freeSmpData()
+	}
+	else
+	{
+		dst->origDataPtr = dst->dataPtr = NULL;
+		dst->isFixed = false;
+		dst->fixedPos = 0;
+	}
+}
+
 sample_t *getCurSample(void)
 {
 	if (editor.curInstr == 0 || instr[editor.curInstr] == NULL)
@@ -224,7 +398,7 @@ static int32_t myMod(int32_t a, int32_t b) // works on negative numbers!
 }
 
 // modifies samples before index 0, and after loop/end (for branchless mixer interpolation (kinda))
-void fixSample(sample_t *s)
+static void fixSampleTaps(sample_t *s)
 {
 	int32_t pos;
 	bool backwards;
@@ -460,8 +634,116 @@ void fixSample(sample_t *s)
 	}
 }
 
-// restores interpolation tap samples after loop/end
-void unfixSample(sample_t *s)
+static void convertToFloat(const sample_t *s, float *fData, int32_t start, int32_t end) // start can be negative (left taps)
+{
+	if (s->flags & SAMPLE_16BIT)
+	{
+		const int16_t *ptr16 = (const int16_t *)s->dataPtr;
+		for (int32_t i = start; i < end; i++)
+			fData[i] = ptr16[i] * (1.0f / 32768.0f);
+	}
+	else
+	{
+		const int8_t *ptr8 = s->dataPtr;
+		for (int32_t i = start; i < end; i++)
+			fData[i] = ptr8[i] * (1.0f / 128.0f);
+	}
+}
+
+/* Converts the sample data in start..end-1 and the fixed taps on both sides to pre-scaled floats,
+** so that the mixer doesn't have to convert and scale every tap in its inner loops. The whole
+** sample is converted if the cache is new. Only done when the program was started with "--float-samples".
+*/
+static void updateFloatSampleCache(sample_t *s, int32_t start, int32_t end)
+{
+	if (s->dataPtr == NULL || s->length <= 0)
+		return;
+
+	smpDataHeader_t *hdr = getDataHeader(s->origDataPtr);
+
+	float *fData = getFloatSampleCache(s);
+	if (fData == NULL)
+	{
+		// the cache is only reallocated on length change (audio is always paused then)
+		float *newPtr = (float *)realloc(hdr->fOrigPtr, FLOAT_SMP_CACHE_LEN(s->length) * sizeof (float));
+		if (newPtr == NULL)
+		{
+			// the mixer will use the integer sample data instead
+			if (hdr->fOrigPtr != NULL)
+				free(hdr->fOrigPtr);
+
+			hdr->fOrigPtr = NULL;
+			hdr->fLength = 0;
+			return;
+		}
+
+		hdr->fOrigPtr = newPtr;
+		hdr->fLength = 0;
+
+		fData = hdr->fOrigPtr + FLOAT_SMP_DATA_OFFSET;
+		start = 0;
+		end = s->length;
+	}
+
+	if (start < 0) start = 0;
+	if (end > s->length) end = s->length;
+
+	convertToFloat(s, fData, start, end);
+
+	// the taps (the right ones are at the loop end, or after the sample end if there's no loop)
+	const int32_t tapsPos = s->isFixed ? s->fixedPos : s->length;
+	convertToFloat(s, fData, -MAX_LEFT_TAPS, 0);
+	convertToFloat(s, fData, tapsPos, tapsPos + MAX_RIGHT_TAPS);
+
+	float *fLeftEdgeTaps = FLOAT_SMP_LEFT_EDGE_TAPS(fData);
+	if (s->flags & SAMPLE_16BIT)
+	{
+		for (int32_t i = 0; i < MAX_TAPS*2; i++)
+			fLeftEdgeTaps[i] = s->leftEdgeTapSamples16[i] * (1.0f / 32768.0f);
+	}
+	else
+	{
+		for (int32_t i = 0; i < MAX_TAPS*2; i++)
+			fLeftEdgeTaps[i] = s->leftEdgeTapSamples8[i] * (1.0f / 128.0f);
+	}
+
+	if (hdr->fLength != s->length)
+	{
+		SDL_MemoryBarrierRelease(); // the mixer tests fLength before reading the cache
+		hdr->fLength = s->length;
+	}
+}
+
+void fixSample(sample_t *s)
+{
+	setDataGeneration(s); // the data may have been changed after unfixSample() (f.ex. during an autosave snapshot)
+	fixSampleTaps(s);
+
+	if (audio.floatSampleCache)
+		updateFloatSampleCache(s, 0, s->length);
+
+	s->peakDataValid = false; // sample data may have been changed, rebuild on next waveform redraw
+}
+
+void refixSample(sample_t *s) // the sample data is unchanged, so the floats and peaks only need the new taps
+{
+	fixSampleTaps(s);
+
+	if (audio.floatSampleCache)
+		updateFloatSampleCache(s, 0, 0);
+}
+
+void fixSampleAfterHandEdit(sample_t *s) // the peak pyramid and float cache were kept up to date while drawing
+{
+	setDataGeneration(s);
+	fixSampleTaps(s);
+
+	if (audio.floatSampleCache)
+		updateFloatSampleCache(s, 0, 0);
+}
+
+// restores interpolation tap samples after loop/end, without copying shared sample data
+void unfixSampleForReading(sample_t *s)
 {
 	assert(s != NULL);
 	if (s->dataPtr == NULL || !s->isFixed)
@@ -480,9 +762,66 @@ void unfixSample(sample_t *s)
 			ptr8[i] = (int8_t)s->fixedSmp[i];
 	}
 
+	// keep the float sample cache in sync, so that refixSample() only has to convert the new taps
+	float *fData = getFloatSampleCache(s);
+	if (fData != NULL)
+		convertToFloat(s, fData, s->fixedPos, s->fixedPos + MAX_RIGHT_TAPS);
+
 	s->isFixed = false;
 }
 
+/* Copies 'length' samples from 'offset' with the interpolation tap samples after loop/end
+** restored, without writing to the sample data (it may be shared, or used by another thread).
+*/
+void copyUnfixedSampleData(const sample_t *s, int8_t *dst, int32_t offset, int32_t length)
+{
+	assert(s != NULL && s->dataPtr != NULL);
+
+	if (s->flags & SAMPLE_16BIT)
+	{
+		int16_t *dst16 = (int16_t *)dst;
+		memcpy(dst16, (int16_t *)s->dataPtr + offset, length * sizeof (int16_t));
+
+		if (s->isFixed)
+		{
+			for (int32_t i = 0; i < MAX_RIGHT_TAPS; i++)
+			{
+				const int32_t pos = (s->fixedPos + i) - offset;
+				if (pos >= 0 && pos < length)
+					dst16[pos] = s->fixedSmp[i];
+			}
+		}
+	}
+	else // 8-bit
+	{
+		memcpy(dst, s->dataPtr + offset, length);
+
+		if (s->isFixed)
+		{
+			for (int32_t i = 0; i < MAX_RIGHT_TAPS; i++)
+			{
+				const int32_t pos = (s->fixedPos + i) - offset;
+				if (pos >= 0 && pos < length)
+					dst[pos] = (int8_t)s->fixedSmp[i];
+			}
+		}
+	}
+}
+
+// restores interpolation tap samples after loop/end (the sample data is about to be changed)
+void unfixSample(sample_t *s)
+{
+	assert(s != NULL);
+
+	/* Copy-on-write. If this fails, we are out of memory and the edit will be visible
+	** in the other samples sharing the data, which is better than losing the edit.
+	*/
+	makeSampleDataUnique(s);
+	setDataGeneration(s);
+
+	unfixSampleForReading(s);
+}
+
 double getSampleValue(int8_t *smpData, int32_t position, bool sample16Bit)
 {
 	if (smpData == NULL)
@@ -795,6 +1134,8 @@ static void writeRange(void)
 	assert(start+rangeLen <= SCREEN_W);
 
 	uint32_t *ptr32 = &video.frameBuffer[(174 * SCREEN_W) + start];
+	markDirtyRect(start, 174, rangeLen, SAMPLE_AREA_HEIGHT);
+
 	for (int32_t y = 0; y < SAMPLE_AREA_HEIGHT; y++)
 	{
 		for (int32_t x = 0; x < rangeLen; x++)
@@ -854,6 +1195,7 @@ void sampleLine(int32_t x1, int32_t x2, int32_t y1, int32_t y2)
 	const uint32_t pixVal = video.palette[PAL_PATTEXT];
 	const int32_t pitch = sy * SCREEN_W;
 	uint32_t *dst32 = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(MIN(x1, x2), MIN(y1, y2), ABS(dx) + 1, ABS(dy) + 1);
 
 	// draw line
 	if (ax > ay)
@@ -1185,17 +1527,12 @@ static void getSpecialMinMax8(sample_t *s, int32_t index, int32_t scanEnd, int8_
 	*max8 = maxVal;
 }
 
-static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_t *outMin, int16_t *outMax)
+// gets the min/max of the original sample data (in sample units), also where the interpolation taps are fixed
+static void getSampleMinMax(sample_t *s, int32_t index, int32_t length, int16_t *outMin, int16_t *outMax)
 {
 	int8_t min8, max8;
-	int16_t min16, max16;
 
-	if (length == 0 || s->dataPtr == NULL || s->length <= 0)
-	{
-		*outMin = SAMPLE_AREA_Y_CENTER;
-		*outMax = SAMPLE_AREA_Y_CENTER;
-		return;
-	}
+	const bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
 
 	if (s->isFixed && s->length > s->loopLength+s->loopStart)
 	{
@@ -1207,35 +1544,244 @@ static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_
 		const bool insideRange = index >= s->fixedPos && index < s->fixedPos+MAX_RIGHT_TAPS;
 		if (insideRange || (index < s->fixedPos && scanEnd >= s->fixedPos))
 		{
-			if (s->flags & SAMPLE_16BIT)
+			if (sample16Bit)
 			{
-				getSpecialMinMax16(s, index, scanEnd, &min16, &max16);
-				*outMin = SAMPLE_AREA_Y_CENTER - ((min16 * SAMPLE_AREA_HEIGHT) >> 16);
-				*outMax = SAMPLE_AREA_Y_CENTER - ((max16 * SAMPLE_AREA_HEIGHT) >> 16);
+				getSpecialMinMax16(s, index, scanEnd, outMin, outMax);
 			}
-			else // 8-bit
+			else
 			{
 				getSpecialMinMax8(s, index, scanEnd, &min8, &max8);
-				*outMin = SAMPLE_AREA_Y_CENTER - ((min8 * SAMPLE_AREA_HEIGHT) >> 8);
-				*outMax = SAMPLE_AREA_Y_CENTER - ((max8 * SAMPLE_AREA_HEIGHT) >> 8);
+				*outMin = min8;
+				*outMax = max8;
 			}
 
 			return;
 		}
 	}
 
+	if (sample16Bit)
+	{
+		getMinMax16(&((int16_t *)s->dataPtr)[index], length, outMin, outMax);
+	}
+	else
+	{
+		getMinMax8(&s->dataPtr[index], length, &min8, &max8);
+		*outMin = min8;
+		*outMax = max8;
+	}
+}
+
+/* Min/max peak pyramid: level 0 has the min/max of every PEAK_BUCKET_LEN samples, and every
+** level above that has the min/max of PEAK_LEVEL_FACTOR buckets of the level below (until a
+** single bucket is left). A zoomed out waveform column can then be looked up in a few dozen
+** buckets instead of scanning all of its sample data, so scrolling and zooming in huge samples
+** doesn't depend on the sample length anymore. The pyramid is built on the first zoomed out
+** redraw after the sample data was changed (see fixSample()), and patched while hand-drawing.
+** If the sample only got longer since (sampling appends to it without fixing it), only the new
+** level 0 buckets are scanned.
+*/
+#define PEAK_BUCKET_SHIFT 8
+#define PEAK_BUCKET_LEN (1 << PEAK_BUCKET_SHIFT)
+#define PEAK_LEVEL_SHIFT 4
+#define PEAK_LEVEL_FACTOR (1 << PEAK_LEVEL_SHIFT)
+
+static int32_t getNumPeakBuckets(int32_t length) // level 0
+{
+	return (length + (PEAK_BUCKET_LEN-1)) >> PEAK_BUCKET_SHIFT;
+}
+
+static void updateLevel0PeakBuckets(sample_t *s, int32_t first, int32_t last) // buckets first..last-1
+{
+	int16_t *peaks = s->peakData;
+	for (int32_t i = first; i < last; i++)
+	{
+		const int32_t index = i << PEAK_BUCKET_SHIFT;
+
+		int32_t length = s->length - index;
+		if (length > PEAK_BUCKET_LEN)
+			length = PEAK_BUCKET_LEN;
+
+		getSampleMinMax(s, index, length, &peaks[(i*2)+0], &peaks[(i*2)+1]);
+	}
+}
+
+static void updateUpperPeakLevels(sample_t *s, int32_t first, int32_t last) // after changing level 0 buckets first..last-1
+{
+	int16_t *peaks = s->peakData;
+
+	int32_t numBuckets = getNumPeakBuckets(s->length);
+	while (numBuckets > 1)
+	{
+		const int16_t *src = peaks;
+		peaks += numBuckets * 2;
+
+		const int32_t numSrcBuckets = numBuckets;
+		numBuckets = (numBuckets + (PEAK_LEVEL_FACTOR-1)) >> PEAK_LEVEL_SHIFT;
+
+		first >>= PEAK_LEVEL_SHIFT;
+		last = (last + (PEAK_LEVEL_FACTOR-1)) >> PEAK_LEVEL_SHIFT;
+
+		for (int32_t i = first; i < last; i++)
+		{
+			int32_t j = i << PEAK_LEVEL_SHIFT;
+
+			int32_t jEnd = j + PEAK_LEVEL_FACTOR;
+			if (jEnd > numSrcBuckets)
+				jEnd = numSrcBuckets;
+
+			int16_t minVal = src[(j*2)+0];
+			int16_t maxVal = src[(j*2)+1];
+			for (j++; j < jEnd; j++)
+			{
+				if (src[(j*2)+0] < minVal) minVal = src[(j*2)+0];
+				if (src[(j*2)+1] > maxVal) maxVal = src[(j*2)+1];
+			}
+
+			peaks[(i*2)+0] = minVal;
+			peaks[(i*2)+1] = maxVal;
+		}
+	}
+}
+
+static void updatePeakBuckets(sample_t *s, int32_t first, int32_t last) // updates level 0 buckets first..last-1 and all levels above
+{
+	updateLevel0PeakBuckets(s, first, last);
+	updateUpperPeakLevels(s, first, last);
+}
+
+static bool buildSamplePeaks(sample_t *s)
+{
+	int32_t numBuckets = getNumPeakBuckets(s->length);
+
+	int32_t totalBuckets = numBuckets;
+	while (numBuckets > 1)
+	{
+		numBuckets = (numBuckets + (PEAK_LEVEL_FACTOR-1)) >> PEAK_LEVEL_SHIFT;
+		totalBuckets += numBuckets;
+	}
+
+	// if the sample was only appended to since, keep the old level 0 buckets (they stay at the start of the buffer)
+	const bool extend = s->peakDataValid && s->peakData != NULL && s->peakDataLength > 0 && s->peakDataLength < s->length;
+	const int32_t firstNewBucket = extend ? (s->peakDataLength >> PEAK_BUCKET_SHIFT) : 0; // the old last one may be partial
+
+	if (s->peakData == NULL || s->peakDataLength != s->length)
+	{
+		int16_t *newPtr = (int16_t *)realloc(s->peakData, totalBuckets * 2 * sizeof (int16_t));
+		if (newPtr == NULL)
+		{
+			freeSamplePeaks(s); // scan the sample data instead
+			return false;
+		}
+
+		s->peakData = newPtr;
+		s->peakDataLength = s->length;
+	}
+
+	const int32_t numLevel0Buckets = getNumPeakBuckets(s->length);
+	updateLevel0PeakBuckets(s, firstNewBucket, numLevel0Buckets);
+	updateUpperPeakLevels(s, 0, numLevel0Buckets);
+	s->peakDataValid = true;
+
+	return true;
+}
+
+static void updateSamplePeaks(sample_t *s, int32_t start, int32_t end) // after changing sample data in start..end-1
+{
+	if (!s->peakDataValid || s->peakDataLength != s->length || start >= end)
+		return; // will be (re)built on next use
+
+	updatePeakBuckets(s, start >> PEAK_BUCKET_SHIFT, getNumPeakBuckets(end));
+}
+
+static bool getPeakPyramidMinMax(sample_t *s, int32_t index, int32_t length, int16_t *outMin, int16_t *outMax)
+{
+	int16_t minVal2, maxVal2;
+
+	const int32_t end = index + length;
+
+	// whole buckets in range
+	int32_t i0 = (index + (PEAK_BUCKET_LEN-1)) >> PEAK_BUCKET_SHIFT;
+	int32_t i1 = end >> PEAK_BUCKET_SHIFT;
+	if (i0 >= i1)
+		return false; // too short, scan the sample data instead
+
+	if (!s->peakDataValid || s->peakDataLength != s->length)
+	{
+		if (!buildSamplePeaks(s))
+			return false;
+	}
+
+	int16_t minVal = INT16_MAX;
+	int16_t maxVal = INT16_MIN;
+
+	// partial buckets at the edges
+	if (index < (i0 << PEAK_BUCKET_SHIFT))
+	{
+		getSampleMinMax(s, index, (i0 << PEAK_BUCKET_SHIFT) - index, &minVal2, &maxVal2);
+		if (minVal2 < minVal) minVal = minVal2;
+		if (maxVal2 > maxVal) maxVal = maxVal2;
+	}
+
+	if (end > (i1 << PEAK_BUCKET_SHIFT))
+	{
+		getSampleMinMax(s, i1 << PEAK_BUCKET_SHIFT, end - (i1 << PEAK_BUCKET_SHIFT), &minVal2, &maxVal2);
+		if (minVal2 < minVal) minVal = minVal2;
+		if (maxVal2 > maxVal) maxVal = maxVal2;
+	}
+
+	// take the unaligned buckets on each level, and go one level up for the rest
+	const int16_t *peaks = s->peakData;
+	int32_t numBuckets = getNumPeakBuckets(s->length);
+	while (i0 < i1)
+	{
+		while (i0 < i1 && (i0 & (PEAK_LEVEL_FACTOR-1)) != 0)
+		{
+			if (peaks[(i0*2)+0] < minVal) minVal = peaks[(i0*2)+0];
+			if (peaks[(i0*2)+1] > maxVal) maxVal = peaks[(i0*2)+1];
+			i0++;
+		}
+
+		while (i1 > i0 && (i1 & (PEAK_LEVEL_FACTOR-1)) != 0)
+		{
+			i1--;
+			if (peaks[(i1*2)+0] < minVal) minVal = peaks[(i1*2)+0];
+			if (peaks[(i1*2)+1] > maxVal) maxVal = peaks[(i1*2)+1];
+		}
+
+		peaks += numBuckets * 2;
+		numBuckets = (numBuckets + (PEAK_LEVEL_FACTOR-1)) >> PEAK_LEVEL_SHIFT;
+		i0 >>= PEAK_LEVEL_SHIFT;
+		i1 >>= PEAK_LEVEL_SHIFT;
+	}
+
+	*outMin = minVal;
+	*outMax = maxVal;
+	return true;
+}
+
+static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_t *outMin, int16_t *outMax)
+{
+	int16_t minVal, maxVal;
+
+	if (length == 0 || s->dataPtr == NULL || s->length <= 0)
+	{
+		*outMin = SAMPLE_AREA_Y_CENTER;
+		*outMax = SAMPLE_AREA_Y_CENTER;
+		return;
+	}
+
+	if (!getPeakPyramidMinMax(s, index, length, &minVal, &maxVal))
+		getSampleMinMax(s, index, length, &minVal, &maxVal);
+
 	if (s->flags & SAMPLE_16BIT)
 	{
-		const int16_t *smpPtr16 = (int16_t *)s->dataPtr;
-		getMinMax16(&smpPtr16[index], length, &min16, &max16);
-		*outMin = SAMPLE_AREA_Y_CENTER - ((min16 * SAMPLE_AREA_HEIGHT) >> 16);
-		*outMax = SAMPLE_AREA_Y_CENTER - ((max16 * SAMPLE_AREA_HEIGHT) >> 16);
+		*outMin = SAMPLE_AREA_Y_CENTER - ((minVal * SAMPLE_AREA_HEIGHT) >> 16);
+		*outMax = SAMPLE_AREA_Y_CENTER - ((maxVal * SAMPLE_AREA_HEIGHT) >> 16);
 	}
 	else // 8-bit
 	{
-		getMinMax8(&s->dataPtr[index], length, &min8, &max8);
-		*outMin = SAMPLE_AREA_Y_CENTER - ((min8 * SAMPLE_AREA_HEIGHT) >> 8);
-		*outMax = SAMPLE_AREA_Y_CENTER - ((max8 * SAMPLE_AREA_HEIGHT) >> 8);
+		*outMin = SAMPLE_AREA_Y_CENTER - ((minVal * SAMPLE_AREA_HEIGHT) >> 8);
+		*outMax = SAMPLE_AREA_Y_CENTER - ((maxVal * SAMPLE_AREA_HEIGHT) >> 8);
 	}
 }
 
@@ -1243,6 +1789,7 @@ static void writeWaveform(void)
 {
 	// clear sample data area
 	memset(&video.frameBuffer[174 * SCREEN_W], 0, SAMPLE_AREA_WIDTH * SAMPLE_AREA_HEIGHT * sizeof (int32_t));
+	markDirtyRect(0, 174, SAMPLE_AREA_WIDTH, SAMPLE_AREA_HEIGHT);
 
 	// draw center line
 	hLine(0, SAMPLE_AREA_Y_CENTER, SAMPLE_AREA_WIDTH, PAL_DESKTOP);
@@ -2024,9 +2571,9 @@ static int32_t SDLCALL sampCopyThread(void *ptr)
 		return true;
 	}
 
-	unfixSample(s);
+	unfixSampleForReading(s);
 	memcpy(smpCopyBuff, &s->dataPtr[smpEd_Rx1 << sample16Bit], (smpEd_Rx2-smpEd_Rx1) << sample16Bit);
-	fixSample(s);
+	refixSample(s);
 
 	setMouseBusy(false);
 
@@ -2586,7 +3133,7 @@ void rbSampleNoLoop(void)
 
 	DISABLE_LOOP(s->flags);
 
-	fixSample(s);
+	refixSample(s);
 	unlockMixerCallback();
 
 	updateSampleEditor();
@@ -2612,7 +3159,7 @@ void rbSampleForwardLoop(void)
 		s->loopLength = s->length;
 	}
 
-	fixSample(s);
+	refixSample(s);
 	unlockMixerCallback();
 
 	updateSampleEditor();
@@ -2638,7 +3185,7 @@ void rbSamplePingpongLoop(void)
 		s->loopLength = s->length;
 	}
 
-	fixSample(s);
+	refixSample(s);
 	unlockMixerCallback();
 
 	updateSampleEditor();
@@ -2646,17 +3193,58 @@ void rbSamplePingpongLoop(void)
 	setSongModifiedFlag();
 }
 
+typedef struct smpJob_t // sample operation data for parallelFor()
+{
+	int8_t *ptr8;
+	int16_t *ptr16;
+	const int8_t *src8;
+	const int16_t *src16;
+	int32_t length, smpSub;
+	int64_t sum;
+} smpJob_t;
+
+static void convTo8BitChunk(int32_t start, int32_t end, void *userData)
+{
+	smpJob_t *j = (smpJob_t *)userData;
+	for (int32_t i = start; i < end; i++)
+		j->ptr8[i] = j->src16[i] >> 8;
+}
+
+static void convTo16BitChunk(int32_t start, int32_t end, void *userData)
+{
+	smpJob_t *j = (smpJob_t *)userData;
+	for (int32_t i = start; i < end; i++)
+		j->ptr16[i] = j->src8[i] << 8;
+}
+
 static int32_t SDLCALL convSmp8Bit(void *ptr)
 {
+	smpJob_t job;
+
 	sample_t *s = getCurSample();
 	assert(s->dataPtr != NULL);
 
 	pauseAudio();
 	unfixSample(s);
 
-	const int16_t *src16 = (const int16_t *)s->dataPtr;
-	for (int32_t i = 0; i < s->length; i++)
-		s->dataPtr[i] = src16[i] >> 8;
+	// the conversion is done in place, so the chunks need a copy of the source data to be independent
+	int16_t *tmp16 = (int16_t *)malloc(s->length * sizeof (int16_t));
+	if (tmp16 != NULL)
+	{
+		memcpy(tmp16, s->dataPtr, s->length * sizeof (int16_t));
+
+		job.ptr8 = s->dataPtr;
+		job.src16 = tmp16;
+		parallelFor(s->length, convTo8BitChunk, &job);
+
+		free(tmp16);
+	}
+	else
+	{
+		const int16_t *src16 = (const int16_t *)s->dataPtr;
+		for (int32_t i = 0; i < s->length; i++)
+			s->dataPtr[i] = src16[i] >> 8;
+	}
 
 	reallocateSmpData(s, s->length, false);
 
@@ -2724,9 +3312,26 @@ static int32_t SDLCALL convSmp16Bit(void *ptr)
 		return true;
 	}
 
-	int16_t *dst16 = (int16_t *)s->dataPtr;
-	for (int32_t i = s->length-1; i >= 0; i--)
-		dst16[i] = s->dataPtr[i] << 8;
+	// the conversion is done in place, so the chunks need a copy of the source data to be independent
+	int8_t *tmp8 = (int8_t *)malloc(s->length);
+	if (tmp8 != NULL)
+	{
+		smpJob_t job;
+
+		memcpy(tmp8, s->dataPtr, s->length);
+
+		job.ptr16 = (int16_t *)s->dataPtr;
+		job.src8 = tmp8;
+		parallelFor(s->length, convTo16BitChunk, &job);
+
+		free(tmp8);
+	}
+	else
+	{
+		int16_t *dst16 = (int16_t *)s->dataPtr;
+		for (int32_t i = s->length-1; i >= 0; i--)
+			dst16[i] = s->dataPtr[i] << 8;
+	}
 
 	s->flags |= SAMPLE_16BIT;
 
@@ -3044,6 +3649,8 @@ static void invertSamplePosLine(int32_t x)
 		return;
 
 	uint32_t *ptr32 = &video.frameBuffer[(174 * SCREEN_W) + x];
+	markDirtyRect(x, 174, 1, SAMPLE_AREA_HEIGHT);
+
 	for (int32_t y = 0; y < SAMPLE_AREA_HEIGHT; y++, ptr32 += SCREEN_W)
 		*ptr32 = video.palette[(*ptr32 >> 24) ^ 1]; // ">> 24" to get palette, XOR 1 to switch between normal/inverted mode
 }
@@ -3322,6 +3929,10 @@ static void editSampleData(bool mouseButtonHeld)
 		}
 	}
 
+	updateSamplePeaks(s, start, end);
+	if (audio.floatSampleCache)
+		updateFloatSampleCache(s, start, end);
+
 	lastDrawY = rvl;
 	lastDrawX = r;
 
@@ -3532,68 +4143,67 @@ void toggleSampleEditorExt(void)
 		showSampleEditorExt();
 }
 
+static void reverse8Chunk(int32_t start, int32_t end, void *userData) // swaps pairs from both ends
+{
+	smpJob_t *j = (smpJob_t *)userData;
+
+	int8_t *ptrStart = &j->ptr8[start];
+	int8_t *ptrEnd = &j->ptr8[(j->length-1) - start];
+	for (int32_t i = start; i < end; i++)
+	{
+		const int8_t tmp8 = *ptrStart;
+		*ptrStart++ = *ptrEnd;
+		*ptrEnd-- = tmp8;
+	}
+}
+
+static void reverse16Chunk(int32_t start, int32_t end, void *userData) // swaps pairs from both ends
+{
+	smpJob_t *j = (smpJob_t *)userData;
+
+	int16_t *ptrStart16 = &j->ptr16[start];
+	int16_t *ptrEnd16 = &j->ptr16[(j->length-1) - start];
+	for (int32_t i = start; i < end; i++)
+	{
+		const int16_t tmp16 = *ptrStart16;
+		*ptrStart16++ = *ptrEnd16;
+		*ptrEnd16-- = tmp16;
+	}
+}
+
 static int32_t SDLCALL sampleBackwardsThread(void *ptr)
 {
-	int8_t tmp8, *ptrStart, *ptrEnd;
-	int16_t tmp16, *ptrStart16, *ptrEnd16;
+	smpJob_t job;
 
 	const bool sampleDataMarked = (smpEd_Rx1 != smpEd_Rx2);
 	sample_t *s = getCurSample();
-	const bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
 
-	if (sample16Bit)
-	{
-		if (!sampleDataMarked)
-		{
-			ptrStart16 = (int16_t *)s->dataPtr;
-			ptrEnd16 = (int16_t *)s->dataPtr + (s->length-1);
-		}
-		else
-		{
-			ptrStart16 = (int16_t *)s->dataPtr + smpEd_Rx1;
-			ptrEnd16 = (int16_t *)s->dataPtr + (smpEd_Rx2-1);
-		}
+	int32_t start = 0;
+	job.length = s->length;
 
-		pauseAudio();
-		unfixSample(s);
+	if (sampleDataMarked)
+	{
+		start = smpEd_Rx1;
+		job.length = smpEd_Rx2 - smpEd_Rx1;
+	}
 
-		while (ptrStart16 < ptrEnd16)
-		{
-			tmp16 = *ptrStart16;
-			*ptrStart16++ = *ptrEnd16;
-			*ptrEnd16-- = tmp16;
-		}
+	pauseAudio();
+	unfixSample(s);
 
-		fixSample(s);
-		resumeAudio();
+	if (s->flags & SAMPLE_16BIT)
+	{
+		job.ptr16 = (int16_t *)s->dataPtr + start;
+		parallelFor(job.length >> 1, reverse16Chunk, &job);
 	}
 	else
 	{
-		if (!sampleDataMarked)
-		{
-			ptrStart = s->dataPtr;
-			ptrEnd = &s->dataPtr[s->length-1];
-		}
-		else
-		{
-			ptrStart = &s->dataPtr[smpEd_Rx1];
-			ptrEnd = &s->dataPtr[smpEd_Rx2-1];
-		}
-
-		pauseAudio();
-		unfixSample(s);
-
-		while (ptrStart < ptrEnd)
-		{
-			tmp8 = *ptrStart;
-			*ptrStart++ = *ptrEnd;
-			*ptrEnd-- = tmp8;
-		}
-
-		fixSample(s);
-		resumeAudio();
+		job.ptr8 = &s->dataPtr[start];
+		parallelFor(job.length >> 1, reverse8Chunk, &job);
 	}
 
+	fixSample(s);
+	resumeAudio();
+
 	setSongModifiedFlag();
 	setMouseBusy(false);
 
@@ -3620,8 +4230,24 @@ void sampleBackwards(void)
 	SDL_DetachThread(thread);
 }
 
+static void changeSign8Chunk(int32_t start, int32_t end, void *userData)
+{
+	int8_t *ptr8 = ((smpJob_t *)userData)->ptr8;
+	for (int32_t i = start; i < end; i++)
+		ptr8[i] ^= 0x80;
+}
+
+static void changeSign16Chunk(int32_t start, int32_t end, void *userData)
+{
+	int16_t *ptr16 = ((smpJob_t *)userData)->ptr16;
+	for (int32_t i = start; i < end; i++)
+		ptr16[i] ^= 0x8000;
+}
+
 static int32_t SDLCALL sampleChangeSignThread(void *ptr)
 {
+	smpJob_t job;
+
 	sample_t *s = getCurSample();
 
 	pauseAudio();
@@ -3629,15 +4255,13 @@ static int32_t SDLCALL sampleChangeSignThread(void *ptr)
 
 	if (s->flags & SAMPLE_16BIT)
 	{
-		int16_t *ptr16 = (int16_t *)s->dataPtr;
-		for (int32_t i = 0; i < s->length; i++)
-			ptr16[i] ^= 0x8000;
+		job.ptr16 = (int16_t *)s->dataPtr;
+		parallelFor(s->length, changeSign16Chunk, &job);
 	}
 	else
 	{
-		int8_t *ptr8 = s->dataPtr;
-		for (int32_t i = 0; i < s->length; i++)
-			ptr8[i] ^= 0x80;
+		job.ptr8 = s->dataPtr;
+		parallelFor(s->length, changeSign8Chunk, &job);
 	}
 
 	fixSample(s);
@@ -3669,8 +4293,21 @@ void sampleChangeSign(void)
 	SDL_DetachThread(thread);
 }
 
+static void byteSwapChunk(int32_t start, int32_t end, void *userData)
+{
+	int8_t *ptr8 = &((smpJob_t *)userData)->ptr8[start << 1];
+	for (int32_t i = start; i < end; i++, ptr8 += 2)
+	{
+		const int8_t tmp = ptr8[0];
+		ptr8[0] = ptr8[1];
+		ptr8[1] = tmp;
+	}
+}
+
 static int32_t SDLCALL sampleByteSwapThread(void *ptr)
 {
+	smpJob_t job;
+
 	sample_t *s = getCurSample();
 
 	pauseAudio();
@@ -3680,13 +4317,8 @@ static int32_t SDLCALL sampleByteSwapThread(void *ptr)
 	if (!(s->flags & SAMPLE_16BIT))
 		length >>= 1;
 
-	int8_t *ptr8 = s->dataPtr;
-	for (int32_t i = 0; i < length; i++, ptr8 += 2)
-	{
-		const int8_t tmp = ptr8[0];
-		ptr8[0] = ptr8[1];
-		ptr8[1] = tmp;
-	}
+	job.ptr8 = s->dataPtr;
+	parallelFor(length, byteSwapChunk, &job);
 
 	fixSample(s);
 	resumeAudio();
@@ -3723,91 +4355,96 @@ void sampleByteSwap(void)
 	SDL_DetachThread(thread);
 }
 
-static int32_t SDLCALL fixDCThread(void *ptr)
+static void sumDC8Chunk(int32_t start, int32_t end, void *userData)
 {
-	int8_t *ptr8;
-	int16_t *ptr16;
-	int32_t length;
+	smpJob_t *j = (smpJob_t *)userData;
 
-	const bool sampleDataMarked = (smpEd_Rx1 != smpEd_Rx2);
-	sample_t *s = getCurSample();
+	int64_t sum = 0;
+	for (int32_t i = start; i < end; i++)
+		sum += j->ptr8[i];
 
-	if (s->flags & SAMPLE_16BIT)
-	{
-		if (!sampleDataMarked)
-		{
-			ptr16 = (int16_t *)s->dataPtr;
-			length = s->length;
-		}
-		else
-		{
-			ptr16 = (int16_t *)&s->dataPtr + smpEd_Rx1;
-			length = smpEd_Rx2 - smpEd_Rx1;
-		}
+	lockParallelResult();
+	j->sum += sum;
+	unlockParallelResult();
+}
 
-		if (length < 0 || length > s->length)
-		{
-			setMouseBusy(false);
-			return true;
-		}
+static void sumDC16Chunk(int32_t start, int32_t end, void *userData)
+{
+	smpJob_t *j = (smpJob_t *)userData;
 
-		pauseAudio();
-		unfixSample(s);
+	int64_t sum = 0;
+	for (int32_t i = start; i < end; i++)
+		sum += j->ptr16[i];
 
-		int64_t	averageDC = 0;
-		for (int32_t i = 0; i < length; i++)
-			averageDC += ptr16[i];
-		averageDC = (averageDC + (length>>1)) / length; // rounded
+	lockParallelResult();
+	j->sum += sum;
+	unlockParallelResult();
+}
 
-		const int32_t smpSub = (int32_t)averageDC;
-		for (int32_t i = 0; i < length; i++)
-		{
-			int32_t smp32 = ptr16[i] - smpSub;
-			CLAMP16(smp32);
-			ptr16[i] = (int16_t)smp32;
-		}
+static void subDC8Chunk(int32_t start, int32_t end, void *userData)
+{
+	smpJob_t *j = (smpJob_t *)userData;
+	for (int32_t i = start; i < end; i++)
+	{
+		int32_t smp32 = j->ptr8[i] - j->smpSub;
+		CLAMP8(smp32);
+		j->ptr8[i] = (int8_t)smp32;
+	}
+}
 
-		fixSample(s);
-		resumeAudio();
+static void subDC16Chunk(int32_t start, int32_t end, void *userData)
+{
+	smpJob_t *j = (smpJob_t *)userData;
+	for (int32_t i = start; i < end; i++)
+	{
+		int32_t smp32 = j->ptr16[i] - j->smpSub;
+		CLAMP16(smp32);
+		j->ptr16[i] = (int16_t)smp32;
 	}
-	else // 8-bit
+}
+
+static int32_t SDLCALL fixDCThread(void *ptr)
+{
+	smpJob_t job;
+	int32_t start, length;
+
+	const bool sampleDataMarked = (smpEd_Rx1 != smpEd_Rx2);
+	sample_t *s = getCurSample();
+
+	if (!sampleDataMarked)
 	{
-		if (!sampleDataMarked)
-		{
-			ptr8 = s->dataPtr;
-			length = s->length;
-		}
-		else
-		{
-			ptr8 = &s->dataPtr[smpEd_Rx1];
-			length = smpEd_Rx2 - smpEd_Rx1;
-		}
+		start = 0;
+		length = s->length;
+	}
+	else
+	{
+		start = smpEd_Rx1;
+		length = smpEd_Rx2 - smpEd_Rx1;
+	}
 
-		if (length < 0 || length > s->length)
-		{
-			setMouseBusy(false);
-			return true;
-		}
+	if (length <= 0 || length > s->length)
+	{
+		setMouseBusy(false);
+		return true;
+	}
 
-		pauseAudio();
-		unfixSample(s);
+	pauseAudio();
+	unfixSample(s);
 
-		int64_t	averageDC = 0;
-		for (int32_t i = 0; i < length; i++)
-			averageDC += ptr8[i];
-		averageDC = (averageDC + (length>>1)) / length; // rounded
+	const bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
+	if (sample16Bit)
+		job.ptr16 = (int16_t *)s->dataPtr + start;
+	else
+		job.ptr8 = &s->dataPtr[start];
 
-		const int32_t smpSub = (int32_t)averageDC;
-		for (int32_t i = 0; i < length; i++)
-		{
-			int32_t smp32 = ptr8[i] - smpSub;
-			CLAMP8(smp32);
-			ptr8[i] = (int8_t)smp32;
-		}
+	job.sum = 0;
+	parallelFor(length, sample16Bit ? sumDC16Chunk : sumDC8Chunk, &job);
 
-		fixSample(s);
-		resumeAudio();
-	}
+	job.smpSub = (int32_t)((job.sum + (length>>1)) / length); // rounded
+	parallelFor(length, sample16Bit ? subDC16Chunk : subDC8Chunk, &job);
+
+	fixSample(s);
+	resumeAudio();
 
 	setSongModifiedFlag();
 	setMouseBusy(false);
@@ -3858,7 +4495,7 @@ void testSmpEdMouseUp(void) // used for setting new loop points
 			unfixSample(s);
 			s->loopStart = curSmpLoopStart;
 			s->loopLength = curSmpLoopLength;
-			fixSample(s);
+			refixSample(s);
 			unlockMixerCallback();
 
 			setSongModifiedFlag();
@@ -7,6 +7,11 @@
 #define SAMPLE_AREA_WIDTH 632
 #define SAMPLE_AREA_Y_CENTER 250
 
+// float sample cache layout: the left edge taps (for loops), then the sample data with the taps on both sides
+#define FLOAT_SMP_CACHE_LEN(length) ((MAX_TAPS*2) + (length) + MAX_TAPS)
+#define FLOAT_SMP_DATA_OFFSET ((MAX_TAPS*2) + MAX_LEFT_TAPS)
+#define FLOAT_SMP_LEFT_EDGE_TAPS(fData) ((fData) - FLOAT_SMP_DATA_OFFSET)
+
 // allocs sample with proper alignment and padding for branchless resampling interpolation
 bool allocateSmpData(sample_t *s, int32_t length, bool sample16Bit);
 bool allocateSmpDataPtr(smpPtr_t *sp, int32_t length, bool sample16Bit);
@@ -20,10 +25,18 @@ void freeSmpDataPtr(smpPtr_t *sp);
 void freeSmpData(sample_t *s);
 
 bool cloneSample(sample_t *src, sample_t *dst);
+void referenceSample(const sample_t *src, sample_t *dst); // shares the data, release with freeSmpData()
 sample_t *getCurSample(void);
 void sanitizeSample(sample_t *s);
 void fixSample(sample_t *s); // modifies samples before index 0, and after loop/end (for branchless mixer interpolation)
-void unfixSample(sample_t *s); // restores samples after loop/end
+void unfixSample(sample_t *s); // restores samples after loop/end (and unshares the sample data)
+void refixSample(sample_t *s); // same as fixSample(), but the sample data must be unchanged since unfixing (f.ex. loop changes)
+void unfixSampleForReading(sample_t *s); // same as unfixSample(), but the data must be left unchanged for refixSample()
+void copyUnfixedSampleData(const sample_t *s, int8_t *dst, int32_t offset, int32_t length);
+bool makeSampleDataUnique(sample_t *s); // copy-on-write for shared sample data
+int32_t getSampleDataRefCount(sample_t *s);
+void fixSampleAfterHandEdit(sample_t *s); // same as fixSample(), but the peaks and float cache were patched while drawing
+const float *getFloatSampleData(const sample_t *s); // float sample cache (shared with the sample data), NULL if none
 void clearSample(void);
 void clearCopyBuffer(void);
 int32_t getSampleMiddleCRate(sample_t *s);
@@ -14,6 +14,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h>
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+#include <emmintrin.h>
+#endif
 #include "ft2_header.h"
 #include "ft2_mouse.h"
 #include "ft2_audio.h"
@@ -25,11 +28,13 @@
 #include "ft2_keyboard.h"
 #include "ft2_tables.h"
 #include "ft2_structs.h"
+#include "ft2_workers.h"
+#include "mixer/ft2_windowed_sinc.h"
 
 static volatile bool stopThread;
 
 static int8_t smpEd_RelReSmp, mix_Balance = 50;
-static bool echo_AddMemory, exitFlag, outOfMemory;
+static bool echo_AddMemory, resample_Sinc, exitFlag, outOfMemory;
 static int16_t echo_nEcho = 1, echo_VolChange = 30;
 static int32_t echo_Distance = 0x100;
 static double dVol_StartVol = 100.0, dVol_EndVol = 100.0;
@@ -80,9 +85,190 @@ static void pbResampleTonesUp(void)
 		smpEd_RelReSmp++;
 }
 
+/* Band-limited resampling uses the mixer's 32-point windowed-sinc LUTs (either layout),
+** with the LUT chosen from the resampling ratio the same way updateVoices() does it.
+** The sample is treated as silent outside of its data (loops are not wrapped).
+*/
+#define RESAMPLE_TAPS SINC2_TAPS
+#define RESAMPLE_LEFT_TAPS ((SINC2_TAPS/2)-1)
+#define RESAMPLE_RIGHT_TAPS (SINC2_TAPS/2)
+
+typedef struct resampleJob_t // for parallelFor()
+{
+	const int8_t *src8;
+	const int16_t *src16;
+	int8_t *dst8;
+	int16_t *dst16;
+	int32_t srcLength;
+	uint64_t delta64;
+	const float *fLUT;
+} resampleJob_t;
+
+static const float *getResampleTaps(const resampleJob_t *j, uint32_t frac, float *fTapsOut)
+{
+	if (!sincTablesCompact)
+		return j->fLUT + ((frac >> SINC32_FSHIFT) & SINC32_FMASK);
+
+	// same as WINDOWED_SINC32_COMPACT_INTERPOLATION (mixer/ft2_mix_macros.h)
+	const float *t = j->fLUT + ((frac >> SINC32_COMPACT_FSHIFT) & SINC32_COMPACT_FMASK);
+	const int32_t phaseFrac = (uint32_t)(frac << SINC_COMPACT_PHASES_BITS) >> 1;
+	const float fPhaseFrac = phaseFrac * (1.0f / (MIXER_FRAC_SCALE/2));
+
+	for (int32_t i = 0; i < RESAMPLE_TAPS; i++)
+		fTapsOut[i] = t[i] + (t[RESAMPLE_TAPS+i] * fPhaseFrac);
+
+	return fTapsOut;
+}
+
+static float sincResample8(const int8_t *s, const float *t) // s = first tap sample
+{
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		__m128 fSum1 = _mm_setzero_ps();
+		__m128 fSum2 = _mm_setzero_ps();
+
+		for (int32_t i = 0; i < RESAMPLE_TAPS; i += 16, s += 16, t += 16)
+		{
+			const __m128i smp8 = _mm_loadu_si128((const __m128i *)s);
+			const __m128i smp16[2] =
+			{
+				_mm_srai_epi16(_mm_unpacklo_epi8(smp8, smp8), 8),
+				_mm_srai_epi16(_mm_unpackhi_epi8(smp8, smp8), 8)
+			};
+
+			for (int32_t k = 0; k < 2; k++)
+			{
+				const __m128i smp32L = _mm_srai_epi32(_mm_unpacklo_epi16(smp16[k], smp16[k]), 16);
+				const __m128i smp32H = _mm_srai_epi32(_mm_unpackhi_epi16(smp16[k], smp16[k]), 16);
+
+				fSum1 = _mm_add_ps(fSum1, _mm_mul_ps(_mm_cvtepi32_ps(smp32L), _mm_loadu_ps(&t[(k*8)+0])));
+				fSum2 = _mm_add_ps(fSum2, _mm_mul_ps(_mm_cvtepi32_ps(smp32H), _mm_loadu_ps(&t[(k*8)+4])));
+			}
+		}
+
+		fSum1 = _mm_add_ps(fSum1, fSum2);
+		fSum1 = _mm_add_ps(fSum1, _mm_movehl_ps(fSum1, fSum1));
+		fSum1 = _mm_add_ss(fSum1, _mm_shuffle_ps(fSum1, fSum1, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(fSum1);
+	}
+#endif
+
+	float fSample = 0.0f;
+	for (int32_t i = 0; i < RESAMPLE_TAPS; i++)
+		fSample += s[i] * t[i];
+
+	return fSample;
+}
+
+static float sincResample16(const int16_t *s, const float *t) // s = first tap sample
+{
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		__m128 fSum1 = _mm_setzero_ps();
+		__m128 fSum2 = _mm_setzero_ps();
+
+		for (int32_t i = 0; i < RESAMPLE_TAPS; i += 8, s += 8, t += 8)
+		{
+			const __m128i smp16 = _mm_loadu_si128((const __m128i *)s);
+			const __m128i smp32L = _mm_srai_epi32(_mm_unpacklo_epi16(smp16, smp16), 16);
+			const __m128i smp32H = _mm_srai_epi32(_mm_unpackhi_epi16(smp16, smp16), 16);
+
+			fSum1 = _mm_add_ps(fSum1, _mm_mul_ps(_mm_cvtepi32_ps(smp32L), _mm_loadu_ps(&t[0])));
+			fSum2 = _mm_add_ps(fSum2, _mm_mul_ps(_mm_cvtepi32_ps(smp32H), _mm_loadu_ps(&t[4])));
+		}
+
+		fSum1 = _mm_add_ps(fSum1, fSum2);
+		fSum1 = _mm_add_ps(fSum1, _mm_movehl_ps(fSum1, fSum1));
+		fSum1 = _mm_add_ss(fSum1, _mm_shuffle_ps(fSum1, fSum1, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(fSum1);
+	}
+#endif
+
+	float fSample = 0.0f;
+	for (int32_t i = 0; i < RESAMPLE_TAPS; i++)
+		fSample += s[i] * t[i];
+
+	return fSample;
+}
+
+static float sincResampleEdge(const resampleJob_t *j, int32_t position, const float *t) // taps outside of the sample are zero
+{
+	float fSample = 0.0f;
+	for (int32_t i = 0; i < RESAMPLE_TAPS; i++)
+	{
+		const int32_t index = (position - RESAMPLE_LEFT_TAPS) + i;
+		if (index >= 0 && index < j->srcLength)
+			fSample += (j->src16 != NULL ? j->src16[index] : j->src8[index]) * t[i];
+	}
+
+	return fSample;
+}
+
+static void resampleSincChunk(int32_t start, int32_t end, void *userData)
+{
+	float fTaps[RESAMPLE_TAPS], fSample;
+
+	const resampleJob_t *j = (const resampleJob_t *)userData;
+
+	// 32.32 fixed-point logic
+	uint64_t posFrac64 = (uint64_t)start * j->delta64;
+	for (int32_t i = start; i < end; i++, posFrac64 += j->delta64)
+	{
+		const int32_t position = (int32_t)(posFrac64 >> 32);
+		const float *t = getResampleTaps(j, (uint32_t)posFrac64, fTaps);
+
+		const bool tapsInside = position >= RESAMPLE_LEFT_TAPS && position < j->srcLength-RESAMPLE_RIGHT_TAPS;
+		if (j->src16 != NULL)
+		{
+			if (tapsInside)
+				fSample = sincResample16(&j->src16[position-RESAMPLE_LEFT_TAPS], t);
+			else
+				fSample = sincResampleEdge(j, position, t);
+
+			FROUND(fSample);
+			int32_t smp32 = (int32_t)fSample;
+			CLAMP16(smp32);
+			j->dst16[i] = (int16_t)smp32;
+		}
+		else
+		{
+			if (tapsInside)
+				fSample = sincResample8(&j->src8[position-RESAMPLE_LEFT_TAPS], t);
+			else
+				fSample = sincResampleEdge(j, position, t);
+
+			FROUND(fSample);
+			int32_t smp32 = (int32_t)fSample;
+			CLAMP8(smp32);
+			j->dst8[i] = (int8_t)smp32;
+		}
+	}
+}
+
+static void resampleNearestChunk(int32_t start, int32_t end, void *userData)
+{
+	const resampleJob_t *j = (const resampleJob_t *)userData;
+
+	// 32.32 fixed-point logic
+	uint64_t posFrac64 = (uint64_t)start * j->delta64;
+	if (j->src16 != NULL)
+	{
+		for (int32_t i = start; i < end; i++, posFrac64 += j->delta64)
+			j->dst16[i] = j->src16[posFrac64 >> 32];
+	}
+	else
+	{
+		for (int32_t i = start; i < end; i++, posFrac64 += j->delta64)
+			j->dst8[i] = j->src8[posFrac64 >> 32];
+	}
+}
+
 static int32_t SDLCALL resampleThread(void *ptr)
 {
 	smpPtr_t sp;
+	resampleJob_t job;
 
 	if (instr[editor.curInstr] == NULL)
 		return true;
@@ -105,54 +291,39 @@ static int32_t SDLCALL resampleThread(void *ptr)
 		return true;
 	}
 
-	int8_t *dst = sp.ptr;
-	int8_t *src = s->dataPtr;
+	memset(&job, 0, sizeof (job));
+	if (sample16Bit)
+		job.dst16 = (int16_t *)sp.ptr;
+	else
+		job.dst8 = sp.ptr;
 
-	// 32.32 fixed-point logic
-	const uint64_t delta64 = (const uint64_t)round((UINT32_MAX+1.0) / dRatio);
-	uint64_t posFrac64 = 0;
+	job.srcLength = s->length;
+	job.delta64 = (const uint64_t)round((UINT32_MAX+1.0) / dRatio);
+
+	if (job.delta64 <= (uint64_t)(2.375 * MIXER_FRAC_SCALE))
+		job.fLUT = fKaiserSinc_32;
+	else if (job.delta64 <= (uint64_t)(3.0 * MIXER_FRAC_SCALE))
+		job.fLUT = fDownSample1_32;
+	else
+		job.fLUT = fDownSample2_32;
 
 	pauseAudio();
 	unfixSample(s);
 
-	/* Nearest-neighbor resampling (no interpolation).
-	**
-	** Could benefit from windowed-sinc interpolation,
-	** but it seems like some people prefer no resampling
-	** interpolation (like FT2).
-	*/
+	// set after unfixSample(), as it gives the sample its own copy of the data if it was shared
+	if (sample16Bit)
+		job.src16 = (const int16_t *)s->dataPtr;
+	else
+		job.src8 = s->dataPtr;
 
+	/* Nearest-neighbor resampling (no interpolation) is the default,
+	** since some people prefer no resampling interpolation (like FT2).
+	*/
 	if (newLen > 0)
-	{
-		if (sample16Bit)
-		{
-			const int16_t *src16 = (const int16_t *)src;
-			int16_t *dst16 = (int16_t *)dst;
-
-			for (uint32_t i = 0; i < newLen; i++)
-			{
-				const uint32_t position = posFrac64 >> 32;
-				dst16[i] = src16[position];
-				posFrac64 += delta64;
-			}
-		}
-		else // 8-bit
-		{
-			const int8_t *src8 = src;
-			int8_t *dst8 = dst;
-
-			for (uint32_t i = 0; i < newLen; i++)
-			{
-				const uint32_t position = posFrac64 >> 32;
-				dst8[i] = src8[position];
-				posFrac64 += delta64;
-			}
-		}
-	}
+		parallelFor(newLen, resample_Sinc ? resampleSincChunk : resampleNearestChunk, &job);
 
 	freeSmpData(s);
 	setSmpDataPtr(s, &sp);
-
 	s->relativeNote += smpEd_RelReSmp;
 	s->length = newLen;
 	s->loopStart = (int32_t)(s->loopStart * dRatio);
@@ -191,7 +362,7 @@ static void drawResampleBox(void)
 	const int16_t x = 209;
 	const int16_t y = 230;
 	const int16_t w = 214;
-	const int16_t h = 54;
+	const int16_t h = 68;
 
 	// main fill
 	fillRect(x + 1, y + 1, w - 2, h - 2, PAL_BUTTONS);
@@ -219,6 +390,7 @@ static void drawResampleBox(void)
 	textOutShadow(215, 236, PAL_FORGRND, PAL_BUTTON2, "Rel. h.tones");
 	textOutShadow(215, 250, PAL_FORGRND, PAL_BUTTON2, "New sample size");
 	hexOut(361, 250, PAL_FORGRND, (int32_t)dNewLen, 8);
+	textOutShadow(230, 264, PAL_FORGRND, PAL_BUTTON2, "Band-limited (sinc)");
 
 	     if (smpEd_RelReSmp == 0) sign = ' ';
 	else if (smpEd_RelReSmp  < 0) sign = '-';
@@ -238,17 +410,34 @@ static void drawResampleBox(void)
 	}
 }
 
+static void cbResampleSinc(void)
+{
+	resample_Sinc ^= 1;
+}
+
 static void setupResampleBoxWidgets(void)
 {
+	checkBox_t *c;
 	pushButton_t *p;
 	scrollBar_t *s;
 
+	// "Band-limited (sinc)" checkbox
+	c = &checkBoxes[0];
+	memset(c, 0, sizeof (checkBox_t));
+	c->x = 214;
+	c->y = 262;
+	c->clickAreaWidth = 152;
+	c->clickAreaHeight = 12;
+	c->callbackFunc = cbResampleSinc;
+	c->checked = resample_Sinc ? CHECKBOX_CHECKED : CHECKBOX_UNCHECKED;
+	c->visible = true;
+
 	// "Apply" pushbutton
 	p = &pushButtons[0];
 	memset(p, 0, sizeof (pushButton_t));
 	p->caption = "Apply";
 	p->x = 214;
-	p->y = 264;
+	p->y = 278;
 	p->w = 73;
 	p->h = 16;
 	p->callbackFuncOnUp = pbDoResampling;
@@ -259,7 +448,7 @@ static void setupResampleBoxWidgets(void)
 	memset(p, 0, sizeof (pushButton_t));
 	p->caption = "Exit";
 	p->x = 345;
-	p->y = 264;
+	p->y = 278;
 	p->w = 73;
 	p->h = 16;
 	p->callbackFuncOnUp = pbExit;
@@ -339,6 +528,7 @@ void pbSampleResample(void)
 		flipFrame();
 	}
 
+	hideCheckBox(0);
 	for (i = 0; i < 4; i++) hidePushButton(i);
 	hideScrollBar(0);
 
@@ -459,74 +649,139 @@ static int32_t SDLCALL createEchoThread(void *ptr)
 		return false;
 	}
 
-	pauseAudio();
-	unfixSample(s);
+	/* The echo is rendered as a feedback delay line:
+	**   y[n] = x[n] + (vol * y[n-distance]) - (vol^nEchoes * x[n-(distance*nEchoes)])
+	** The last term removes the input again once it has echoed nEchoes times, so this
+	** equals summing the nEchoes echo taps per output sample, but at a constant cost per
+	** sample. y[n] only depends on y[n-distance], so the delay line is processed in blocks
+	** of 'distance' samples, where every pass over a block is a simple vectorizable loop.
+	**
+	** Quirk from the old implementation: x[0] only goes to y[0], it's never echoed.
+	*/
 
-	int32_t writeIdx = 0;
+	const int32_t blockLen = (distance > 0) ? distance : 65536;
 
-	if (sample16Bit)
+	double *dDelay = (double *)calloc(blockLen, sizeof (double)); // one block of y[]
+	if (dDelay == NULL)
 	{
-		const int16_t *readPtr16 = (const int16_t *)readPtr;
-		int16_t *writePtr16 = (int16_t *)sp.ptr;
-
-		while (writeIdx < writeLen)
-		{
-			double dSmpOut = 0.0;
-			double dSmpMul = 1.0;
+		freeSmpDataPtr(&sp);
+		outOfMemory = true;
+		setMouseBusy(false);
+		ui.sysReqShown = false;
+		return false;
+	}
 
-			int32_t echoRead = writeIdx;
-			int32_t echoCycle = nEchoes;
+	double dEchoesVol = 1.0; // vol^nEchoes
+	double dSumVol = 0.0; // 1 + vol + vol^2 + ... (for distance 0)
+	for (int32_t i = 0; i < nEchoes; i++)
+	{
+		dSumVol += dEchoesVol;
+		dEchoesVol *= dVolChange;
+	}
 
-			while (!stopThread)
-			{
-				if (echoRead < readLen)
-					dSmpOut += (int32_t)readPtr16[echoRead] * dSmpMul;
+	pauseAudio();
+	unfixSample(s);
+	readPtr = s->dataPtr; // the sample data is copied by unfixSample() if it was shared
 
-				dSmpMul *= dVolChange;
+	const int8_t *readPtr8 = readPtr;
+	const int16_t *readPtr16 = (const int16_t *)readPtr;
+	int8_t *writePtr8 = sp.ptr;
+	int16_t *writePtr16 = (int16_t *)sp.ptr;
 
-				echoRead -= distance;
-				if (echoRead <= 0 || --echoCycle <= 0)
-					break;
-			}
+	const int64_t echoesDist = (int64_t)distance * nEchoes;
 
-			DROUND(dSmpOut);
+	int32_t writeIdx = 0;
+	while (writeIdx < writeLen && !stopThread)
+	{
+		int32_t blockEnd = writeIdx + blockLen;
+		if (blockEnd > writeLen)
+			blockEnd = writeLen;
 
-			int32_t smp32 = (int32_t)dSmpOut;
-			CLAMP16(smp32);
-			writePtr16[writeIdx++] = (int16_t)smp32;
+		if (distance == 0)
+		{
+			// all echoes land on the same sample position
+			for (int32_t i = writeIdx; i < blockEnd; i++)
+			{
+				const int32_t smp = (i < readLen) ? (sample16Bit ? readPtr16[i] : readPtr8[i]) : 0;
+				dDelay[i-writeIdx] = (i == 0) ? smp : (smp * dSumVol);
+			}
 		}
-	}
-	else // 8-bit
-	{
-		int8_t *writePtr8 = sp.ptr;
-		while (writeIdx < writeLen)
+		else
 		{
-			double dSmpOut = 0.0;
-			double dSmpMul = 1.0;
+			// feedback from the previous block
+			for (int32_t i = writeIdx; i < blockEnd; i++)
+				dDelay[i-writeIdx] *= dVolChange;
+
+			// new input (x[0] is added on output)
+			int32_t start = MAX(writeIdx, 1);
+			int32_t end = MIN(blockEnd, readLen);
+			if (sample16Bit)
+			{
+				for (int32_t i = start; i < end; i++)
+					dDelay[i-writeIdx] += readPtr16[i];
+			}
+			else
+			{
+				for (int32_t i = start; i < end; i++)
+					dDelay[i-writeIdx] += readPtr8[i];
+			}
 
-			int32_t echoRead = writeIdx;
-			int32_t echoCycle = nEchoes;
+			// remove input that has echoed nEchoes times
+			if (echoesDist < blockEnd)
+			{
+				const int32_t echoesDist32 = (int32_t)echoesDist;
+
+				start = MAX(writeIdx, echoesDist32+1);
+				end = (int32_t)MIN((int64_t)blockEnd, (int64_t)readLen + echoesDist32);
+				if (sample16Bit)
+				{
+					for (int32_t i = start; i < end; i++)
+						dDelay[i-writeIdx] -= readPtr16[i-echoesDist32] * dEchoesVol;
+				}
+				else
+				{
+					for (int32_t i = start; i < end; i++)
+						dDelay[i-writeIdx] -= readPtr8[i-echoesDist32] * dEchoesVol;
+				}
+			}
+		}
 
-			while (!stopThread)
+		if (sample16Bit)
+		{
+			for (int32_t i = writeIdx; i < blockEnd; i++)
 			{
-				if (echoRead < readLen)
-					dSmpOut += (int32_t)readPtr[echoRead] * dSmpMul;
+				double dSmpOut = dDelay[i-writeIdx];
+				if (i == 0 && distance > 0)
+					dSmpOut += readPtr16[0];
 
-				dSmpMul *= dVolChange;
+				DROUND(dSmpOut);
 
-				echoRead -= distance;
-				if (echoRead <= 0 || --echoCycle <= 0)
-					break;
+				int32_t smp32 = (int32_t)dSmpOut;
+				CLAMP16(smp32);
+				writePtr16[i] = (int16_t)smp32;
 			}
+		}
+		else
+		{
+			for (int32_t i = writeIdx; i < blockEnd; i++)
+			{
+				double dSmpOut = dDelay[i-writeIdx];
+				if (i == 0 && distance > 0)
+					dSmpOut += readPtr8[0];
 
-			DROUND(dSmpOut);
+				DROUND(dSmpOut);
 
-			int32_t smp32 = (int32_t)dSmpOut;
-			CLAMP8(smp32);
-			writePtr8[writeIdx++] = (int8_t)smp32;
+				int32_t smp32 = (int32_t)dSmpOut;
+				CLAMP8(smp32);
+				writePtr8[i] = (int8_t)smp32;
+			}
 		}
+
+		writeIdx = blockEnd;
 	}
 
+	free(dDelay);
+
 	freeSmpData(s);
 	setSmpDataPtr(s, &sp);
 
@@ -900,7 +1155,14 @@ static int32_t SDLCALL mixThread(void *ptr)
 
 	// unfix source sample
 	if (instr[mixIns] != NULL)
-		unfixSample(sSrc);
+		unfixSampleForReading(sSrc);
+
+	// the sample data is copied by unfixSample() if it was shared
+	if (dstPtr != NULL)
+		dstPtr = s->dataPtr;
+
+	if (mixPtr != NULL)
+		mixPtr = sSrc->dataPtr;
 
 	const double dAmp1 = mix_Balance / 100.0;
 	const double dAmp2 = 1.0 - dAmp1;
@@ -927,7 +1189,7 @@ static int32_t SDLCALL mixThread(void *ptr)
 
 	// re-fix source sample again
 	if (instr[mixIns] != NULL)
-		fixSample(sSrc);
+		refixSample(sSrc);
 
 	resumeAudio();
 
@@ -1162,6 +1424,78 @@ static void pbSampEndVolUp(void)
 	dVol_EndVol = floor(dVol_EndVol);
 }
 
+typedef struct volumeJob_t // for parallelFor()
+{
+	int8_t *ptr8;
+	int16_t *ptr16;
+	double dVol, dPosMul;
+	int32_t maxAmp;
+} volumeJob_t;
+
+static void applyVolume8Chunk(int32_t start, int32_t end, void *userData)
+{
+	volumeJob_t *j = (volumeJob_t *)userData;
+	for (int32_t i = start; i < end; i++)
+	{
+		double dSmp = (int32_t)j->ptr8[i] * (j->dVol + (i * j->dPosMul)); // linear interpolation
+		DROUND(dSmp);
+
+		int32_t smp32 = (int32_t)dSmp;
+		CLAMP8(smp32);
+		j->ptr8[i] = (int8_t)smp32;
+	}
+}
+
+static void applyVolume16Chunk(int32_t start, int32_t end, void *userData)
+{
+	volumeJob_t *j = (volumeJob_t *)userData;
+	for (int32_t i = start; i < end; i++)
+	{
+		double dSmp = (int32_t)j->ptr16[i] * (j->dVol + (i * j->dPosMul)); // linear interpolation
+		DROUND(dSmp);
+
+		int32_t smp32 = (int32_t)dSmp;
+		CLAMP16(smp32);
+		j->ptr16[i] = (int16_t)smp32;
+	}
+}
+
+static void getMaxAmp8Chunk(int32_t start, int32_t end, void *userData)
+{
+	volumeJob_t *j = (volumeJob_t *)userData;
+
+	int32_t maxAmp = 0;
+	for (int32_t i = start; i < end; i++)
+	{
+		const int32_t absSmp = ABS(j->ptr8[i]);
+		if (absSmp > maxAmp)
+			maxAmp = absSmp;
+	}
+
+	lockParallelResult();
+	if (maxAmp > j->maxAmp)
+		j->maxAmp = maxAmp;
+	unlockParallelResult();
+}
+
+static void getMaxAmp16Chunk(int32_t start, int32_t end, void *userData)
+{
+	volumeJob_t *j = (volumeJob_t *)userData;
+
+	int32_t maxAmp = 0;
+	for (int32_t i = start; i < end; i++)
+	{
+		const int32_t absSmp = ABS(j->ptr16[i]);
+		if (absSmp > maxAmp)
+			maxAmp = absSmp;
+	}
+
+	lockParallelResult();
+	if (maxAmp > j->maxAmp)
+		j->maxAmp = maxAmp;
+	unlockParallelResult();
+}
+
 static int32_t SDLCALL applyVolumeThread(void *ptr)
 {
 	int32_t x1, x2;
@@ -1200,64 +1534,21 @@ static int32_t SDLCALL applyVolumeThread(void *ptr)
 	const double dVol = dVol_StartVol / 100.0;
 	const double dPosMul = ((dVol_EndVol / 100.0) - dVol) / len;
 
+	volumeJob_t job;
+	job.dVol = dVol;
+	job.dPosMul = mustInterpolate ? dPosMul : 0.0;
+
 	pauseAudio();
 	unfixSample(s);
 	if (s->flags & SAMPLE_16BIT)
 	{
-		int16_t *ptr16 = (int16_t *)s->dataPtr + x1;
-		if (mustInterpolate)
-		{
-			for (int32_t i = 0; i < len; i++)
-			{
-				double dSmp = (int32_t)ptr16[i] * (dVol + (i * dPosMul)); // linear interpolation
-				DROUND(dSmp);
-
-				int32_t smp32 = (int32_t)dSmp;
-				CLAMP16(smp32);
-				ptr16[i] = (int16_t)smp32;
-			}
-
-		}
-		else // no interpolation needed
-		{
-			for (int32_t i = 0; i < len; i++)
-			{
-				double dSmp = (int32_t)ptr16[i] * dVol;
-				DROUND(dSmp);
-
-				int32_t smp32 = (int32_t)dSmp;
-				CLAMP16(smp32);
-				ptr16[i] = (int16_t)smp32;
-			}
-		}
+		job.ptr16 = (int16_t *)s->dataPtr + x1;
+		parallelFor(len, applyVolume16Chunk, &job);
 	}
 	else // 8-bit sample
 	{
-		int8_t *ptr8 = s->dataPtr + x1;
-		if (mustInterpolate)
-		{
-			for (int32_t i = 0; i < len; i++)
-			{
-				double dSmp = (int32_t)ptr8[i] * (dVol + (i * dPosMul)); // linear interpolation
-				DROUND(dSmp);
-
-				int32_t smp32 = (int32_t)dSmp;
-				CLAMP8(smp32);
-				ptr8[i] = (int8_t)smp32;
-			}
-		}
-		else // no interpolation needed
-		{
-			for (int32_t i = 0; i < len; i++)
-			{
-				double dSmp = (int32_t)ptr8[i] * dVol;
-				DROUND(dSmp);
-
-				int32_t smp32 = (int32_t)dSmp;
-				CLAMP8(smp32);
-				ptr8[i] = (int8_t)smp32;
-			}
-		}
+		job.ptr8 = s->dataPtr + x1;
+		parallelFor(len, applyVolume8Chunk, &job);
 	}
 	fixSample(s);
 	resumeAudio();
@@ -1340,38 +1631,30 @@ static int32_t SDLCALL getMaxScaleThread(void *ptr)
 	bool fixedSampleInRange = hasLoop && (x1 <= loopEnd) && (x2 >= loopEnd);
 
 	if (fixedSampleInRange)
-		unfixSample(s);
+		unfixSampleForReading(s);
+
+	volumeJob_t job;
+	job.maxAmp = 0;
 
-	int32_t maxAmp = 0;
 	if (s->flags & SAMPLE_16BIT)
 	{
-		const int16_t *ptr16 = (const int16_t *)s->dataPtr + x1;
-		for (uint32_t i = 0; i < len; i++)
-		{
-			const int32_t absSmp = ABS(ptr16[i]);
-			if (absSmp > maxAmp)
-				maxAmp = absSmp;
-		}
+		job.ptr16 = (int16_t *)s->dataPtr + x1;
+		parallelFor(len, getMaxAmp16Chunk, &job);
 
-		if (maxAmp > 0)
-			dVolChange = (32767.0 / maxAmp) * 100.0;
+		if (job.maxAmp > 0)
+			dVolChange = (32767.0 / job.maxAmp) * 100.0;
 	}
 	else // 8-bit
 	{
-		const int8_t *ptr8 = (const int8_t *)&s->dataPtr[x1];
-		for (uint32_t i = 0; i < len; i++)
-		{
-			const int32_t absSmp = ABS(ptr8[i]);
-			if (absSmp > maxAmp)
-				maxAmp = absSmp;
-		}
+		job.ptr8 = &s->dataPtr[x1];
+		parallelFor(len, getMaxAmp8Chunk, &job);
 
-		if (maxAmp > 0)
-			dVolChange = (127.0 / maxAmp) * 100.0;
+		if (job.maxAmp > 0)
+			dVolChange = (127.0 / job.maxAmp) * 100.0;
 	}
 
 	if (fixedSampleInRange)
-		fixSample(s);
+		refixSample(s);
 
 	if (dVolChange < 100.0) // yes, this can happen...
 		dVolChange = 100.0;
@@ -0,0 +1,240 @@
+/* SSE2 kernels for the sample delta coding and sign conversion (bit-exact with the scalar loops).
+** The delta decoding is a prefix sum: it's done inside a vector in log2(lanes) shift+add steps,
+** then the last value of the previous vector is added to all lanes.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+#include <emmintrin.h>
+#endif
+#include "ft2_structs.h"
+#include "ft2_sample_kernels.h"
+
+int8_t prefixSum8(int8_t *p, int32_t length, int8_t sum) // returns the last sum
+{
+	int32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		__m128i carry = _mm_set1_epi8(sum);
+		for (; i+16 <= length; i += 16)
+		{
+			__m128i x = _mm_loadu_si128((__m128i *)&p[i]);
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi8(x, carry);
+			_mm_storeu_si128((__m128i *)&p[i], x);
+
+			// broadcast byte #15 to all lanes
+			carry = _mm_unpackhi_epi8(x, x);
+			carry = _mm_shufflehi_epi16(carry, _MM_SHUFFLE(3, 3, 3, 3));
+			carry = _mm_unpackhi_epi64(carry, carry);
+		}
+
+		sum = (int8_t)_mm_cvtsi128_si32(carry);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		sum += p[i];
+		p[i] = sum;
+	}
+
+	return sum;
+}
+
+int16_t prefixSum16(int16_t *p, int32_t length, int16_t sum) // returns the last sum
+{
+	int32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		__m128i carry = _mm_set1_epi16(sum);
+		for (; i+8 <= length; i += 8)
+		{
+			__m128i x = _mm_loadu_si128((__m128i *)&p[i]);
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi16(x, carry);
+			_mm_storeu_si128((__m128i *)&p[i], x);
+
+			// broadcast word #7 to all lanes
+			carry = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+			carry = _mm_unpackhi_epi64(carry, carry);
+		}
+
+		sum = (int16_t)_mm_cvtsi128_si32(carry);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		sum += p[i];
+		p[i] = sum;
+	}
+
+	return sum;
+}
+
+void deltaEncode8(int8_t *p, int32_t length)
+{
+	int32_t i = 0;
+	int8_t prev = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2 && length >= 16)
+	{
+		__m128i last = _mm_setzero_si128();
+		for (; i+16 <= length; i += 16)
+		{
+			const __m128i x = _mm_loadu_si128((__m128i *)&p[i]);
+			const __m128i prevSmps = _mm_or_si128(_mm_slli_si128(x, 1), _mm_srli_si128(last, 15));
+			_mm_storeu_si128((__m128i *)&p[i], _mm_sub_epi8(x, prevSmps));
+			last = x;
+		}
+
+		prev = (int8_t)(_mm_cvtsi128_si32(_mm_srli_si128(last, 15)));
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		const int8_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+void deltaEncode16(int16_t *p, int32_t length)
+{
+	int32_t i = 0;
+	int16_t prev = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2 && length >= 8)
+	{
+		__m128i last = _mm_setzero_si128();
+		for (; i+8 <= length; i += 8)
+		{
+			const __m128i x = _mm_loadu_si128((__m128i *)&p[i]);
+			const __m128i prevSmps = _mm_or_si128(_mm_slli_si128(x, 2), _mm_srli_si128(last, 14));
+			_mm_storeu_si128((__m128i *)&p[i], _mm_sub_epi16(x, prevSmps));
+			last = x;
+		}
+
+		prev = (int16_t)(_mm_cvtsi128_si32(_mm_srli_si128(last, 14)));
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		const int16_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+// dst[i] = (dst[i] + src[i]) >> 1, optionally after flipping the sign bits (unsigned to signed)
+void average8(int8_t *dst, const int8_t *src, int32_t length, int8_t xorVal)
+{
+	int32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		const __m128i vXor = _mm_set1_epi8(xorVal);
+		const __m128i vSignBits = _mm_set1_epi8(-128);
+		const __m128i vLowBits = _mm_set1_epi8(0x7F);
+
+		for (; i+16 <= length; i += 16)
+		{
+			const __m128i a = _mm_xor_si128(_mm_loadu_si128((__m128i *)&dst[i]), vXor);
+			const __m128i b = _mm_xor_si128(_mm_loadu_si128((__m128i *)&src[i]), vXor);
+
+			// floor((a+b)/2) = (a & b) + ((a ^ b) >> 1), with an arithmetic 8-bit shift
+			const __m128i d = _mm_xor_si128(a, b);
+			const __m128i dShr = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(d, 1), vLowBits), _mm_and_si128(d, vSignBits));
+			_mm_storeu_si128((__m128i *)&dst[i], _mm_add_epi8(_mm_and_si128(a, b), dShr));
+		}
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		const int8_t a = dst[i] ^ xorVal;
+		const int8_t b = src[i] ^ xorVal;
+
+		dst[i] = (int8_t)((a + b) >> 1);
+	}
+}
+
+void average16(int16_t *dst, const int16_t *src, int32_t length, int16_t xorVal)
+{
+	int32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		const __m128i vXor = _mm_set1_epi16(xorVal);
+		for (; i+8 <= length; i += 8)
+		{
+			const __m128i a = _mm_xor_si128(_mm_loadu_si128((__m128i *)&dst[i]), vXor);
+			const __m128i b = _mm_xor_si128(_mm_loadu_si128((__m128i *)&src[i]), vXor);
+
+			// floor((a+b)/2) = (a & b) + ((a ^ b) >> 1)
+			const __m128i avg = _mm_add_epi16(_mm_and_si128(a, b), _mm_srai_epi16(_mm_xor_si128(a, b), 1));
+			_mm_storeu_si128((__m128i *)&dst[i], avg);
+		}
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		const int16_t a = dst[i] ^ xorVal;
+		const int16_t b = src[i] ^ xorVal;
+
+		dst[i] = (int16_t)((a + b) >> 1);
+	}
+}
+
+void flipSign8(int8_t *p, int32_t length)
+{
+	int32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		const __m128i vXor = _mm_set1_epi8(-128);
+		for (; i+16 <= length; i += 16)
+			_mm_storeu_si128((__m128i *)&p[i], _mm_xor_si128(_mm_loadu_si128((__m128i *)&p[i]), vXor));
+	}
+#endif
+
+	for (; i < length; i++)
+		p[i] ^= 0x80;
+}
+
+void flipSign16(int16_t *p, int32_t length)
+{
+	int32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	if (cpu.hasSSE2)
+	{
+		const __m128i vXor = _mm_set1_epi16(-32768);
+		for (; i+8 <= length; i += 8)
+			_mm_storeu_si128((__m128i *)&p[i], _mm_xor_si128(_mm_loadu_si128((__m128i *)&p[i]), vXor));
+	}
+#endif
+
+	for (; i < length; i++)
+		p[i] ^= 0x8000;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Sample data conversion kernels used by the loaders and savers. They use SSE2 if cpu.hasSSE2
+** is set, and give the same result as the scalar code (tests/test_sample_kernels.c).
+*/
+
+int8_t prefixSum8(int8_t *p, int32_t length, int8_t sum); // delta decoding, returns the last sum
+int16_t prefixSum16(int16_t *p, int32_t length, int16_t sum);
+void deltaEncode8(int8_t *p, int32_t length);
+void deltaEncode16(int16_t *p, int32_t length);
+void average8(int8_t *dst, const int8_t *src, int32_t length, int8_t xorVal); // dst = (dst + src) >> 1, after XORing both
+void average16(int16_t *dst, const int16_t *src, int32_t length, int16_t xorVal);
+void flipSign8(int8_t *p, int32_t length); // unsigned <-> signed
+void flipSign16(int16_t *p, int32_t length);
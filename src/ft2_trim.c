@@ -29,6 +29,7 @@ static instr_t *tmpInstr[1 + MAX_INST], *tmpInst[MAX_INST]; // tmpInstr[x] = cop
 static SDL_Thread *trimThread;
 
 void pbTrimCalc(void);
+void lazyLoadAllSamples(void); // ft2_module_loader.c (its header clashes with tmpPatternEmpty() here)
 
 static void freeTmpInstruments(void)
 {
@@ -1022,6 +1023,49 @@ static char *formatBytes(uint64_t bytes, bool roundUp)
 	return byteFormatBuffer;
 }
 
+static uint64_t getSharedSampleDataSize(void) // memory saved by samples sharing their data
+{
+	double dBytes = 0.0;
+	for (int32_t i = 1; i <= MAX_INST; i++)
+	{
+		instr_t *ins = instr[i];
+		if (ins == NULL)
+			continue;
+
+		sample_t *s = ins->smp;
+		for (int32_t j = 0; j < MAX_SMP_PER_INST; j++, s++)
+		{
+			// every user of a shared buffer counts its share of the copies that weren't made
+			const int32_t refCount = getSampleDataRefCount(s);
+			if (refCount > 1)
+				dBytes += (double)SAMPLE_LENGTH_BYTES(s) * (refCount - 1) / refCount;
+		}
+	}
+
+	return (uint64_t)(dBytes + 0.5);
+}
+
+static uint64_t getFloatSampleCacheSize(void)
+{
+	double dBytes = 0.0;
+	for (int32_t i = 1; i <= MAX_INST; i++)
+	{
+		instr_t *ins = instr[i];
+		if (ins == NULL)
+			continue;
+
+		sample_t *s = ins->smp;
+		for (int32_t j = 0; j < MAX_SMP_PER_INST; j++, s++)
+		{
+			// the cache is shared with the sample data, so every user of it counts its share
+			if (getFloatSampleData(s) != NULL)
+				dBytes += (double)FLOAT_SMP_CACHE_LEN(s->length) * sizeof (float) / getSampleDataRefCount(s);
+		}
+	}
+
+	return (uint64_t)(dBytes + 0.5);
+}
+
 void drawTrimScreen(void)
 {
 	char sizeBuf[16];
@@ -1037,38 +1081,53 @@ void drawTrimScreen(void)
 	textOutShadow(19,  161, PAL_FORGRND, PAL_DSKTOP2, "Smp. dat. after loop");
 
 	textOutShadow(155,  96, PAL_FORGRND, PAL_DSKTOP2, "Conv. samples to 8-bit");
-	textOutShadow(140, 111, PAL_FORGRND, PAL_DSKTOP2, ".xm size before");
-	textOutShadow(140, 124, PAL_FORGRND, PAL_DSKTOP2, ".xm size after");
-	textOutShadow(140, 137, PAL_FORGRND, PAL_DSKTOP2, "Bytes to save");
+
+	// the five rows (9 pixels apart) have to end above the "Calculate" and "Trim" buttons at y=155
+	textOutShadow(140, 107, PAL_FORGRND, PAL_DSKTOP2, ".xm size before");
+	textOutShadow(140, 116, PAL_FORGRND, PAL_DSKTOP2, ".xm size after");
+	textOutShadow(140, 125, PAL_FORGRND, PAL_DSKTOP2, "Bytes to save");
+	textOutShadow(140, 134, PAL_FORGRND, PAL_DSKTOP2, "Shared smp. data");
 
 	if (xmSize64 > -1)
 	{
 		sprintf(sizeBuf, "%s", formatBytes(xmSize64, true));
-		textOut(287 - textWidth(sizeBuf), 111, PAL_FORGRND, sizeBuf);
+		textOut(287 - textWidth(sizeBuf), 107, PAL_FORGRND, sizeBuf);
 	}
 	else
 	{
-		textOut(287 - textWidth("Unknown"), 111, PAL_FORGRND, "Unknown");
+		textOut(287 - textWidth("Unknown"), 107, PAL_FORGRND, "Unknown");
 	}
 
 	if (xmAfterTrimSize64 > -1)
 	{
 		sprintf(sizeBuf, "%s", formatBytes(xmAfterTrimSize64, true));
-		textOut(287 - textWidth(sizeBuf), 124, PAL_FORGRND, sizeBuf);
+		textOut(287 - textWidth(sizeBuf), 116, PAL_FORGRND, sizeBuf);
 	}
 	else
 	{
-		textOut(287 - textWidth("Unknown"), 124, PAL_FORGRND, "Unknown");
+		textOut(287 - textWidth("Unknown"), 116, PAL_FORGRND, "Unknown");
 	}
 
 	if (spaceSaved64 > -1)
 	{
 		sprintf(sizeBuf, "%s", formatBytes(spaceSaved64, false));
-		textOut(287 - textWidth(sizeBuf), 137, PAL_FORGRND, sizeBuf);
+		textOut(287 - textWidth(sizeBuf), 125, PAL_FORGRND, sizeBuf);
 	}
 	else
 	{
-		textOut(287 - textWidth("Unknown"), 137, PAL_FORGRND, "Unknown");
+		textOut(287 - textWidth("Unknown"), 125, PAL_FORGRND, "Unknown");
+	}
+
+	// memory not used thanks to copied samples sharing their data (not part of the .xm)
+	sprintf(sizeBuf, "%s", formatBytes(getSharedSampleDataSize(), true));
+	textOut(287 - textWidth(sizeBuf), 134, PAL_FORGRND, sizeBuf);
+
+	if (audio.floatSampleCache) // memory used by the float sample cache (not part of the .xm)
+	{
+		textOutShadow(140, 143, PAL_FORGRND, PAL_DSKTOP2, "Float smp. cache");
+
+		sprintf(sizeBuf, "%s", formatBytes(getFloatSampleCacheSize(), true));
+		textOut(287 - textWidth(sizeBuf), 143, PAL_FORGRND, sizeBuf);
 	}
 
 	showCheckBox(CB_TRIM_PATT);
@@ -1168,6 +1227,8 @@ void cbTrimSmpsTo8Bit(void)
 
 void pbTrimCalc(void)
 {
+	lazyLoadAllSamples(); // huge module, the sample sizes aren't known until loaded
+
 	xmSize64 = calculateXMSize();
 	spaceSaved64 = calculateTrimSize();
 
@@ -1187,6 +1248,8 @@ void pbTrimDoTrim(void)
 	if (okBox(2, "System request", "Are you sure you want to trim the song? Making a backup of the song first is recommended.", NULL) != 1)
 		return;
 
+	lazyLoadAllSamples();
+
 	mouseAnimOn();
 	pauseAudio();
 
@@ -265,7 +265,7 @@ char *cp437ToUtf8(char *src)
 		return NULL;
 	}
 
-	outBuf[outLen] = '\0';
+	*outPtr = '\0'; // outLen is the space left
 
 	return outBuf;
 }
@@ -313,12 +313,13 @@ char *utf8ToCp437(char *src, bool removeIllegalChars)
 		return NULL;
 	}
 
-	outBuf[outLen] = '\0';
+	*outPtr = '\0'; // outLen is the space left
+	const size_t numBytes = outPtr - outBuf;
 
 	if (removeIllegalChars)
 	{
 		// remove illegal characters (only allow certain nordic ones)
-		for (size_t i = 0; i < outLen; i++)
+		for (size_t i = 0; i < numBytes; i++)
 		{
 			const int8_t ch = (const int8_t)outBuf[i];
 			if (ch < 32 && ch != 0 && ch != -124 && ch != -108 &&
@@ -331,4 +332,66 @@ char *utf8ToCp437(char *src, bool removeIllegalChars)
 
 	return outBuf;
 }
+
+/* Same as utf8ToCp437(), but into dst (dstSize bytes, including the terminator) without allocating
+** anything, for converting many names in a row. The iconv handle is kept open, so this must only be
+** called from the main thread. Returns false if the conversion failed or didn't fit.
+*/
+bool utf8ToCp437Buf(char *src, char *dst, size_t dstSize, bool removeIllegalChars)
+{
+	static iconv_t cd = (iconv_t)-1;
+
+	if (src == NULL || dstSize < 2)
+		return false;
+
+	size_t srcLen = strlen(src);
+	if (srcLen <= 0)
+		return false;
+
+	if (cd == (iconv_t)-1)
+	{
+#ifdef __APPLE__
+		cd = iconv_open("437//TRANSLIT//IGNORE", "UTF-8-MAC");
+#elif defined(__NetBSD__) || defined(__sun) || defined(sun)
+		cd = iconv_open("437", "UTF-8");
+#else
+		cd = iconv_open("437//TRANSLIT//IGNORE", "UTF-8");
+#endif
+		if (cd == (iconv_t)-1)
+			return false;
+	}
+
+	iconv(cd, NULL, NULL, NULL, NULL); // reset the state
+
+	char *inPtr = src;
+	size_t inLen = srcLen;
+	char *outPtr = dst;
+	size_t outLen = dstSize - 1;
+
+#if defined(__NetBSD__) || defined(__sun) || defined(sun)
+	int32_t rc = iconv(cd, (const char **)&inPtr, &inLen, &outPtr, &outLen);
+#else
+	int32_t rc = iconv(cd, &inPtr, &inLen, &outPtr, &outLen);
+#endif
+	if (rc == -1 || iconv(cd, NULL, NULL, &outPtr, &outLen) == (size_t)-1) // flush
+		return false;
+
+	*outPtr = '\0';
+
+	if (removeIllegalChars)
+	{
+		// remove illegal characters (only allow certain nordic ones)
+		for (char *p = dst; p < outPtr; p++)
+		{
+			const int8_t ch = (const int8_t)*p;
+			if (ch < 32 && ch != 0 && ch != -124 && ch != -108 &&
+				ch != -122 && ch != -114 && ch != -103 && ch != -113)
+			{
+				*p = ' '; // character not allowed, turn it into space
+			}
+		}
+	}
+
+	return true;
+}
 #endif
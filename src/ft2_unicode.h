@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdbool.h>
 
 #ifdef _WIN32
@@ -50,4 +51,5 @@ char *unicharToCp437(UNICHAR *src, bool removeIllegalChars);
 #else
 #define cp437ToUnichar(a) cp437ToUtf8(a)
 #define unicharToCp437(a, b) utf8ToCp437(a, b)
+bool utf8ToCp437Buf(char *src, char *dst, size_t dstSize, bool removeIllegalChars); // main thread only, doesn't allocate
 #endif
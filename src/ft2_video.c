@@ -34,6 +34,7 @@
 #include "ft2_midi.h"
 #include "ft2_bmp.h"
 #include "ft2_structs.h"
+#include "ft2_profiler.h"
 
 static const uint8_t textCursorData[12] =
 {
@@ -48,6 +49,8 @@ video_t video; // globalized
 static bool songIsModified;
 static char wndTitle[256];
 static sprite_t sprites[SPRITE_NUM];
+static bool lastFramePresented;
+static int32_t numStaticFrames;
 
 // for FPS counter
 #define FPS_LINES 15
@@ -190,32 +193,243 @@ void endFPSCounter(void)
 	}
 }
 
+void markDirtyRect(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	int32_t x2 = x + w;
+	int32_t y2 = y + h;
+
+	// clip to screen
+	if (x < 0) x = 0;
+	if (y < 0) y = 0;
+	if (x2 > SCREEN_W) x2 = SCREEN_W;
+	if (y2 > SCREEN_H) y2 = SCREEN_H;
+
+	if (x >= x2 || y >= y2)
+		return;
+
+	if (x  < video.dirtyX1) video.dirtyX1 = x;
+	if (y  < video.dirtyY1) video.dirtyY1 = y;
+	if (x2 > video.dirtyX2) video.dirtyX2 = x2;
+	if (y2 > video.dirtyY2) video.dirtyY2 = y2;
+}
+
+void markScreenDirty(void)
+{
+	video.dirtyX1 = 0;
+	video.dirtyY1 = 0;
+	video.dirtyX2 = SCREEN_W;
+	video.dirtyY2 = SCREEN_H;
+}
+
+static void clearDirtyRect(void)
+{
+	video.dirtyX1 = SCREEN_W;
+	video.dirtyY1 = SCREEN_H;
+	video.dirtyX2 = 0;
+	video.dirtyY2 = 0;
+}
+
+static void composeSprite(const sprite_t *s, uint32_t *pixels, int32_t pitch, const SDL_Rect *rect)
+{
+	// clip sprite to the locked texture area
+	const int32_t x1 = MAX(s->x, rect->x);
+	const int32_t y1 = MAX(s->y, rect->y);
+	const int32_t x2 = MIN(s->x + s->w, rect->x + rect->w);
+	const int32_t y2 = MIN(s->y + s->h, rect->y + rect->h);
+
+	for (int32_t y = y1; y < y2; y++)
+	{
+		const uint8_t *src8 = &s->data[((y - s->y) * s->w) + (x1 - s->x)];
+		uint32_t *dst32 = &pixels[((y - rect->y) * pitch) + (x1 - rect->x)];
+
+		for (int32_t x = x1; x < x2; x++, src8++, dst32++)
+		{
+			if (*src8 == PAL_TRANSPR)
+				continue;
+
+			if (s->drawnAltColor) // text edit mouse pointer (has color changing depending on content under it)
+			{
+				if (!(*dst32 & 0xFFFFFF) || *dst32 == video.palette[PAL_TEXTMRK])
+					*dst32 = 0xB3DBF6;
+				else
+					*dst32 = 0x004ECE;
+			}
+			else
+			{
+				assert(*src8 < PAL_NUM);
+				*dst32 = video.palette[*src8];
+			}
+		}
+	}
+}
+
+/* Texture sprite mode: the dirty area of the framebuffer is copied into the locked streaming texture
+** (instead of SDL_UpdateTexture()), and the text cursor and mouse pointer are composited on top of it
+** in the texture. The framebuffer is never touched by them, so there's no save-under buffer to fill
+** and restore each frame. If the window is fully covered by the texture, SDL_RenderClear() is also
+** skipped. The loop pins are still drawn into the framebuffer (in handleRedrawing()).
+** Returns false if the texture couldn't be locked (nothing was written).
+*/
+static bool composeToTexture(const SDL_Rect *rect)
+{
+	void *pixels;
+	int32_t pitch;
+
+	if (SDL_LockTexture(video.texture, rect, &pixels, &pitch) != 0)
+		return false;
+
+	pitch /= sizeof (int32_t);
+
+	// locked pixels are write-only (undefined content), so the whole area has to be written
+	const uint32_t *src32 = &video.frameBuffer[(rect->y * SCREEN_W) + rect->x];
+	uint32_t *dst32 = (uint32_t *)pixels;
+	for (int32_t y = 0; y < rect->h; y++, src32 += SCREEN_W, dst32 += pitch)
+		memcpy(dst32, src32, rect->w * sizeof (int32_t));
+
+	for (int32_t i = SPRITE_TEXT_CURSOR; i < SPRITE_NUM; i++)
+	{
+		if (sprites[i].drawn)
+			composeSprite(&sprites[i], (uint32_t *)pixels, pitch, rect);
+	}
+
+	SDL_UnlockTexture(video.texture);
+	return true;
+}
+
+static void markTextureSpritesDirty(void)
+{
+	for (int32_t i = SPRITE_TEXT_CURSOR; i < SPRITE_NUM; i++)
+	{
+		if (sprites[i].drawn)
+			markDirtyRect(sprites[i].drawnX, sprites[i].drawnY, sprites[i].w, sprites[i].h);
+	}
+}
+
+/* Idle mode: if the screen hasn't changed for a while and nothing is going on that changes it
+** by itself, block until an input event arrives instead of running the main loop at 60Hz.
+** The timeout keeps flags from other threads (disk op., module loading etc.) serviced.
+*/
+#define IDLE_STATIC_FRAMES VBLANK_HZ // one second
+#define IDLE_WAIT_TIMEOUT_MS 100
+
+static bool canIdle(void)
+{
+	if (numStaticFrames < IDLE_STATIC_FRAMES)
+		return false;
+
+	if (songPlaying || playMode != PLAYMODE_IDLE || editor.busy || editor.samplingAudioFlag || editor.wavIsRendering)
+		return false;
+
+	if (mouse.leftButtonPressed || mouse.rightButtonPressed) // held down buttons/scrollbars repeat
+		return false;
+
+	// audio/video sync data still pending
+	if (chQueueReadSize() > 0 || pattQueueReadSize() > 0)
+		return false;
+
+	return true;
+}
+
+void wakeUpMainLoop(void) // thread-safe, for input that doesn't come through SDL (MIDI)
+{
+	/* Always pushed, since checking if the main loop is idling would race with it entering
+	** SDL_WaitEventTimeout(). The event is simply ignored by the main loop.
+	*/
+	SDL_Event event;
+	memset(&event, 0, sizeof (event));
+	event.type = SDL_USEREVENT;
+	SDL_PushEvent(&event);
+}
+
+static void idleWait(void)
+{
+	SDL_WaitEventTimeout(NULL, IDLE_WAIT_TIMEOUT_MS); // doesn't remove the event from the queue
+
+	hpc_ResetCounters(&video.vblankHpc); // we slept for an unknown amount of time
+}
+
 void flipFrame(void)
 {
 	const uint32_t windowFlags = SDL_GetWindowFlags(video.window);
 	bool minimized = (windowFlags & SDL_WINDOW_MINIMIZED) ? true : false;
 
+	profilerBegin(PROF_SPRITES);
 	renderSprites();
+	profilerEnd(PROF_SPRITES);
 
 	if (video.showFPSCounter)
+	{
 		drawFPSCounter();
+		drawProfilerOverlay();
+	}
+
+	/* Only upload the part of the framebuffer that changed since the last frame (union of all
+	** dirty rectangles). If nothing changed, the texture (and what's on screen) is still
+	** valid, so we skip both the upload and the present.
+	*/
+	const bool frameChanged = (video.dirtyX1 < video.dirtyX2 && video.dirtyY1 < video.dirtyY2);
+	if (frameChanged)
+	{
+		SDL_Rect dstRect;
+		dstRect.x = video.dirtyX1;
+		dstRect.y = video.dirtyY1;
+		dstRect.w = video.dirtyX2 - video.dirtyX1;
+		dstRect.h = video.dirtyY2 - video.dirtyY1;
+
+		profilerBegin(PROF_UPLOAD);
+		const bool composed = video.spritesInTexture && composeToTexture(&dstRect);
+		if (!composed)
+		{
+			const uint32_t *srcPtr = &video.frameBuffer[(dstRect.y * SCREEN_W) + dstRect.x];
+			SDL_UpdateTexture(video.texture, &dstRect, srcPtr, SCREEN_W * sizeof (int32_t));
+		}
+		clearDirtyRect();
 
-	SDL_UpdateTexture(video.texture, NULL, video.frameBuffer, SCREEN_W * sizeof (int32_t));
+		// the texture couldn't be locked, so the changes were uploaded without the sprites. Try again next frame.
+		if (video.spritesInTexture && !composed)
+			markTextureSpritesDirty();
+		profilerEnd(PROF_UPLOAD);
 
-	// SDL 2.0.14 bug on Windows (?): This function consumes ever-increasing memory if the program is minimized
-	if (!minimized)
-		SDL_RenderClear(video.renderer);
+		profilerBegin(PROF_PRESENT);
 
-	SDL_RenderCopy(video.renderer, video.texture, NULL, NULL);
-	SDL_RenderPresent(video.renderer);
+		// SDL 2.0.14 bug on Windows (?): This function consumes ever-increasing memory if the program is minimized
+		if (!minimized && !(video.spritesInTexture && video.renderCoversWindow))
+			SDL_RenderClear(video.renderer);
 
+		SDL_RenderCopy(video.renderer, video.texture, NULL, NULL);
+		SDL_RenderPresent(video.renderer);
+
+		profilerEnd(PROF_PRESENT);
+	}
+
+	profilerBegin(PROF_SPRITES);
 	eraseSprites();
+	profilerEnd(PROF_SPRITES);
+
+	profilerBegin(PROF_VBLANK_WAIT);
 
-	if (!video.vsync60HzPresent)
+	if (frameChanged)
+		numStaticFrames = 0;
+	else if (numStaticFrames < IDLE_STATIC_FRAMES)
+		numStaticFrames++;
+
+	if (!frameChanged && canIdle())
+	{
+		idleWait();
+	}
+	else if (!video.vsync60HzPresent)
 	{
 		// we have no VSync, do crude thread sleeping to sync to ~60Hz
 		hpc_Wait(&video.vblankHpc);
 	}
+	else if (!frameChanged)
+	{
+		// nothing was presented, so VSync didn't pace this frame. Sleep instead.
+		if (lastFramePresented)
+			hpc_ResetCounters(&video.vblankHpc); // counters are stale while VSync does the pacing
+
+		hpc_Wait(&video.vblankHpc);
+	}
 	else
 	{
 		/* We have VSync, but it can unexpectedly get inactive in certain scenarios.
@@ -239,6 +453,9 @@ void flipFrame(void)
 #endif
 	}
 
+	profilerEnd(PROF_VBLANK_WAIT);
+
+	lastFramePresented = frameChanged;
 	editor.framesPassed++;
 
 	/* Reset audio/video sync timestamp every half an hour to prevent
@@ -330,6 +547,10 @@ static void updateRenderSizeVars(void)
 		video.renderY = 0;
 	}
 
+	// if the texture covers the whole window, there are no borders to clear before rendering
+	video.renderCoversWindow = (video.renderX == 0 && video.renderY == 0 &&
+		video.renderW == video.windowW && video.renderH == video.windowH);
+
 	// for mouse cursor creation
 	video.xScale = (uint32_t)round(video.renderW / (double)SCREEN_W);
 	video.yScale = (uint32_t)round(video.renderH / (double)SCREEN_H);
@@ -497,6 +718,9 @@ void eraseSprites(void)
 		if (s->x >= SCREEN_W || s->y >= SCREEN_H) // sprite is hidden, don't draw nor fill clear buffer
 			continue;
 
+		if (video.spritesInTexture && i >= SPRITE_TEXT_CURSOR)
+			continue; // drawn straight into the texture, the framebuffer wasn't touched
+
 		assert(s->refreshBuffer != NULL);
 
 		int32_t sw = s->w;
@@ -539,6 +763,29 @@ void eraseSprites(void)
 	}
 }
 
+/* Sprites are drawn on top of the framebuffer and erased again after each flip, so they
+** only need to be uploaded when they moved, changed graphics or got shown/hidden. If the
+** area under them changed, it's already marked as dirty by the drawing routines.
+*/
+static void updateSpriteDirtyArea(sprite_t *s, bool shown, bool altColor)
+{
+	if (shown != s->drawn || (shown && (s->x != s->drawnX || s->y != s->drawnY ||
+	    s->data != s->drawnData || altColor != s->drawnAltColor)))
+	{
+		if (s->drawn)
+			markDirtyRect(s->drawnX, s->drawnY, s->w, s->h);
+
+		if (shown)
+			markDirtyRect(s->x, s->y, s->w, s->h);
+	}
+
+	s->drawn = shown;
+	s->drawnX = s->x;
+	s->drawnY = s->y;
+	s->drawnData = s->data;
+	s->drawnAltColor = altColor;
+}
+
 void renderSprites(void)
 {
 	sprite_t *s = sprites;
@@ -547,13 +794,18 @@ void renderSprites(void)
 		if (i == SPRITE_LEFT_LOOP_PIN || i == SPRITE_RIGHT_LOOP_PIN)
 			continue; // these need special drawing (done elsewhere)
 
+		const bool altColor = (mouse.mouseOverTextBox && i == SPRITE_MOUSE_POINTER);
+
 		// don't render the text edit cursor if window is inactive
 		if (i == SPRITE_TEXT_CURSOR)
 		{
 			assert(video.window != NULL);
 			const uint32_t windowFlags = SDL_GetWindowFlags(video.window);
 			if (!(windowFlags & SDL_WINDOW_INPUT_FOCUS))
+			{
+				updateSpriteDirtyArea(s, false, altColor);
 				continue;
+			}
 		}
 
 		// set new sprite position
@@ -561,7 +813,10 @@ void renderSprites(void)
 		s->y = s->newY;
 
 		if (s->x >= SCREEN_W || s->y >= SCREEN_H) // sprite is hidden, don't draw nor fill clear buffer
+		{
+			updateSpriteDirtyArea(s, false, altColor);
 			continue;
+		}
 
 		assert(s->data != NULL && s->refreshBuffer != NULL);
 
@@ -588,7 +843,15 @@ void renderSprites(void)
 		}
 
 		if (sw <= 0 || sh <= 0) // sprite is hidden, don't draw nor fill clear buffer
+		{
+			updateSpriteDirtyArea(s, false, altColor);
 			continue;
+		}
+
+		updateSpriteDirtyArea(s, true, altColor);
+
+		if (video.spritesInTexture)
+			continue; // drawn in composeToTexture()
 
 		uint32_t *dst32 = &video.frameBuffer[(sy * SCREEN_W) + sx];
 		uint32_t *clr32 = s->refreshBuffer;
@@ -600,7 +863,7 @@ void renderSprites(void)
 		const int32_t srcPitch = s->w - sw;
 		const int32_t dstPitch = SCREEN_W - sw;
 
-		if (mouse.mouseOverTextBox && i == SPRITE_MOUSE_POINTER)
+		if (altColor)
 		{
 			// text edit mouse pointer (has color changing depending on content under it)
 			for (int32_t y = 0; y < sh; y++)
@@ -668,6 +931,8 @@ void renderLoopPins(void)
 	s->x = s->newX;
 	s->y = s->newY;
 
+	updateSpriteDirtyArea(s, s->x < SCREEN_W, false);
+
 	if (s->x < SCREEN_W) // loop pin shown?
 	{
 		sw = s->w;
@@ -724,6 +989,8 @@ void renderLoopPins(void)
 	s->x = s->newX;
 	s->y = s->newY;
 
+	updateSpriteDirtyArea(s, s->x < SCREEN_W, false);
+
 	if (s->x < SCREEN_W) // loop pin shown?
 	{
 		s->x = s->newX;
@@ -916,6 +1183,20 @@ bool recreateTexture(void)
 	}
 
 	SDL_SetTextureBlendMode(video.texture, SDL_BLENDMODE_NONE);
+
+	if (video.spritesInTexture)
+	{
+		void *pixels;
+		int32_t pitch;
+
+		// fall back to regular texture uploading if the renderer can't lock textures
+		if (SDL_LockTexture(video.texture, NULL, &pixels, &pitch) == 0)
+			SDL_UnlockTexture(video.texture);
+		else
+			video.spritesInTexture = false;
+	}
+
+	markScreenDirty(); // new texture has undefined content
 	return true;
 }
 
@@ -1093,9 +1374,17 @@ void handleRedrawing(void)
 					drawPlaybackTime();
 
 				if (ui.sampleEditorExtShown)
+				{
+					profilerBegin(PROF_SMPED_EXT);
 					handleSampleEditorExtRedrawing();
+					profilerEnd(PROF_SMPED_EXT);
+				}
 				else if (ui.scopesShown)
+				{
+					profilerBegin(PROF_SCOPES);
 					drawScopes();
+					profilerEnd(PROF_SCOPES);
+				}
 			}
 		}
 	}
@@ -1191,6 +1480,10 @@ static void drawReplayerData(void)
 	{
 		ui.updatePatternEditor = false;
 		if (ui.patternEditorShown)
+		{
+			profilerBegin(PROF_PATTERN);
 			writePattern(editor.row, editor.editPattern);
+			profilerEnd(PROF_PATTERN);
+		}
 	}
 }
@@ -32,6 +32,8 @@ typedef struct video_t
 	uint8_t upscaleFactor;
 	bool vsync60HzPresent, windowHidden;
 	int32_t renderX, renderY, renderW, renderH, displayW, displayH, windowW, windowH;
+	int32_t dirtyX1, dirtyY1, dirtyX2, dirtyY2; // union of changed framebuffer areas since last flip
+	bool spritesInTexture, renderCoversWindow;
 	SDL_Renderer *renderer;
 	SDL_Texture *texture;
 	SDL_Surface *iconSurface;
@@ -40,9 +42,9 @@ typedef struct video_t
 typedef struct
 {
 	uint32_t *refreshBuffer;
-	const uint8_t *data;
-	bool visible;
-	int16_t newX, newY, x, y;
+	const uint8_t *data, *drawnData;
+	bool visible, drawn, drawnAltColor;
+	int16_t newX, newY, x, y, drawnX, drawnY;
 	uint16_t w, h;
 } sprite_t;
 
@@ -51,7 +53,10 @@ extern video_t video; // ft2_video.c
 void resetFPSCounter(void);
 void beginFPSCounter(void);
 void endFPSCounter(void);
+void markDirtyRect(int32_t x, int32_t y, int32_t w, int32_t h);
+void markScreenDirty(void);
 void flipFrame(void);
+void wakeUpMainLoop(void);
 void showErrorMsgBox(const char *fmt, ...);
 void updateWindowTitle(bool forceUpdate);
 void handleScopesFromChQueue(chSyncData_t *chSyncData, uint8_t *scopeUpdateStatus);
@@ -19,6 +19,7 @@
 #include "ft2_audio.h"
 #include "ft2_wav_renderer.h"
 #include "ft2_structs.h"
+#include "ft2_module_loader.h"
 
 #define UPDATE_VISUALS_AT_TICK 4
 #define TICKS_PER_RENDER_CHUNK 64
@@ -450,6 +451,8 @@ static void wavRender(bool checkOverwrite)
 			return;
 	}
 
+	lazyLoadAllSamples(); // huge module, the samples may not all be loaded yet
+
 	editor.wavRendererFileHandle = fopen(filename, "wb");
 	if (editor.wavRendererFileHandle == NULL)
 	{
@@ -0,0 +1,229 @@
+/*
+** Persistent worker threads for splitting long sample operations over all CPU cores
+**
+** The threads are created once at startup and sleep on a semaphore between jobs.
+** A job is split into more chunks than there are threads, and every thread (including
+** the calling one) keeps grabbing the next free chunk until none are left, so a thread
+** that gets descheduled doesn't hold up the whole job.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_header.h"
+#include "ft2_workers.h"
+
+#define CHUNKS_PER_THREAD 4
+
+static volatile bool workersQuit;
+static int32_t numWorkers;
+static SDL_Thread *workerThreads[WORKERS_MAX_THREADS];
+static SDL_sem *jobSem, *doneSem;
+static SDL_mutex *jobMutex, *resultMutex;
+static SDL_TLSID insideJobTLS; // set on the threads running chunks of a job (see isInsideJob())
+
+static struct
+{
+	parallelForFunc_t func;
+	void *userData;
+	int32_t length, chunkLen, numChunks;
+	SDL_atomic_t nextChunk;
+} job;
+
+static void runChunks(void)
+{
+	while (true)
+	{
+		const int32_t chunk = SDL_AtomicAdd(&job.nextChunk, 1);
+		if (chunk >= job.numChunks)
+			break;
+
+		const int32_t start = chunk * job.chunkLen;
+
+		int32_t end = start + job.chunkLen;
+		if (end > job.length)
+			end = job.length;
+
+		job.func(start, end, job.userData);
+	}
+}
+
+/* The pool runs one job at a time, so a chunk function calling parallelFor() again would
+** overwrite the running job (the job mutex is recursive) or deadlock (on a worker thread).
+** Nested calls run the whole range on the calling thread instead.
+*/
+static bool isInsideJob(void)
+{
+	return SDL_TLSGet(insideJobTLS) != NULL;
+}
+
+static int32_t SDLCALL workerThreadFunc(void *ptr)
+{
+	SDL_TLSSet(insideJobTLS, (void *)1, NULL); // a worker only ever runs chunks
+
+	while (true)
+	{
+		SDL_SemWait(jobSem);
+		if (workersQuit)
+			break;
+
+		runChunks();
+		SDL_SemPost(doneSem);
+	}
+
+	return true;
+
+	(void)ptr;
+}
+
+void initWorkerThreads(void)
+{
+	numWorkers = SDL_GetCPUCount() - 1; // the calling thread works too
+	if (numWorkers > WORKERS_MAX_THREADS)
+		numWorkers = WORKERS_MAX_THREADS;
+
+	if (numWorkers <= 0)
+	{
+		numWorkers = 0;
+		return;
+	}
+
+	jobSem = SDL_CreateSemaphore(0);
+	doneSem = SDL_CreateSemaphore(0);
+	jobMutex = SDL_CreateMutex();
+	resultMutex = SDL_CreateMutex();
+	insideJobTLS = SDL_TLSCreate();
+
+	if (jobSem == NULL || doneSem == NULL || jobMutex == NULL || resultMutex == NULL || insideJobTLS == 0)
+	{
+		numWorkers = 0;
+		closeWorkerThreads();
+		return;
+	}
+
+	workersQuit = false;
+	for (int32_t i = 0; i < numWorkers; i++)
+	{
+		workerThreads[i] = SDL_CreateThread(workerThreadFunc, "FT2 worker", NULL);
+		if (workerThreads[i] == NULL)
+		{
+			numWorkers = i; // run with the threads we got
+			break;
+		}
+	}
+}
+
+void closeWorkerThreads(void)
+{
+	if (jobMutex != NULL)
+		SDL_LockMutex(jobMutex); // wait for a running job to finish
+
+	workersQuit = true;
+	for (int32_t i = 0; i < numWorkers; i++)
+		SDL_SemPost(jobSem);
+
+	for (int32_t i = 0; i < numWorkers; i++)
+	{
+		SDL_WaitThread(workerThreads[i], NULL);
+		workerThreads[i] = NULL;
+	}
+	numWorkers = 0;
+
+	if (jobMutex != NULL)
+	{
+		SDL_UnlockMutex(jobMutex);
+		SDL_DestroyMutex(jobMutex);
+		jobMutex = NULL;
+	}
+
+	if (resultMutex != NULL)
+	{
+		SDL_DestroyMutex(resultMutex);
+		resultMutex = NULL;
+	}
+
+	if (jobSem != NULL)
+	{
+		SDL_DestroySemaphore(jobSem);
+		jobSem = NULL;
+	}
+
+	if (doneSem != NULL)
+	{
+		SDL_DestroySemaphore(doneSem);
+		doneSem = NULL;
+	}
+}
+
+static void runJob(int32_t length, int32_t chunkLen, parallelForFunc_t func, void *userData)
+{
+	SDL_LockMutex(jobMutex);
+
+	job.func = func;
+	job.userData = userData;
+	job.length = length;
+	job.chunkLen = chunkLen;
+	job.numChunks = (int32_t)(((int64_t)length + (chunkLen-1)) / chunkLen);
+	SDL_AtomicSet(&job.nextChunk, 0);
+
+	int32_t numHelpers = job.numChunks - 1;
+	if (numHelpers > numWorkers)
+		numHelpers = numWorkers;
+
+	for (int32_t i = 0; i < numHelpers; i++)
+		SDL_SemPost(jobSem);
+
+	SDL_TLSSet(insideJobTLS, (void *)1, NULL);
+	runChunks();
+	SDL_TLSSet(insideJobTLS, NULL, NULL);
+
+	for (int32_t i = 0; i < numHelpers; i++)
+		SDL_SemWait(doneSem);
+
+	SDL_UnlockMutex(jobMutex);
+}
+
+void parallelFor(int32_t length, parallelForFunc_t func, void *userData)
+{
+	if (length <= 0)
+		return;
+
+	if (numWorkers == 0 || length < WORKERS_MIN_CHUNK_LEN*2 || isInsideJob())
+	{
+		func(0, length, userData);
+		return;
+	}
+
+	const int32_t maxChunks = (numWorkers + 1) * CHUNKS_PER_THREAD;
+
+	int32_t chunkLen = (int32_t)(((int64_t)length + (maxChunks-1)) / maxChunks);
+	if (chunkLen < WORKERS_MIN_CHUNK_LEN)
+		chunkLen = WORKERS_MIN_CHUNK_LEN;
+
+	runJob(length, chunkLen, func, userData);
+}
+
+void parallelForEach(int32_t numItems, parallelForFunc_t func, void *userData)
+{
+	if (numItems <= 0)
+		return;
+
+	if (numWorkers == 0 || numItems == 1 || isInsideJob())
+	{
+		func(0, numItems, userData);
+		return;
+	}
+
+	runJob(numItems, 1, func, userData);
+}
+
+void lockParallelResult(void)
+{
+	if (resultMutex != NULL)
+		SDL_LockMutex(resultMutex);
+}
+
+void unlockParallelResult(void)
+{
+	if (resultMutex != NULL)
+		SDL_UnlockMutex(resultMutex);
+}
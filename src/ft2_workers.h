@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WORKERS_MAX_THREADS 16
+#define WORKERS_MIN_CHUNK_LEN 65536 // samples, smaller jobs are not worth splitting
+
+typedef void (*parallelForFunc_t)(int32_t start, int32_t end, void *userData);
+
+void initWorkerThreads(void); // falls back to running jobs on the calling thread if this fails
+void closeWorkerThreads(void);
+
+/* Calls func() on chunks of [0, length) on the worker threads and the calling thread,
+** and returns when all chunks are done. Chunks may run in any order and in parallel.
+** Only one job runs at a time, other callers will wait. The pool is not reentrant: if func()
+** calls parallelFor() or parallelForEach(), the nested job runs on the calling thread only.
+*/
+void parallelFor(int32_t length, parallelForFunc_t func, void *userData);
+
+/* Same, but every item is its own chunk (for a few big tasks of different sizes, f.ex. one per sample).
+** Put the biggest items first, so that a big one isn't started last.
+*/
+void parallelForEach(int32_t numItems, parallelForFunc_t func, void *userData);
+
+// for merging per-chunk results (f.ex. a peak value) into the job's shared result
+void lockParallelResult(void);
+void unlockParallelResult(void);
@@ -14,8 +14,11 @@
 ** - 32-bit floating-point precision for mixing and interpolation
 **
 ** This file has separate routines for EVERY possible sampling variation:
-** Interpolation none/sinc/linear/cubic, volumeramp on/off, 8-bit, 16-bit, no loop, loop, bidi.
-** (48 mixing routines in total)
+** Interpolation none/sinc/linear/cubic, volumeramp on/off, 8-bit, 16-bit, float, no loop, loop, bidi.
+** (90 mixing routines in total, plus 36 windowed-sinc routines for the compact LUT layout)
+**
+** The float routines read from the sample's float cache (pre-converted and pre-scaled
+** sample data), which is only built if the program was started with "--float-samples".
 **
 ** Every voice has a function pointer set to the according mixing routine on
 ** sample trigger (from replayer, but set in audio thread), using a function
@@ -3493,79 +3496,4301 @@ static void mix16bRampBidiLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t nu
 	SET_BACK_MIXER_POS
 }
 
-// -----------------------------------------------------------------------
+/* ----------------------------------------------------------------------- */
+/*                  FLOAT (SAMPLE CACHE) MIXING ROUTINES                   */
+/* ----------------------------------------------------------------------- */
 
-const mixFunc mixFuncTab[] =
+static void mixFloatNoLoop(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
 {
-	// no volume ramping
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
 
-	// 8-bit
-	(mixFunc)mix8bNoLoop,
-	(mixFunc)mix8bLoop,
-	(mixFunc)mix8bBidiLoop,
-	(mixFunc)mix8bNoLoopS8Intrp,
-	(mixFunc)mix8bLoopS8Intrp,
-	(mixFunc)mix8bBidiLoopS8Intrp,
-	(mixFunc)mix8bNoLoopLIntrp,
-	(mixFunc)mix8bLoopLIntrp,
-	(mixFunc)mix8bBidiLoopLIntrp,
-	(mixFunc)mix8bNoLoopS32Intrp,
-	(mixFunc)mix8bLoopS32Intrp,
-	(mixFunc)mix8bBidiLoopS32Intrp,
-	(mixFunc)mix8bNoLoopCIntrp,
-	(mixFunc)mix8bLoopCIntrp,
-	(mixFunc)mix8bBidiLoopCIntrp,
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
 
-	// 16-bit
-	(mixFunc)mix16bNoLoop,
-	(mixFunc)mix16bLoop,
-	(mixFunc)mix16bBidiLoop,
-	(mixFunc)mix16bNoLoopS8Intrp,
-	(mixFunc)mix16bLoopS8Intrp,
-	(mixFunc)mix16bBidiLoopS8Intrp,
-	(mixFunc)mix16bNoLoopLIntrp,
-	(mixFunc)mix16bLoopLIntrp,
-	(mixFunc)mix16bBidiLoopLIntrp,
-	(mixFunc)mix16bNoLoopS32Intrp,
-	(mixFunc)mix16bLoopS32Intrp,
-	(mixFunc)mix16bBidiLoopS32Intrp,
-	(mixFunc)mix16bNoLoopCIntrp,
-	(mixFunc)mix16bLoopCIntrp,
-	(mixFunc)mix16bBidiLoopCIntrp,
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
 
-	// volume ramping
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP
+			INC_POS
+			RENDER_FLOAT_SMP
+			INC_POS
+			RENDER_FLOAT_SMP
+			INC_POS
+			RENDER_FLOAT_SMP
+			INC_POS
+		}
 
-	// 8-bit
-	(mixFunc)mix8bRampNoLoop,
-	(mixFunc)mix8bRampLoop,
-	(mixFunc)mix8bRampBidiLoop,
-	(mixFunc)mix8bRampNoLoopS8Intrp,
-	(mixFunc)mix8bRampLoopS8Intrp,
-	(mixFunc)mix8bRampBidiLoopS8Intrp,
-	(mixFunc)mix8bRampNoLoopLIntrp,
-	(mixFunc)mix8bRampLoopLIntrp,
-	(mixFunc)mix8bRampBidiLoopLIntrp,
-	(mixFunc)mix8bRampNoLoopS32Intrp,
-	(mixFunc)mix8bRampLoopS32Intrp,
-	(mixFunc)mix8bRampBidiLoopS32Intrp,
-	(mixFunc)mix8bRampNoLoopCIntrp,
-	(mixFunc)mix8bRampLoopCIntrp,
-	(mixFunc)mix8bRampBidiLoopCIntrp,
+		HANDLE_SAMPLE_END
+	}
 
-	// 16-bit
-	(mixFunc)mix16bRampNoLoop,
-	(mixFunc)mix16bRampLoop,
-	(mixFunc)mix16bRampBidiLoop,
-	(mixFunc)mix16bRampNoLoopS8Intrp,
-	(mixFunc)mix16bRampLoopS8Intrp,
-	(mixFunc)mix16bRampBidiLoopS8Intrp,
-	(mixFunc)mix16bRampNoLoopLIntrp,
-	(mixFunc)mix16bRampLoopLIntrp,
-	(mixFunc)mix16bRampBidiLoopLIntrp,
-	(mixFunc)mix16bRampNoLoopS32Intrp,
-	(mixFunc)mix16bRampLoopS32Intrp,
-	(mixFunc)mix16bRampBidiLoopS32Intrp,
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoop(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP
+			INC_POS
+			RENDER_FLOAT_SMP
+			INC_POS
+			RENDER_FLOAT_SMP
+			INC_POS
+			RENDER_FLOAT_SMP
+			INC_POS
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoop(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP
+			INC_POS_BIDI
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP
+			INC_POS_BIDI
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatNoLoopS8Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoopS8Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoopS8Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatNoLoopLIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoopLIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoopLIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS_BIDI
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP_LINTRP
+			INC_POS_BIDI
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatNoLoopS32Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoopS32Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoopS32Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatNoLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_CINTRP
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_CINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_CINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_CINTRP
+			INC_POS
+			RENDER_FLOAT_SMP_CINTRP
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoop(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoop(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoop(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoopS8Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoopS8Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoopS8Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoopLIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoopLIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoopLIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+			RENDER_FLOAT_SMP_LINTRP
+			VOLUME_RAMPING
+			INC_POS_BIDI
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoopS32Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoopS32Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoopS32Intrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_CINTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_CINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_CINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_CINTRP
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_CINTRP
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_CINTRP
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+/* ----------------------------------------------------------------------- */
+/*        COMPACT WINDOWED-SINC MIXING ROUTINES (8-BIT/16-BIT/FLOAT)       */
+/* ----------------------------------------------------------------------- */
+
+static void mix8bNoLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE8
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bBidiLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *revBase, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE8_BIDI
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bNoLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE8
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bBidiLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *revBase, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE8_BIDI
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bRampNoLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_8BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bRampLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE8
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bRampBidiLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *revBase, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE8_BIDI
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+	
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bRampNoLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_8BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bRampLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE8
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix8bRampBidiLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int8_t *base, *revBase, *smpPtr;
+	int8_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE8_BIDI
+	PREPARE_TAP_FIX8
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_8BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+	
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bNoLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE16
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bBidiLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *revBase, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE16_BIDI
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bNoLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE16
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bBidiLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *revBase, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASE16_BIDI
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bRampNoLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_16BIT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bRampLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE16
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bRampBidiLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *revBase, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE16_BIDI
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bRampNoLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_16BIT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bRampLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE16
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mix16bRampBidiLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const int16_t *base, *revBase, *smpPtr;
+	int16_t *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASE16_BIDI
+	PREPARE_TAP_FIX16
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_16BIT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatNoLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatNoLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatBidiLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL
+	GET_MIXER_VARS
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S8INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoopS8CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S8INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampNoLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		for (i = 0; i < (samplesToMix & 3); i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+		samplesToMix >>= 2;
+		for (i = 0; i < samplesToMix; i++)
+		{
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+			RENDER_FLOAT_SMP_S32INTRP_COMPACT
+			VOLUME_RAMPING
+			INC_POS
+		}
+
+		HANDLE_SAMPLE_END
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS
+			}
+		}
+
+		WRAP_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+static void mixFloatRampBidiLoopS32CompactIntrp(voice_t *v, uint32_t bufferPos, uint32_t numSamples)
+{
+	const float *base, *revBase, *smpPtr;
+	float *smpTapPtr;
+	float fSample, *fMixBufferL, *fMixBufferR;
+	int32_t position;
+	float fVolumeLDelta, fVolumeRDelta, fVolumeL, fVolumeR;
+	uint32_t i, samplesToMix, samplesLeft;
+	uint64_t positionFrac, tmpDelta;
+
+	GET_VOL_RAMP
+	GET_MIXER_VARS_RAMP
+	SET_BASEF_BIDI
+	PREPARE_TAP_FIXF
+
+	samplesLeft = numSamples;
+	while (samplesLeft > 0)
+	{
+		LIMIT_MIX_NUM
+		LIMIT_MIX_NUM_RAMP
+		samplesLeft -= samplesToMix;
+
+		START_BIDI
+		if (v->hasLooped) // the negative interpolation taps need a special case after the sample has looped once
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		else
+		{
+			for (i = 0; i < (samplesToMix & 3); i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+			samplesToMix >>= 2;
+			for (i = 0; i < samplesToMix; i++)
+			{
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+				RENDER_FLOAT_SMP_S32INTRP_COMPACT
+				VOLUME_RAMPING
+				INC_POS_BIDI
+			}
+		}
+		END_BIDI
+
+		WRAP_BIDI_LOOP
+	}
+
+	SET_VOL_BACK
+	SET_BACK_MIXER_POS
+}
+
+// -----------------------------------------------------------------------
+
+const mixFunc mixFuncTab[] =
+{
+	// no volume ramping
+
+	// 8-bit
+	(mixFunc)mix8bNoLoop,
+	(mixFunc)mix8bLoop,
+	(mixFunc)mix8bBidiLoop,
+	(mixFunc)mix8bNoLoopS8Intrp,
+	(mixFunc)mix8bLoopS8Intrp,
+	(mixFunc)mix8bBidiLoopS8Intrp,
+	(mixFunc)mix8bNoLoopLIntrp,
+	(mixFunc)mix8bLoopLIntrp,
+	(mixFunc)mix8bBidiLoopLIntrp,
+	(mixFunc)mix8bNoLoopS32Intrp,
+	(mixFunc)mix8bLoopS32Intrp,
+	(mixFunc)mix8bBidiLoopS32Intrp,
+	(mixFunc)mix8bNoLoopCIntrp,
+	(mixFunc)mix8bLoopCIntrp,
+	(mixFunc)mix8bBidiLoopCIntrp,
+
+	// 16-bit
+	(mixFunc)mix16bNoLoop,
+	(mixFunc)mix16bLoop,
+	(mixFunc)mix16bBidiLoop,
+	(mixFunc)mix16bNoLoopS8Intrp,
+	(mixFunc)mix16bLoopS8Intrp,
+	(mixFunc)mix16bBidiLoopS8Intrp,
+	(mixFunc)mix16bNoLoopLIntrp,
+	(mixFunc)mix16bLoopLIntrp,
+	(mixFunc)mix16bBidiLoopLIntrp,
+	(mixFunc)mix16bNoLoopS32Intrp,
+	(mixFunc)mix16bLoopS32Intrp,
+	(mixFunc)mix16bBidiLoopS32Intrp,
+	(mixFunc)mix16bNoLoopCIntrp,
+	(mixFunc)mix16bLoopCIntrp,
+	(mixFunc)mix16bBidiLoopCIntrp,
+
+	// float (sample cache)
+	(mixFunc)mixFloatNoLoop,
+	(mixFunc)mixFloatLoop,
+	(mixFunc)mixFloatBidiLoop,
+	(mixFunc)mixFloatNoLoopS8Intrp,
+	(mixFunc)mixFloatLoopS8Intrp,
+	(mixFunc)mixFloatBidiLoopS8Intrp,
+	(mixFunc)mixFloatNoLoopLIntrp,
+	(mixFunc)mixFloatLoopLIntrp,
+	(mixFunc)mixFloatBidiLoopLIntrp,
+	(mixFunc)mixFloatNoLoopS32Intrp,
+	(mixFunc)mixFloatLoopS32Intrp,
+	(mixFunc)mixFloatBidiLoopS32Intrp,
+	(mixFunc)mixFloatNoLoopCIntrp,
+	(mixFunc)mixFloatLoopCIntrp,
+	(mixFunc)mixFloatBidiLoopCIntrp,
+
+	// volume ramping
+
+	// 8-bit
+	(mixFunc)mix8bRampNoLoop,
+	(mixFunc)mix8bRampLoop,
+	(mixFunc)mix8bRampBidiLoop,
+	(mixFunc)mix8bRampNoLoopS8Intrp,
+	(mixFunc)mix8bRampLoopS8Intrp,
+	(mixFunc)mix8bRampBidiLoopS8Intrp,
+	(mixFunc)mix8bRampNoLoopLIntrp,
+	(mixFunc)mix8bRampLoopLIntrp,
+	(mixFunc)mix8bRampBidiLoopLIntrp,
+	(mixFunc)mix8bRampNoLoopS32Intrp,
+	(mixFunc)mix8bRampLoopS32Intrp,
+	(mixFunc)mix8bRampBidiLoopS32Intrp,
+	(mixFunc)mix8bRampNoLoopCIntrp,
+	(mixFunc)mix8bRampLoopCIntrp,
+	(mixFunc)mix8bRampBidiLoopCIntrp,
+
+	// 16-bit
+	(mixFunc)mix16bRampNoLoop,
+	(mixFunc)mix16bRampLoop,
+	(mixFunc)mix16bRampBidiLoop,
+	(mixFunc)mix16bRampNoLoopS8Intrp,
+	(mixFunc)mix16bRampLoopS8Intrp,
+	(mixFunc)mix16bRampBidiLoopS8Intrp,
+	(mixFunc)mix16bRampNoLoopLIntrp,
+	(mixFunc)mix16bRampLoopLIntrp,
+	(mixFunc)mix16bRampBidiLoopLIntrp,
+	(mixFunc)mix16bRampNoLoopS32Intrp,
+	(mixFunc)mix16bRampLoopS32Intrp,
+	(mixFunc)mix16bRampBidiLoopS32Intrp,
+	(mixFunc)mix16bRampNoLoopCIntrp,
+	(mixFunc)mix16bRampLoopCIntrp,
+	(mixFunc)mix16bRampBidiLoopCIntrp,
+
+	// float (sample cache)
+	(mixFunc)mixFloatRampNoLoop,
+	(mixFunc)mixFloatRampLoop,
+	(mixFunc)mixFloatRampBidiLoop,
+	(mixFunc)mixFloatRampNoLoopS8Intrp,
+	(mixFunc)mixFloatRampLoopS8Intrp,
+	(mixFunc)mixFloatRampBidiLoopS8Intrp,
+	(mixFunc)mixFloatRampNoLoopLIntrp,
+	(mixFunc)mixFloatRampLoopLIntrp,
+	(mixFunc)mixFloatRampBidiLoopLIntrp,
+	(mixFunc)mixFloatRampNoLoopS32Intrp,
+	(mixFunc)mixFloatRampLoopS32Intrp,
+	(mixFunc)mixFloatRampBidiLoopS32Intrp,
+	(mixFunc)mixFloatRampNoLoopCIntrp,
+	(mixFunc)mixFloatRampLoopCIntrp,
+	(mixFunc)mixFloatRampBidiLoopCIntrp
+};
+
+// same as above, but with the compact windowed-sinc routines (selected at startup)
+const mixFunc mixFuncTabCompactSinc[] =
+{
+	// no volume ramping
+
+	// 8-bit
+	(mixFunc)mix8bNoLoop,
+	(mixFunc)mix8bLoop,
+	(mixFunc)mix8bBidiLoop,
+	(mixFunc)mix8bNoLoopS8CompactIntrp,
+	(mixFunc)mix8bLoopS8CompactIntrp,
+	(mixFunc)mix8bBidiLoopS8CompactIntrp,
+	(mixFunc)mix8bNoLoopLIntrp,
+	(mixFunc)mix8bLoopLIntrp,
+	(mixFunc)mix8bBidiLoopLIntrp,
+	(mixFunc)mix8bNoLoopS32CompactIntrp,
+	(mixFunc)mix8bLoopS32CompactIntrp,
+	(mixFunc)mix8bBidiLoopS32CompactIntrp,
+	(mixFunc)mix8bNoLoopCIntrp,
+	(mixFunc)mix8bLoopCIntrp,
+	(mixFunc)mix8bBidiLoopCIntrp,
+
+	// 16-bit
+	(mixFunc)mix16bNoLoop,
+	(mixFunc)mix16bLoop,
+	(mixFunc)mix16bBidiLoop,
+	(mixFunc)mix16bNoLoopS8CompactIntrp,
+	(mixFunc)mix16bLoopS8CompactIntrp,
+	(mixFunc)mix16bBidiLoopS8CompactIntrp,
+	(mixFunc)mix16bNoLoopLIntrp,
+	(mixFunc)mix16bLoopLIntrp,
+	(mixFunc)mix16bBidiLoopLIntrp,
+	(mixFunc)mix16bNoLoopS32CompactIntrp,
+	(mixFunc)mix16bLoopS32CompactIntrp,
+	(mixFunc)mix16bBidiLoopS32CompactIntrp,
+	(mixFunc)mix16bNoLoopCIntrp,
+	(mixFunc)mix16bLoopCIntrp,
+	(mixFunc)mix16bBidiLoopCIntrp,
+
+	// float (sample cache)
+	(mixFunc)mixFloatNoLoop,
+	(mixFunc)mixFloatLoop,
+	(mixFunc)mixFloatBidiLoop,
+	(mixFunc)mixFloatNoLoopS8CompactIntrp,
+	(mixFunc)mixFloatLoopS8CompactIntrp,
+	(mixFunc)mixFloatBidiLoopS8CompactIntrp,
+	(mixFunc)mixFloatNoLoopLIntrp,
+	(mixFunc)mixFloatLoopLIntrp,
+	(mixFunc)mixFloatBidiLoopLIntrp,
+	(mixFunc)mixFloatNoLoopS32CompactIntrp,
+	(mixFunc)mixFloatLoopS32CompactIntrp,
+	(mixFunc)mixFloatBidiLoopS32CompactIntrp,
+	(mixFunc)mixFloatNoLoopCIntrp,
+	(mixFunc)mixFloatLoopCIntrp,
+	(mixFunc)mixFloatBidiLoopCIntrp,
+
+	// volume ramping
+
+	// 8-bit
+	(mixFunc)mix8bRampNoLoop,
+	(mixFunc)mix8bRampLoop,
+	(mixFunc)mix8bRampBidiLoop,
+	(mixFunc)mix8bRampNoLoopS8CompactIntrp,
+	(mixFunc)mix8bRampLoopS8CompactIntrp,
+	(mixFunc)mix8bRampBidiLoopS8CompactIntrp,
+	(mixFunc)mix8bRampNoLoopLIntrp,
+	(mixFunc)mix8bRampLoopLIntrp,
+	(mixFunc)mix8bRampBidiLoopLIntrp,
+	(mixFunc)mix8bRampNoLoopS32CompactIntrp,
+	(mixFunc)mix8bRampLoopS32CompactIntrp,
+	(mixFunc)mix8bRampBidiLoopS32CompactIntrp,
+	(mixFunc)mix8bRampNoLoopCIntrp,
+	(mixFunc)mix8bRampLoopCIntrp,
+	(mixFunc)mix8bRampBidiLoopCIntrp,
+
+	// 16-bit
+	(mixFunc)mix16bRampNoLoop,
+	(mixFunc)mix16bRampLoop,
+	(mixFunc)mix16bRampBidiLoop,
+	(mixFunc)mix16bRampNoLoopS8CompactIntrp,
+	(mixFunc)mix16bRampLoopS8CompactIntrp,
+	(mixFunc)mix16bRampBidiLoopS8CompactIntrp,
+	(mixFunc)mix16bRampNoLoopLIntrp,
+	(mixFunc)mix16bRampLoopLIntrp,
+	(mixFunc)mix16bRampBidiLoopLIntrp,
+	(mixFunc)mix16bRampNoLoopS32CompactIntrp,
+	(mixFunc)mix16bRampLoopS32CompactIntrp,
+	(mixFunc)mix16bRampBidiLoopS32CompactIntrp,
 	(mixFunc)mix16bRampNoLoopCIntrp,
 	(mixFunc)mix16bRampLoopCIntrp,
-	(mixFunc)mix16bRampBidiLoopCIntrp
+	(mixFunc)mix16bRampBidiLoopCIntrp,
+
+	// float (sample cache)
+	(mixFunc)mixFloatRampNoLoop,
+	(mixFunc)mixFloatRampLoop,
+	(mixFunc)mixFloatRampBidiLoop,
+	(mixFunc)mixFloatRampNoLoopS8CompactIntrp,
+	(mixFunc)mixFloatRampLoopS8CompactIntrp,
+	(mixFunc)mixFloatRampBidiLoopS8CompactIntrp,
+	(mixFunc)mixFloatRampNoLoopLIntrp,
+	(mixFunc)mixFloatRampLoopLIntrp,
+	(mixFunc)mixFloatRampBidiLoopLIntrp,
+	(mixFunc)mixFloatRampNoLoopS32CompactIntrp,
+	(mixFunc)mixFloatRampLoopS32CompactIntrp,
+	(mixFunc)mixFloatRampBidiLoopS32CompactIntrp,
+	(mixFunc)mixFloatRampNoLoopCIntrp,
+	(mixFunc)mixFloatRampLoopCIntrp,
+	(mixFunc)mixFloatRampBidiLoopCIntrp
 };
@@ -43,6 +43,10 @@
 	const int16_t *loopStartPtr = &v->base16[v->loopStart]; \
 	const int16_t *leftEdgePtr = loopStartPtr+MAX_LEFT_TAPS;
 
+#define PREPARE_TAP_FIXF \
+	const float *loopStartPtr = &v->fBase[v->loopStart]; \
+	const float *leftEdgePtr = loopStartPtr+MAX_LEFT_TAPS;
+
 #define SET_BASE8 \
 	base = v->base8; \
 	smpPtr = base + position;
@@ -51,6 +55,10 @@
 	base = v->base16; \
 	smpPtr = base + position;
 
+#define SET_BASEF \
+	base = v->fBase; \
+	smpPtr = base + position;
+
 #define SET_BASE8_BIDI \
 	base = v->base8; \
 	revBase = v->revBase8;
@@ -59,6 +67,10 @@
 	base = v->base16; \
 	revBase = v->revBase16;
 
+#define SET_BASEF_BIDI \
+	base = v->fBase; \
+	revBase = v->fRevBase;
+
 #define INC_POS \
 	positionFrac += delta; \
 	smpPtr += positionFrac >> MIXER_FRAC_BITS; \
@@ -92,6 +104,13 @@
 	*fMixBufferL++ += fSample * fVolumeL; \
 	*fMixBufferR++ += fSample * fVolumeR;
 
+// float sample data (pre-converted and pre-scaled, see ft2_sample_ed.c:fixSample())
+
+#define RENDER_FLOAT_SMP \
+	fSample = *smpPtr; \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
 /* ----------------------------------------------------------------------- */
 /*                          LINEAR INTERPOLATION                           */
 /* ----------------------------------------------------------------------- */
@@ -117,6 +136,11 @@
 	*fMixBufferL++ += fSample * fVolumeL; \
 	*fMixBufferR++ += fSample * fVolumeR;
 
+#define RENDER_FLOAT_SMP_LINTRP \
+	LINEAR_INTERPOLATION(smpPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
 /* ----------------------------------------------------------------------- */
 /*                       CUBIC SPLINE INTERPOLATION                        */
 /* ----------------------------------------------------------------------- */
@@ -149,6 +173,11 @@
 	*fMixBufferL++ += fSample * fVolumeL; \
 	*fMixBufferR++ += fSample * fVolumeR;
 
+#define RENDER_FLOAT_SMP_CINTRP \
+	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
 
 /* Special left-edge case mixers to get proper tap data after one loop cycle.
 ** These are only used on looped samples.
@@ -166,6 +195,12 @@
 	*fMixBufferL++ += fSample * fVolumeL; \
 	*fMixBufferR++ += fSample * fVolumeR;
 
+#define RENDER_FLOAT_SMP_CINTRP_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (float *)&v->fLeftEdgeTaps[(int32_t)(smpPtr-loopStartPtr)] : (float *)smpPtr; \
+	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
 /* ----------------------------------------------------------------------- */
 /*                       WINDOWED-SINC INTERPOLATION                       */
 /* ----------------------------------------------------------------------- */
@@ -249,6 +284,16 @@
 	*fMixBufferL++ += fSample * fVolumeL; \
 	*fMixBufferR++ += fSample * fVolumeR;
 
+#define RENDER_FLOAT_SMP_S8INTRP \
+	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_FLOAT_SMP_S32INTRP \
+	WINDOWED_SINC32_INTERPOLATION(smpPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
 /* Special left-edge case mixers to get proper tap data after one loop cycle.
 ** These are only used on looped samples.
 */
@@ -277,6 +322,153 @@
 	*fMixBufferL++ += fSample * fVolumeL; \
 	*fMixBufferR++ += fSample * fVolumeR;
 
+#define RENDER_FLOAT_SMP_S8INTRP_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (float *)&v->fLeftEdgeTaps[(int32_t)(smpPtr-loopStartPtr)] : (float *)smpPtr; \
+	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_FLOAT_SMP_S32INTRP_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (float *)&v->fLeftEdgeTaps[(int32_t)(smpPtr-loopStartPtr)] : (float *)smpPtr; \
+	WINDOWED_SINC32_INTERPOLATION(smpTapPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+/* ----------------------------------------------------------------------- */
+/*                  COMPACT WINDOWED-SINC INTERPOLATION                    */
+/* ----------------------------------------------------------------------- */
+
+// through LUTs: mixer/ft2_windowed_sinc.c (compact layout)
+
+/* Same as the windowed-sinc interpolation above, but the LUT has fewer phases, and the
+** coefficients are linearly interpolated between the current and the next phase.
+** Every LUT row holds the coefficients followed by the deltas to the next phase.
+*/
+
+#define WINDOWED_SINC8_COMPACT_INTERPOLATION(s, f, scale) \
+{ \
+	const float *t = v->fSincLUT + (((uint32_t)(f) >> SINC8_COMPACT_FSHIFT) & SINC8_COMPACT_FMASK); \
+	const int32_t phaseFrac = ((uint32_t)(f) << SINC_COMPACT_PHASES_BITS) >> 1; /* uint32 -> int32 range, faster int->float conv. (x86/x86_64) */ \
+	const float fPhaseFrac = phaseFrac * (1.0f / (MIXER_FRAC_SCALE/2)); /* 0.0f .. 0.9999999f */ \
+	fSample = ((s[-3] * (t[0] + (t[8] * fPhaseFrac))) + \
+	           (s[-2] * (t[1] + (t[9] * fPhaseFrac))) + \
+	           (s[-1] * (t[2] + (t[10] * fPhaseFrac))) + \
+	           ( s[0] * (t[3] + (t[11] * fPhaseFrac))) + \
+	           ( s[1] * (t[4] + (t[12] * fPhaseFrac))) + \
+	           ( s[2] * (t[5] + (t[13] * fPhaseFrac))) + \
+	           ( s[3] * (t[6] + (t[14] * fPhaseFrac))) + \
+	           ( s[4] * (t[7] + (t[15] * fPhaseFrac)))) * (1.0f / scale); \
+}
+
+#define WINDOWED_SINC32_COMPACT_INTERPOLATION(s, f, scale) \
+{ \
+	const float *t = v->fSincLUT + (((uint32_t)(f) >> SINC32_COMPACT_FSHIFT) & SINC32_COMPACT_FMASK); \
+	const int32_t phaseFrac = ((uint32_t)(f) << SINC_COMPACT_PHASES_BITS) >> 1; /* uint32 -> int32 range, faster int->float conv. (x86/x86_64) */ \
+	const float fPhaseFrac = phaseFrac * (1.0f / (MIXER_FRAC_SCALE/2)); /* 0.0f .. 0.9999999f */ \
+	fSample = ((s[-15] * (t[0] + (t[32] * fPhaseFrac))) + \
+	           (s[-14] * (t[1] + (t[33] * fPhaseFrac))) + \
+	           (s[-13] * (t[2] + (t[34] * fPhaseFrac))) + \
+	           (s[-12] * (t[3] + (t[35] * fPhaseFrac))) + \
+	           (s[-11] * (t[4] + (t[36] * fPhaseFrac))) + \
+	           (s[-10] * (t[5] + (t[37] * fPhaseFrac))) + \
+	           ( s[-9] * (t[6] + (t[38] * fPhaseFrac))) + \
+	           ( s[-8] * (t[7] + (t[39] * fPhaseFrac))) + \
+	           ( s[-7] * (t[8] + (t[40] * fPhaseFrac))) + \
+	           ( s[-6] * (t[9] + (t[41] * fPhaseFrac))) + \
+	           ( s[-5] * (t[10] + (t[42] * fPhaseFrac))) + \
+	           ( s[-4] * (t[11] + (t[43] * fPhaseFrac))) + \
+	           ( s[-3] * (t[12] + (t[44] * fPhaseFrac))) + \
+	           ( s[-2] * (t[13] + (t[45] * fPhaseFrac))) + \
+	           ( s[-1] * (t[14] + (t[46] * fPhaseFrac))) + \
+	           (  s[0] * (t[15] + (t[47] * fPhaseFrac))) + \
+	           (  s[1] * (t[16] + (t[48] * fPhaseFrac))) + \
+	           (  s[2] * (t[17] + (t[49] * fPhaseFrac))) + \
+	           (  s[3] * (t[18] + (t[50] * fPhaseFrac))) + \
+	           (  s[4] * (t[19] + (t[51] * fPhaseFrac))) + \
+	           (  s[5] * (t[20] + (t[52] * fPhaseFrac))) + \
+	           (  s[6] * (t[21] + (t[53] * fPhaseFrac))) + \
+	           (  s[7] * (t[22] + (t[54] * fPhaseFrac))) + \
+	           (  s[8] * (t[23] + (t[55] * fPhaseFrac))) + \
+	           (  s[9] * (t[24] + (t[56] * fPhaseFrac))) + \
+	           ( s[10] * (t[25] + (t[57] * fPhaseFrac))) + \
+	           ( s[11] * (t[26] + (t[58] * fPhaseFrac))) + \
+	           ( s[12] * (t[27] + (t[59] * fPhaseFrac))) + \
+	           ( s[13] * (t[28] + (t[60] * fPhaseFrac))) + \
+	           ( s[14] * (t[29] + (t[61] * fPhaseFrac))) + \
+	           ( s[15] * (t[30] + (t[62] * fPhaseFrac))) + \
+	           ( s[16] * (t[31] + (t[63] * fPhaseFrac)))) * (1.0f / scale); \
+}
+
+#define RENDER_8BIT_SMP_S8INTRP_COMPACT \
+	WINDOWED_SINC8_COMPACT_INTERPOLATION(smpPtr, positionFrac, 128) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_8BIT_SMP_S32INTRP_COMPACT \
+	WINDOWED_SINC32_COMPACT_INTERPOLATION(smpPtr, positionFrac, 128) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_16BIT_SMP_S8INTRP_COMPACT \
+	WINDOWED_SINC8_COMPACT_INTERPOLATION(smpPtr, positionFrac, 32768) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_16BIT_SMP_S32INTRP_COMPACT \
+	WINDOWED_SINC32_COMPACT_INTERPOLATION(smpPtr, positionFrac, 32768) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_FLOAT_SMP_S8INTRP_COMPACT \
+	WINDOWED_SINC8_COMPACT_INTERPOLATION(smpPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_FLOAT_SMP_S32INTRP_COMPACT \
+	WINDOWED_SINC32_COMPACT_INTERPOLATION(smpPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+/* Special left-edge case mixers to get proper tap data after one loop cycle.
+** These are only used on looped samples.
+*/
+
+#define RENDER_8BIT_SMP_S8INTRP_COMPACT_TAP_FIX  \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
+	WINDOWED_SINC8_COMPACT_INTERPOLATION(smpTapPtr, positionFrac, 128) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_16BIT_SMP_S8INTRP_COMPACT_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
+	WINDOWED_SINC8_COMPACT_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_8BIT_SMP_S32INTRP_COMPACT_TAP_FIX  \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
+	WINDOWED_SINC32_COMPACT_INTERPOLATION(smpTapPtr, positionFrac, 128) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_16BIT_SMP_S32INTRP_COMPACT_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
+	WINDOWED_SINC32_COMPACT_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_FLOAT_SMP_S8INTRP_COMPACT_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (float *)&v->fLeftEdgeTaps[(int32_t)(smpPtr-loopStartPtr)] : (float *)smpPtr; \
+	WINDOWED_SINC8_COMPACT_INTERPOLATION(smpTapPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
+#define RENDER_FLOAT_SMP_S32INTRP_COMPACT_TAP_FIX \
+	smpTapPtr = (smpPtr <= leftEdgePtr) ? (float *)&v->fLeftEdgeTaps[(int32_t)(smpPtr-loopStartPtr)] : (float *)smpPtr; \
+	WINDOWED_SINC32_COMPACT_INTERPOLATION(smpTapPtr, positionFrac, 1) \
+	*fMixBufferL++ += fSample * fVolumeL; \
+	*fMixBufferR++ += fSample * fVolumeR;
+
 /* ----------------------------------------------------------------------- */
 /*                      SAMPLES-TO-MIX LIMITING MACROS                     */
 /* ----------------------------------------------------------------------- */
@@ -18,6 +18,8 @@ float *fKaiserSinc_32 = NULL, *fDownSample1_32 = NULL, *fDownSample2_32 = NULL;
 // set based on selected sinc interpolator (8 point or 32 point)
 float *fKaiserSinc = NULL, *fDownSample1 = NULL, *fDownSample2 = NULL;
 
+bool sincTablesCompact = false;
+
 // zeroth-order modified Bessel function of the first kind (series approximation)
 static double besselI0(double z)
 {
@@ -63,6 +65,52 @@ static void getSinc(uint32_t numTaps, float *fLUTPtr, const double beta, const d
 	}
 }
 
+/* Compact layout: SINC_COMPACT_PHASES phases, where each phase row holds numTaps coefficients
+** followed by numTaps deltas to the next phase (for linear interpolation between phases).
+** The tap order and window are the same as in getSinc().
+*/
+static void getSincCompact(uint32_t numTaps, float *fLUTPtr, const double beta, const double cutoff)
+{
+	const double I0Beta = besselI0(beta);
+	const double kPi = MY_PI * cutoff;
+
+	const double xMul = 1.0 / ((numTaps / 2) * (numTaps / 2));
+	const int32_t midTap = (numTaps / 2) * SINC_COMPACT_PHASES;
+
+	for (uint32_t phase = 0; phase < SINC_COMPACT_PHASES; phase++)
+	{
+		for (uint32_t tap = 0; tap < numTaps; tap++)
+		{
+			double dSinc[2];
+			for (uint32_t j = 0; j < 2; j++)
+			{
+				const int32_t ix = ((numTaps - 1 - tap) * SINC_COMPACT_PHASES) + phase + j;
+
+				dSinc[j] = 1.0;
+				if (ix != midTap)
+				{
+					const double x = (ix - midTap) * (1.0 / SINC_COMPACT_PHASES);
+					const double xPi = x * kPi;
+
+					double dWindow = 1.0 - (x * x * xMul);
+					if (dWindow < 0.0) // can't happen, but let's be safe
+						dWindow = 0.0;
+
+					// sinc with Kaiser window
+					dSinc[j] = (sin(xPi) * besselI0(beta * sqrt(dWindow))) / (I0Beta * xPi);
+				}
+
+				dSinc[j] *= cutoff;
+			}
+
+			fLUTPtr[tap] = (float)dSinc[0];
+			fLUTPtr[numTaps+tap] = (float)(dSinc[1] - dSinc[0]);
+		}
+
+		fLUTPtr += numTaps * 2;
+	}
+}
+
 static double dBToKaiserBeta(double dB)
 {
 	if (dB < 21.0)
@@ -73,15 +121,18 @@ static double dBToKaiserBeta(double dB)
 		return 0.1102 * (dB - 8.7);
 }
 
-bool calcWindowedSincTables(void)
+bool calcWindowedSincTables(bool compact)
 {
-	fKaiserSinc_8  = (float *)malloc(SINC1_TAPS*SINC_PHASES * sizeof (float));
-	fDownSample1_8 = (float *)malloc(SINC1_TAPS*SINC_PHASES * sizeof (float));
-	fDownSample2_8 = (float *)malloc(SINC1_TAPS*SINC_PHASES * sizeof (float));
+	const uint32_t length8  = compact ? (SINC1_TAPS*2*SINC_COMPACT_PHASES) : (SINC1_TAPS*SINC_PHASES);
+	const uint32_t length32 = compact ? (SINC2_TAPS*2*SINC_COMPACT_PHASES) : (SINC2_TAPS*SINC_PHASES);
+
+	fKaiserSinc_8  = (float *)malloc(length8 * sizeof (float));
+	fDownSample1_8 = (float *)malloc(length8 * sizeof (float));
+	fDownSample2_8 = (float *)malloc(length8 * sizeof (float));
 
-	fKaiserSinc_32  = (float *)malloc(SINC2_TAPS*SINC_PHASES * sizeof (float));
-	fDownSample1_32 = (float *)malloc(SINC2_TAPS*SINC_PHASES * sizeof (float));
-	fDownSample2_32 = (float *)malloc(SINC2_TAPS*SINC_PHASES * sizeof (float));
+	fKaiserSinc_32  = (float *)malloc(length32 * sizeof (float));
+	fDownSample1_32 = (float *)malloc(length32 * sizeof (float));
+	fDownSample2_32 = (float *)malloc(length32 * sizeof (float));
 
 	if (fKaiserSinc_8  == NULL || fDownSample1_8  == NULL || fDownSample2_8  == NULL ||
 		fKaiserSinc_32 == NULL || fDownSample1_32 == NULL || fDownSample2_32 == NULL)
@@ -90,15 +141,19 @@ bool calcWindowedSincTables(void)
 		return false;
 	}
 
+	sincTablesCompact = compact;
+
+	void (*calcSinc)(uint32_t, float *, const double, const double) = compact ? getSincCompact : getSinc;
+
 	// 8 point (modelled after OpenMPT)
-	getSinc(SINC1_TAPS, fKaiserSinc_8,  dBToKaiserBeta(96.15645), 1.000);
-	getSinc(SINC1_TAPS, fDownSample1_8, dBToKaiserBeta(85.83249), 0.500);
-	getSinc(SINC1_TAPS, fDownSample2_8, dBToKaiserBeta(72.22088), 0.425);
+	calcSinc(SINC1_TAPS, fKaiserSinc_8,  dBToKaiserBeta(96.15645), 1.000);
+	calcSinc(SINC1_TAPS, fDownSample1_8, dBToKaiserBeta(85.83249), 0.500);
+	calcSinc(SINC1_TAPS, fDownSample2_8, dBToKaiserBeta(72.22088), 0.425);
 
 	// 32 point
-	getSinc(SINC2_TAPS, fKaiserSinc_32,  dBToKaiserBeta(96.0), 1.000);
-	getSinc(SINC2_TAPS, fDownSample1_32, dBToKaiserBeta(86.0), 0.500);
-	getSinc(SINC2_TAPS, fDownSample2_32, dBToKaiserBeta(74.0), 0.425);
+	calcSinc(SINC2_TAPS, fKaiserSinc_32,  dBToKaiserBeta(96.0), 1.000);
+	calcSinc(SINC2_TAPS, fDownSample1_32, dBToKaiserBeta(86.0), 0.500);
+	calcSinc(SINC2_TAPS, fDownSample2_32, dBToKaiserBeta(74.0), 0.425);
 
 	return true;
 }
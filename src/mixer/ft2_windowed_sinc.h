@@ -8,6 +8,14 @@
 #define SINC_PHASES 8192
 #define SINC_PHASES_BITS 13 // log2(SINC_PHASES)
 
+/* Compact table layout (selected at startup with the "--compact-sinc" switch).
+** Fewer phases, with linear interpolation between two adjacent phases. Every phase row
+** holds the tap coefficients followed by the deltas to the next phase, so that the whole
+** 32-point table set fits in a typical L2 cache (192kB instead of 3MB).
+*/
+#define SINC_COMPACT_PHASES 256
+#define SINC_COMPACT_PHASES_BITS 8 // log2(SINC_COMPACT_PHASES)
+
 // do not change these!
 
 #define SINC1_TAPS 8
@@ -20,10 +28,18 @@
 #define SINC32_FSHIFT (MIXER_FRAC_BITS-(SINC_PHASES_BITS+SINC32_WIDTH_BITS))
 #define SINC32_FMASK ((SINC2_TAPS*SINC_PHASES)-SINC2_TAPS)
 
+#define SINC8_COMPACT_FSHIFT (MIXER_FRAC_BITS-(SINC_COMPACT_PHASES_BITS+SINC8_WIDTH_BITS+1))
+#define SINC8_COMPACT_FMASK ((SINC1_TAPS*2*SINC_COMPACT_PHASES)-(SINC1_TAPS*2))
+
+#define SINC32_COMPACT_FSHIFT (MIXER_FRAC_BITS-(SINC_COMPACT_PHASES_BITS+SINC32_WIDTH_BITS+1))
+#define SINC32_COMPACT_FMASK ((SINC2_TAPS*2*SINC_COMPACT_PHASES)-(SINC2_TAPS*2))
+
 extern float *fKaiserSinc_8, *fDownSample1_8, *fDownSample2_8;
 extern float *fKaiserSinc_32, *fDownSample1_32, *fDownSample2_32;
 
 extern float *fKaiserSinc, *fDownSample1, *fDownSample2;
 
-bool calcWindowedSincTables(void);
+extern bool sincTablesCompact;
+
+bool calcWindowedSincTables(bool compact);
 void freeWindowedSincTables(void);
@@ -27,7 +27,7 @@ enum // supported 31-sample .MOD types
 
 static uint8_t getModType(uint8_t *numChannels, const char *id);
 
-bool loadMOD(FILE *f, uint32_t filesize)
+bool loadMOD(MEMFILE *f, uint32_t filesize)
 {
 	uint8_t bytes[4], modFormat, numChannels;
 	int16_t i, j, k;
@@ -44,7 +44,7 @@ bool loadMOD(FILE *f, uint32_t filesize)
 	}
 
 	memset(&hdr, 0, sizeof (hdr));
-	if (fread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
+	if (mread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -117,7 +117,7 @@ bool loadMOD(FILE *f, uint32_t filesize)
 				for (k = 0; k < songTmp.numChannels; k++)
 				{
 					note_t *p = &patternTmp[a][(j * MAX_CHANNELS) + k];
-					fread(bytes, 1, 4, f);
+					mread(bytes, 1, 4, f);
 
 					// period to note
 					uint16_t period = ((bytes[0] & 0x0F) << 8) | bytes[1];
@@ -138,7 +138,7 @@ bool loadMOD(FILE *f, uint32_t filesize)
 				if (tooManyChannels)
 				{
 					int32_t remainingChans = numChannels-songTmp.numChannels;
-					fseek(f, remainingChans*4, SEEK_CUR);
+					mseek(f, remainingChans*4, SEEK_CUR);
 				}
 			}
 
@@ -175,7 +175,7 @@ bool loadMOD(FILE *f, uint32_t filesize)
 				for (k = 0; k < 4; k++)
 				{
 					note_t *p = &patternTmp[pattNum][(j * MAX_CHANNELS) + (k+chnOffset)];
-					fread(bytes, 1, 4, f);
+					mread(bytes, 1, 4, f);
 
 					// period to note
 					uint16_t period = ((bytes[0] & 0x0F) << 8) | bytes[1];
@@ -344,7 +344,7 @@ bool loadMOD(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		int32_t bytesRead = (int32_t)fread(s->dataPtr, 1, s->length, f);
+		int32_t bytesRead = (int32_t)mread(s->dataPtr, 1, s->length, f);
 		if (bytesRead < s->length)
 		{
 			int32_t bytesToClear = s->length - bytesRead;
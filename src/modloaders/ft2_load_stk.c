@@ -31,7 +31,7 @@ stkHdr_t;
 #pragma pack(pop)
 #endif
 
-bool loadSTK(FILE *f, uint32_t filesize)
+bool loadSTK(MEMFILE *f, uint32_t filesize)
 {
 	uint8_t bytes[4];
 	int16_t i, j, k;
@@ -51,7 +51,7 @@ bool loadSTK(FILE *f, uint32_t filesize)
 	}
 
 	memset(&h, 0, sizeof (stkHdr_t));
-	if (fread(&h, 1, sizeof (h), f) != sizeof (h))
+	if (mread(&h, 1, sizeof (h), f) != sizeof (h))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -128,7 +128,7 @@ bool loadSTK(FILE *f, uint32_t filesize)
 			{
 				note_t *p = &patternTmp[a][(j * MAX_CHANNELS) + k];
 
-				if (fread(bytes, 1, 4, f) != 4)
+				if (mread(bytes, 1, 4, f) != 4)
 				{
 					loaderMsgBox("Error: This file is either not a module, or is not supported.");
 					return false;
@@ -331,7 +331,7 @@ bool loadSTK(FILE *f, uint32_t filesize)
 		if (s->loopStart > 0 && s->loopLength < s->length)
 		{
 			s->length -= s->loopStart;
-			fseek(f, s->loopStart, SEEK_CUR);
+			mseek(f, s->loopStart, SEEK_CUR);
 			s->loopStart = 0;
 		}
 
@@ -341,7 +341,7 @@ bool loadSTK(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		int32_t bytesRead = (int32_t)fread(s->dataPtr, 1, s->length, f);
+		int32_t bytesRead = (int32_t)mread(s->dataPtr, 1, s->length, f);
 		if (bytesRead < s->length)
 		{
 			int32_t bytesToClear = s->length - bytesRead;
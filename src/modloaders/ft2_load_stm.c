@@ -54,7 +54,7 @@ static uint8_t pattBuff[64*4*4];
 
 static uint16_t stmTempoToBPM(uint8_t tempo);
 
-bool loadSTM(FILE *f, uint32_t filesize)
+bool loadSTM(MEMFILE *f, uint32_t filesize)
 {
 	int16_t i, j, k;
 	stmHdr_t hdr;
@@ -67,7 +67,7 @@ bool loadSTM(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	if (fread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
+	if (mread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -110,7 +110,7 @@ bool loadSTM(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(pattBuff, 64 * 4 * 4, 1, f) != 1)
+		if (mread(pattBuff, 64 * 4 * 4, 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading!");
 			return false;
@@ -227,7 +227,7 @@ bool loadSTM(FILE *f, uint32_t filesize)
 				s->loopLength = 0;
 			}
 
-			if (fread(s->dataPtr, s->length, 1, f) != 1)
+			if (mread(s->dataPtr, s->length, 1, f) != 1)
 			{
 				loaderMsgBox("General I/O error during loading! Possibly corrupt module?");
 				return false;
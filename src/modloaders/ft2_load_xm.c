@@ -21,14 +21,17 @@ static uint8_t packedPattData[65536];
 */
 static uint32_t extraSampleLengths[32-MAX_SMP_PER_INST];
 
-static bool loadInstrHeader(FILE *f, uint16_t i);
-static bool loadInstrSample(FILE *f, uint16_t i);
+static bool loadInstrHeader(MEMFILE *f, uint16_t i);
+static bool loadInstrSample(MEMFILE *f, uint16_t i);
 static void unpackPatt(uint8_t *dst, uint8_t *src, uint16_t len, int32_t antChn);
-static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion);
+static bool loadPatterns(MEMFILE *f, uint16_t antPtn, uint16_t xmVersion);
 static void unpackPatt(uint8_t *dst, uint8_t *src, uint16_t len, int32_t antChn);
-static void loadADPCMSample(FILE *f, sample_t *s); // ModPlug Tracker
+static void loadADPCMSample(MEMFILE *f, sample_t *s); // ModPlug Tracker
+static bool queueLazySample(MEMFILE *f, uint16_t insNum, uint16_t smpNum, sample_t *s, int32_t lengthInFile);
 
-bool loadXM(FILE *f, uint32_t filesize)
+static bool lazySampleLoading; // huge module, only the positions of the sample data are read
+
+bool loadXM(MEMFILE *f, uint32_t filesize)
 {
 	xmHdr_t h;
 
@@ -38,7 +41,7 @@ bool loadXM(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	if (fread(&h, 1, sizeof (h), f) != sizeof (h))
+	if (mread(&h, 1, sizeof (h), f) != sizeof (h))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -74,13 +77,15 @@ bool loadXM(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	fseek(f, 60 + h.headerSize, SEEK_SET);
-	if (filesize != 336 && feof(f)) // 336 in length at this point = empty XM
+	mseek(f, 60 + h.headerSize, SEEK_SET);
+	if (filesize != 336 && meof(f)) // 336 in length at this point = empty XM
 	{
 		loaderMsgBox("Error loading XM: The module is empty!");
 		return false;
 	}
 
+	lazySampleLoading = (filesize >= LAZY_LOAD_MIN_FILESIZE);
+
 	memcpy(songTmp.name, h.name, 20);
 	songTmp.name[20] = '\0';
 
@@ -188,7 +193,7 @@ bool loadXM(FILE *f, uint32_t filesize)
 	return true;
 }
 
-static bool loadInstrHeader(FILE *f, uint16_t i)
+static bool loadInstrHeader(MEMFILE *f, uint16_t i)
 {
 	uint32_t readSize;
 	xmInsHdr_t ih;
@@ -199,8 +204,8 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 	memset(extraSampleLengths, 0, sizeof (extraSampleLengths));
 	memset(&ih, 0, sizeof (ih));
 
-	fread(&readSize, 4, 1, f);
-	fseek(f, -4, SEEK_CUR);
+	mread(&readSize, 4, 1, f);
+	mseek(f, -4, SEEK_CUR);
 
 	// yes, some XMs can have a header size of 0, and it usually means 263 bytes (INSTR_HEADER_SIZE)
 	if (readSize == 0 || readSize > INSTR_HEADER_SIZE)
@@ -212,11 +217,11 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 		return false;
 	}
 
-	fread(&ih, readSize, 1, f); // read instrument header
+	mread(&ih, readSize, 1, f); // read instrument header
 
 	// FT2 bugfix: skip instrument header data if instrSize is above INSTR_HEADER_SIZE
 	if (ih.instrSize > INSTR_HEADER_SIZE)
-		fseek(f, ih.instrSize-INSTR_HEADER_SIZE, SEEK_CUR);
+		mseek(f, ih.instrSize-INSTR_HEADER_SIZE, SEEK_CUR);
 
 	if (ih.numSamples < 0 || ih.numSamples > 32)
 	{
@@ -267,7 +272,7 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 		if (sampleHeadersToRead > MAX_SMP_PER_INST)
 			sampleHeadersToRead = MAX_SMP_PER_INST;
 
-		if (fread(ih.smp, sampleHeadersToRead * sizeof (xmSmpHdr_t), 1, f) != 1)
+		if (mread(ih.smp, sampleHeadersToRead * sizeof (xmSmpHdr_t), 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading!");
 			return false;
@@ -279,8 +284,8 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 			const int32_t samplesToSkip = ih.numSamples-MAX_SMP_PER_INST;
 			for (int32_t j = 0; j < samplesToSkip; j++)
 			{
-				fread(&extraSampleLengths[j], 4, 1, f); // used for skipping data in loadInstrSample()
-				fseek(f, sizeof (xmSmpHdr_t)-4, SEEK_CUR);
+				mread(&extraSampleLengths[j], 4, 1, f); // used for skipping data in loadInstrSample()
+				mseek(f, sizeof (xmSmpHdr_t)-4, SEEK_CUR);
 			}
 		}
 
@@ -315,7 +320,7 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 	return true;
 }
 
-static bool loadInstrSample(FILE *f, uint16_t i)
+static bool loadInstrSample(MEMFILE *f, uint16_t i)
 {
 	if (instrTmp[i] == NULL)
 		return true; // empty instrument, let's just pretend it got loaded successfully
@@ -331,7 +336,7 @@ static bool loadInstrSample(FILE *f, uint16_t i)
 		for (uint16_t j = 0; j < k; j++, s++)
 		{
 			if (s->length > 0)
-				fseek(f, s->length, SEEK_CUR);
+				mseek(f, s->length, SEEK_CUR);
 		}
 	}
 	else
@@ -363,33 +368,38 @@ static bool loadInstrSample(FILE *f, uint16_t i)
 				if (s->length > MAX_SAMPLE_LEN)
 					s->length = MAX_SAMPLE_LEN;
 
-				if (!allocateSmpData(s, s->length, sample16Bit))
+				if (lazySampleLoading)
+				{
+					if (!queueLazySample(f, i, j, s, lengthInFile))
+					{
+						loaderMsgBox("Not enough memory!");
+						return false;
+					}
+				}
+				else if (!allocateSmpData(s, s->length, sample16Bit))
 				{
 					loaderMsgBox("Not enough memory!");
 					return false;
 				}
-
-				if (adpcmSample)
+				else if (adpcmSample)
 				{
 					loadADPCMSample(f, s);
 				}
 				else
 				{
 					const int32_t sampleLengthInBytes = SAMPLE_LENGTH_BYTES(s);
-					fread(s->dataPtr, 1, sampleLengthInBytes, f);
+					mread(s->dataPtr, 1, sampleLengthInBytes, f);
 
 					if (sampleLengthInBytes < lengthInFile)
-						fseek(f, lengthInFile-sampleLengthInBytes, SEEK_CUR);
+						mseek(f, lengthInFile-sampleLengthInBytes, SEEK_CUR);
 
-					delta2Samp(s->dataPtr, s->length, s->flags);
+					decodeSampleLater(s, SMP_DECODE_DELTA, stereoSample, NULL);
 
-					if (stereoSample) // stereo sample - already downmixed to mono in delta2samp()
+					if (stereoSample) // stereo sample - will be downmixed to mono in delta2Samp()
 					{
 						s->length >>= 1;
 						s->loopStart >>= 1;
 						s->loopLength >>= 1;
-
-						reallocateSmpData(s, s->length, sample16Bit); // dealloc unused memory
 					}
 				}
 			}
@@ -407,14 +417,14 @@ static bool loadInstrSample(FILE *f, uint16_t i)
 		for (i = 0; i < samplesToSkip; i++)
 		{
 			if (extraSampleLengths[i] > 0)
-				fseek(f, extraSampleLengths[i], SEEK_CUR); 
+				mseek(f, extraSampleLengths[i], SEEK_CUR); 
 		}
 	}
 
 	return true;
 }
 
-static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion)
+static bool loadPatterns(MEMFILE *f, uint16_t antPtn, uint16_t xmVersion)
 {
 	uint8_t tmpLen;
 	xmPatHdr_t ph;
@@ -422,39 +432,39 @@ static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion)
 	bool pattLenWarn = false;
 	for (uint16_t i = 0; i < antPtn; i++)
 	{
-		if (fread(&ph.headerSize, 4, 1, f) != 1)
+		if (mread(&ph.headerSize, 4, 1, f) != 1)
 			goto pattCorrupt;
 
-		if (fread(&ph.type, 1, 1, f) != 1)
+		if (mread(&ph.type, 1, 1, f) != 1)
 			goto pattCorrupt;
 
 		ph.numRows = 0;
 		if (xmVersion == 0x0102)
 		{
-			if (fread(&tmpLen, 1, 1, f) != 1)
+			if (mread(&tmpLen, 1, 1, f) != 1)
 				goto pattCorrupt;
 
-			if (fread(&ph.dataSize, 2, 1, f) != 1)
+			if (mread(&ph.dataSize, 2, 1, f) != 1)
 				goto pattCorrupt;
 
 			ph.numRows = tmpLen + 1; // +1 in v1.02
 
 			if (ph.headerSize > 8)
-				fseek(f, ph.headerSize - 8, SEEK_CUR);
+				mseek(f, ph.headerSize - 8, SEEK_CUR);
 		}
 		else
 		{
-			if (fread(&ph.numRows, 2, 1, f) != 1)
+			if (mread(&ph.numRows, 2, 1, f) != 1)
 				goto pattCorrupt;
 
-			if (fread(&ph.dataSize, 2, 1, f) != 1)
+			if (mread(&ph.dataSize, 2, 1, f) != 1)
 				goto pattCorrupt;
 
 			if (ph.headerSize > 9)
-				fseek(f, ph.headerSize - 9, SEEK_CUR);
+				mseek(f, ph.headerSize - 9, SEEK_CUR);
 		}
 
-		if (feof(f))
+		if (meof(f))
 			goto pattCorrupt;
 
 		patternNumRowsTmp[i] = ph.numRows;
@@ -472,7 +482,7 @@ static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion)
 				return false;
 			}
 
-			if (fread(packedPattData, 1, ph.dataSize, f) != ph.dataSize)
+			if (mread(packedPattData, 1, ph.dataSize, f) != ph.dataSize)
 				goto pattCorrupt;
 
 			unpackPatt((uint8_t *)patternTmp[i], packedPattData, patternNumRowsTmp[i], songTmp.numChannels);
@@ -576,23 +586,42 @@ static void unpackPatt(uint8_t *dst, uint8_t *src, uint16_t len, int32_t antChn)
 	}
 }
 
-static void loadADPCMSample(FILE *f, sample_t *s) // ModPlug Tracker
+static void loadADPCMSample(MEMFILE *f, sample_t *s) // ModPlug Tracker
 {
 	int8_t deltaLUT[16];
-	fread(deltaLUT, 1, 16, f);
+	mread(deltaLUT, 1, 16, f);
 
-	int8_t *dataPtr = s->dataPtr;
+	// the packed bytes are decoded later (in place), missing bytes are read as EOF (0xFF) like before
 	const int32_t dataLength = (s->length + 1) / 2;
+	int8_t *packedData = s->dataPtr + dataLength;
+
+	memset(packedData, 0xFF, dataLength);
+	mread(packedData, 1, dataLength, f);
+
+	decodeSampleLater(s, SMP_DECODE_ADPCM, false, deltaLUT);
+}
 
-	int8_t currSample = 0;
-	for (int32_t i = 0; i < dataLength; i++)
+static bool queueLazySample(MEMFILE *f, uint16_t insNum, uint16_t smpNum, sample_t *s, int32_t lengthInFile)
+{
+	if (s->flags & SAMPLE_ADPCM) // ModPlug Tracker, see loadADPCMSample()
 	{
-		const uint8_t nibbles = (uint8_t)fgetc(f);
+		int8_t deltaLUT[16];
+		mread(deltaLUT, 1, 16, f);
 
-		currSample += deltaLUT[nibbles & 0x0F];
-		*dataPtr++ = currSample;
+		const int32_t dataLength = (s->length + 1) / 2;
+		if (!loadSampleLater(insNum, smpNum, s, mtell(f), dataLength, SMP_DECODE_ADPCM, false, deltaLUT))
+			return false;
+
+		mseek(f, dataLength, SEEK_CUR);
+	}
+	else
+	{
+		const bool stereoSample = !!(s->flags & SAMPLE_STEREO);
+		if (!loadSampleLater(insNum, smpNum, s, mtell(f), SAMPLE_LENGTH_BYTES(s), SMP_DECODE_DELTA, stereoSample, NULL))
+			return false;
 
-		currSample += deltaLUT[nibbles >> 4];
-		*dataPtr++ = currSample;
+		mseek(f, lengthInFile, SEEK_CUR);
 	}
+
+	return true;
 }
@@ -0,0 +1,165 @@
+/* Checks that the SSE2 sample kernels (ft2_sample_kernels.c) give bit-exact results with the
+** scalar code, for all lengths up to a few vectors (tails shorter than a vector), unaligned
+** starts, and random/min/max sample values.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../src/ft2_structs.h"
+#include "../src/ft2_sample_kernels.h"
+
+#define MAX_LENGTH 300
+#define MAX_OFFSET 16
+#define BUF_BYTES ((MAX_OFFSET + MAX_LENGTH) * sizeof (int16_t))
+
+enum
+{
+	PATTERN_RANDOM = 0,
+	PATTERN_MIN = 1,
+	PATTERN_MAX = 2,
+	PATTERN_MIN_MAX = 3, // alternating, worst case for the averaging and delta coding
+	PATTERN_NUM
+};
+
+cpu_t cpu; // normally in ft2_structs.c
+
+static uint32_t randSeed = 0x12345678;
+static int32_t numFailed;
+
+static uint8_t getRandomByte(void)
+{
+	randSeed = (randSeed * 1103515245) + 12345;
+	return (uint8_t)(randSeed >> 16);
+}
+
+static void fillBuffer(uint8_t *buf, int32_t smpPattern, bool sample16Bit)
+{
+	for (size_t i = 0; i < BUF_BYTES; i++)
+	{
+		switch (smpPattern)
+		{
+			default:
+			case PATTERN_RANDOM: buf[i] = getRandomByte(); break;
+
+			// the high byte of a 16-bit sample is the second one (little-endian)
+			case PATTERN_MIN: buf[i] = (!sample16Bit || (i & 1)) ? 0x80 : 0x00; break;
+			case PATTERN_MAX: buf[i] = (!sample16Bit || (i & 1)) ? 0x7F : 0xFF; break;
+
+			case PATTERN_MIN_MAX:
+			{
+				const bool isMin = ((sample16Bit ? (i >> 1) : i) & 1) == 0;
+				if (!sample16Bit || (i & 1))
+					buf[i] = isMin ? 0x80 : 0x7F;
+				else
+					buf[i] = isMin ? 0x00 : 0xFF;
+			}
+			break;
+		}
+	}
+}
+
+enum
+{
+	KERNEL_PREFIX_SUM = 0,
+	KERNEL_DELTA_ENCODE = 1,
+	KERNEL_AVERAGE = 2,
+	KERNEL_AVERAGE_XOR = 3,
+	KERNEL_FLIP_SIGN = 4,
+	KERNEL_NUM
+};
+
+static const char *kernelNames[KERNEL_NUM] = { "prefixSum", "deltaEncode", "average", "average (xor)", "flipSign" };
+
+static int32_t runKernel(int32_t kernel, bool sample16Bit, uint8_t *buf, const uint8_t *src, int32_t offset, int32_t length)
+{
+	int32_t result = 0;
+
+	if (sample16Bit)
+	{
+		int16_t *p16 = (int16_t *)buf + offset;
+		const int16_t *src16 = (const int16_t *)src + (MAX_OFFSET - 1 - offset); // differently aligned than p16
+
+		switch (kernel)
+		{
+			default:
+			case KERNEL_PREFIX_SUM: result = prefixSum16(p16, length, (int16_t)(length * 1237)); break;
+			case KERNEL_DELTA_ENCODE: deltaEncode16(p16, length); break;
+			case KERNEL_AVERAGE: average16(p16, src16, length, 0); break;
+			case KERNEL_AVERAGE_XOR: average16(p16, src16, length, (int16_t)0x8000); break;
+			case KERNEL_FLIP_SIGN: flipSign16(p16, length); break;
+		}
+	}
+	else
+	{
+		int8_t *p8 = (int8_t *)buf + offset;
+		const int8_t *src8 = (const int8_t *)src + (MAX_OFFSET - 1 - offset);
+
+		switch (kernel)
+		{
+			default:
+			case KERNEL_PREFIX_SUM: result = prefixSum8(p8, length, (int8_t)(length * 37)); break;
+			case KERNEL_DELTA_ENCODE: deltaEncode8(p8, length); break;
+			case KERNEL_AVERAGE: average8(p8, src8, length, 0); break;
+			case KERNEL_AVERAGE_XOR: average8(p8, src8, length, (int8_t)0x80); break;
+			case KERNEL_FLIP_SIGN: flipSign8(p8, length); break;
+		}
+	}
+
+	return result;
+}
+
+static void testKernel(int32_t kernel, bool sample16Bit)
+{
+	static uint8_t data[BUF_BYTES], src[BUF_BYTES], scalarBuf[BUF_BYTES], sse2Buf[BUF_BYTES];
+
+	for (int32_t smpPattern = 0; smpPattern < PATTERN_NUM; smpPattern++)
+	{
+		for (int32_t offset = 0; offset < MAX_OFFSET; offset++)
+		{
+			for (int32_t length = 0; length <= MAX_LENGTH; length++)
+			{
+				fillBuffer(data, smpPattern, sample16Bit);
+				fillBuffer(src, (smpPattern == PATTERN_RANDOM) ? PATTERN_RANDOM : (PATTERN_NUM-1 - smpPattern), sample16Bit);
+
+				memcpy(scalarBuf, data, BUF_BYTES);
+				memcpy(sse2Buf, data, BUF_BYTES);
+
+				cpu.hasSSE2 = false;
+				const int32_t scalarResult = runKernel(kernel, sample16Bit, scalarBuf, src, offset, length);
+
+				cpu.hasSSE2 = true;
+				const int32_t sse2Result = runKernel(kernel, sample16Bit, sse2Buf, src, offset, length);
+
+				// the whole buffer is compared, so writes outside of the range are caught too
+				if (scalarResult != sse2Result || memcmp(scalarBuf, sse2Buf, BUF_BYTES) != 0)
+				{
+					printf("FAILED: %s%s (pattern %d, offset %d, length %d)\n", kernelNames[kernel],
+						sample16Bit ? "16" : "8", smpPattern, offset, length);
+
+					numFailed++;
+					return;
+				}
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	for (int32_t kernel = 0; kernel < KERNEL_NUM; kernel++)
+	{
+		testKernel(kernel, false);
+		testKernel(kernel, true);
+	}
+
+	if (numFailed > 0)
+	{
+		printf("%d of %d sample kernel tests failed\n", numFailed, KERNEL_NUM*2);
+		return 1;
+	}
+
+	printf("All sample kernel tests passed\n");
+	return 0;
+}